@@ -19,17 +19,23 @@
 #ifndef ALINGED_ALLOCATOR_H
 #define ALINGED_ALLOCATOR_H
 
+#include "core/common/huge_page.h"
 #include "core/common/memalign.h"
 
 
 namespace xrt_core {
 
 // Memory alignment for DDR and AXI-MM trace access
+//
+// Buffers of 2MB or more are backed by huge pages when requested or
+// when Runtime.huge_pages is set, and by regular aligned memory if
+// huge pages are not available.
 template <typename T>
 class AlignedAllocator
 {
   void *mBuffer;
   size_t mCount;
+  xrt_core::huge_page::ptr_type mHugeBuffer;
 public:
   T *getBuffer() {
     return (T *)mBuffer;
@@ -39,13 +45,19 @@ public:
     return mCount * sizeof(T);
   }
 
-  AlignedAllocator(size_t alignment, size_t count) : mBuffer(0), mCount(count) {
+  AlignedAllocator(size_t alignment, size_t count, bool huge_page = false) : mBuffer(0), mCount(count) {
+    if (alignment <= xrt_core::huge_page::min_size && xrt_core::huge_page::use(size(), huge_page))
+      mHugeBuffer = xrt_core::huge_page::alloc(size());
+    if (mHugeBuffer) {
+      mBuffer = mHugeBuffer.get();
+      return;
+    }
     if (xrt_core::posix_memalign(&mBuffer, alignment, count * sizeof(T))) {
       mBuffer = 0;
     }
   }
   ~AlignedAllocator() {
-    if (mBuffer) {
+    if (mBuffer && !mHugeBuffer) {
       xrt_core::detail::aligned_ptr_deleter<void> pDel;
       pDel(mBuffer);
     }
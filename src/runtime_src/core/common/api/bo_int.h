@@ -9,6 +9,11 @@
 #include "core/include/xrt/xrt_bo.h"
 #include "core/common/shim/buffer_handle.h"
 
+namespace xrt_core {
+class device;
+class hwctx_handle;
+}
+
 namespace xrt_core::bo_int {
 
 XRT_CORE_COMMON_EXPORT  
@@ -39,6 +44,17 @@ XRT_CORE_COMMON_EXPORT
 xrt::bo
 create_dtrace_bo(const xrt::hw_context& hwctx, size_t sz);
 
+// finish() - Release cached user pointer registrations
+//
+// Called when a device is closed or a hwctx is destroyed.  Unused
+// registrations of the device or hwctx cached by userptr_cache are
+// unpinned before the shim objects they belong to go away.
+void
+finish(const xrt_core::device* device);
+
+void
+finish(const xrt_core::hwctx_handle* hwctx);
+
 } // bo_int, xrt_core
 
 #endif
@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+#define XRT_CORE_COMMON_SOURCE // in same dll as core_common
+#include "callback_dispatcher.h"
+#include "core/common/config_reader.h"
+#include "core/common/debug.h"
+#include "core/common/error.h"
+#include "core/common/thread.h"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Set in pool threads, used to avoid self deadlock in drain()
+thread_local bool t_pool_thread = false; // NOLINT
+
+// class dispatcher - pool of callback threads
+//
+// @m_ready: callbacks that can be delivered now
+// @m_ordered: keys with a callback in m_ready or being delivered, and
+//  the callbacks posted with the key meanwhile
+// @m_outstanding: posted but not yet delivered callbacks
+//
+// A callback posted with a key that is in m_ordered waits in the
+// key's list until the preceding callback has been delivered.  This
+// way at most one callback per key is delivered at any time, without
+// binding keys to threads.
+class dispatcher
+{
+  using task = std::pair<const void*, std::function<void()>>;
+
+  std::mutex m_mutex;
+  std::condition_variable m_work;
+  std::condition_variable m_idle;
+  std::deque<task> m_ready;
+  std::map<const void*, std::deque<std::function<void()>>> m_ordered;
+  size_t m_outstanding = 0;
+  bool m_ordering;
+  bool m_stop = false;
+  std::vector<std::thread> m_threads;
+
+  void
+  deliver(std::function<void()>& fcn)
+  {
+    try {
+      fcn();
+    }
+    catch (const std::exception& ex) {
+      xrt_core::send_exception_message(std::string("completion callback failed: ") + ex.what());
+    }
+    catch (...) {
+      xrt_core::send_exception_message("completion callback failed");
+    }
+
+    // Release what the callback retains before taking the lock, this
+    // may be the last reference to the command
+    fcn = nullptr;
+  }
+
+  void
+  worker()
+  {
+    t_pool_thread = true;
+    std::unique_lock lk(m_mutex);
+    while (true) {
+      while (!m_stop && m_ready.empty())
+        m_work.wait(lk);
+
+      // Posted callbacks are delivered before the pool is stopped
+      if (m_ready.empty())
+        return;
+
+      auto [key, fcn] = std::move(m_ready.front());
+      m_ready.pop_front();
+      lk.unlock();
+      deliver(fcn);
+      lk.lock();
+
+      // Release next callback with same key, if any
+      if (auto itr = m_ordered.find(key); itr != m_ordered.end()) {
+        if (itr->second.empty()) {
+          m_ordered.erase(itr);
+        }
+        else {
+          m_ready.emplace_back(key, std::move(itr->second.front()));
+          itr->second.pop_front();
+          m_work.notify_one();
+        }
+      }
+
+      if (--m_outstanding == 0)
+        m_idle.notify_all();
+    }
+  }
+
+public:
+  explicit dispatcher(unsigned int threads)
+    : m_ordering(xrt_core::config::get_callback_ordered())
+  {
+    XRT_DEBUGF("callback_dispatcher threads(%d) ordered(%d)\n", threads, m_ordering);
+    for (unsigned int idx = 0; idx < threads; ++idx)
+      m_threads.push_back(xrt_core::thread(&dispatcher::worker, this));
+  }
+
+  ~dispatcher()
+  {
+    {
+      std::lock_guard lk(m_mutex);
+      m_stop = true;
+    }
+    m_work.notify_all();
+    for (auto& t : m_threads)
+      t.join();
+  }
+
+  dispatcher(const dispatcher&) = delete;
+  dispatcher(dispatcher&&) = delete;
+  dispatcher& operator=(const dispatcher&) = delete;
+  dispatcher& operator=(dispatcher&&) = delete;
+
+  void
+  post(const void* key, std::function<void()>&& fcn)
+  {
+    std::unique_lock lk(m_mutex);
+
+    // Pool threads are gone, deliver from caller
+    if (m_stop) {
+      lk.unlock();
+      deliver(fcn);
+      return;
+    }
+
+    ++m_outstanding;
+    if (m_ordering) {
+      if (auto itr = m_ordered.find(key); itr != m_ordered.end()) {
+        itr->second.push_back(std::move(fcn));
+        return;
+      }
+      m_ordered[key];
+    }
+    m_ready.emplace_back(key, std::move(fcn));
+    m_work.notify_one();
+  }
+
+  void
+  drain()
+  {
+    std::unique_lock lk(m_mutex);
+    m_idle.wait(lk, [this] { return m_outstanding == 0; });
+  }
+};
+
+dispatcher&
+get_dispatcher()
+{
+  static dispatcher pool{xrt_core::config::get_callback_threads()};
+  return pool;
+}
+
+} // namespace
+
+namespace xrt_core::callback_dispatcher {
+
+bool
+enabled()
+{
+  static bool value = xrt_core::config::get_callback_threads() > 0;
+  return value;
+}
+
+void
+post(const void* key, std::function<void()>&& fcn)
+{
+  get_dispatcher().post(key, std::move(fcn));
+}
+
+void
+drain()
+{
+  if (!enabled() || t_pool_thread)
+    return;
+
+  get_dispatcher().drain();
+}
+
+} // xrt_core::callback_dispatcher
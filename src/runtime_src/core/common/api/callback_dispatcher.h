@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrt_core_callback_dispatcher_h_
+#define xrt_core_callback_dispatcher_h_
+
+#include <functional>
+
+// This file defines the pool of threads that deliver completion
+// callbacks of managed commands.  It is used by xrt::run.
+//
+// Without the pool, callbacks are called from the command manager
+// monitor thread that harvests command completions, so a slow
+// callback delays completion of every other command on the same
+// hardware queue.  With Runtime.callback_threads > 0, the monitor
+// thread only posts the callbacks to the pool.
+//
+// With Runtime.callback_ordered (default), callbacks posted with the
+// same key are delivered one at a time in the order they were posted,
+// callbacks with different keys are delivered concurrently.
+namespace xrt_core::callback_dispatcher {
+
+// True if callbacks should be posted to the pool rather than called
+// directly
+bool
+enabled();
+
+// Post a callback for delivery by a pool thread
+//
+// @key:  identifies the callbacks that must be ordered, e.g. the command
+// @fcn:  function to call, must retain what it references
+//
+// Exceptions thrown by the function are reported and otherwise
+// ignored.
+void
+post(const void* key, std::function<void()>&& fcn);
+
+// Wait until all posted callbacks have been delivered.  Returns
+// immediately if called from a pool thread.
+void
+drain();
+
+} // xrt_core::callback_dispatcher
+
+#endif
@@ -9,12 +9,10 @@
 #include "core/common/device.h"
 #include "core/common/shim/hwctx_handle.h"
 
-#include <chrono>
 #include <condition_variable>
 #include <map>
 #include <mutex>
-
-using namespace std::chrono_literals;
+#include <string>
 
 namespace xrt_core::context_mgr {
 
@@ -27,6 +25,14 @@ namespace xrt_core::context_mgr {
 // The synchronization ensures that when a thread is in the process of
 // releasing a context, another thread wont call xclOpenContext before
 // the former has closed its context.
+//
+// State is sharded per hardware context so that threads opening CUs
+// in different hardware contexts do not contend.  Within a hardware
+// context, an opened CU context is reference counted and shared by
+// all openers, and the low level open and close calls are made
+// without holding any lock.  A thread that needs a CU that is in the
+// middle of being opened or closed waits on that CU only and is woken
+// when the transition completes.
 class device_context_mgr
 {
   // CU indeces are managed per hwctx
@@ -38,84 +44,191 @@ class device_context_mgr
   struct ctx
   {
     struct ip {
+      enum class state { opening, open, closing };
+
       std::string ipname;
-      cuidx_type ipidx;
+      cuidx_type ipidx {};
+      state st = state::opening;
+      size_t refs = 0;
+
+      // Threads waiting for this ip to complete its transition
+      std::condition_variable cv;
 
-      ip(std::string nm, cuidx_type idx)
-        : ipname(std::move(nm)), ipidx(idx)
+      explicit
+      ip(std::string nm)
+        : ipname(std::move(nm))
       {}
     };
 
+    std::mutex m_mutex;
     std::map<std::string, std::shared_ptr<ip>> m_nm2ip;
     std::map<decltype(cuidx_type::index), std::shared_ptr<ip>> m_idx2ip;
 
-    const ip*
-    get(const std::string& ipname)
-    {
-      return m_nm2ip[ipname].get();
-    }
+    // Threads using this shard, guarded by the manager's mutex
+    size_t users = 0;
 
-    const ip*
-    get(cuidx_type ipidx)
+    // Acquire a reference to named ip.  Returns the ip along with a
+    // flag indicating if the caller must open the low level context.
+    std::pair<std::shared_ptr<ip>, bool>
+    acquire(const std::string& ipname)
     {
-      return m_idx2ip[ipidx.index].get();
+      std::unique_lock<std::mutex> ul(m_mutex);
+      while (true) {
+        auto itr = m_nm2ip.find(ipname);
+        if (itr == m_nm2ip.end()) {
+          auto cu = std::make_shared<ip>(ipname);
+          m_nm2ip.emplace(ipname, cu);
+          return {cu, true};
+        }
+
+        auto cu = itr->second; // keep alive while waiting
+        if (cu->st == ip::state::open) {
+          ++cu->refs;
+          return {cu, false};
+        }
+
+        // Another thread is opening or closing this ip, wait for it
+        // to finish and then re-evaluate.
+        cu->cv.wait(ul);
+      }
     }
 
+    // The low level context was opened
     void
-    add(const std::string& ipname, cuidx_type ipidx)
+    opened(const std::shared_ptr<ip>& cu, cuidx_type ipidx)
     {
-      m_idx2ip[ipidx.index] = m_nm2ip[ipname] = std::make_shared<ip>(ipname, ipidx);
+      std::lock_guard<std::mutex> lk(m_mutex);
+      cu->ipidx = ipidx;
+      cu->st = ip::state::open;
+      cu->refs = 1;
+      m_idx2ip[ipidx.index] = cu;
+      cu->cv.notify_all();
     }
 
+    // The low level context was closed, or failed to open.  Waiters,
+    // if any, will retry the open themselves.
     void
-    erase(cuidx_type ipidx)
+    erase(const std::shared_ptr<ip>& cu)
     {
-      const auto& cu = m_idx2ip.at(ipidx.index);
+      std::lock_guard<std::mutex> lk(m_mutex);
       m_nm2ip.erase(cu->ipname);
-      m_idx2ip.erase(cu->ipidx.index);  // cu local variable dies
+      if (cu->st == ip::state::closing)
+        m_idx2ip.erase(cu->ipidx.index);
+      cu->cv.notify_all();
+    }
+
+    // Release a reference to ip with specified index.  Returns the ip
+    // if this was the last reference and the caller must close the
+    // low level context.
+    std::shared_ptr<ip>
+    release(cuidx_type ipidx)
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      auto itr = m_idx2ip.find(ipidx.index);
+      if (itr == m_idx2ip.end() || itr->second->st != ip::state::open)
+        throw std::runtime_error("ctx " + std::to_string(ipidx.index) + " not open");
+
+      auto cu = itr->second;
+      if (--cu->refs)
+        return nullptr;
+
+      cu->st = ip::state::closing;
+      return cu;
     }
   };
 
   std::mutex m_mutex;
-  std::map<const hwctx_handle*, ctx> m_ctx;
-  std::condition_variable m_cv;
+  std::map<const hwctx_handle*, std::shared_ptr<ctx>> m_ctx;
+
+  // class ctx_use - scoped use of the state for a hardware context
+  //
+  // The state is created on first use.  It is erased when the last
+  // use ends with no CU open or in transition, so that state is not
+  // kept for destroyed hardware contexts and a later hardware context
+  // at the same address starts out empty.
+  class ctx_use
+  {
+    device_context_mgr* m_mgr;
+    const hwctx_handle* m_hdl;
+    std::shared_ptr<ctx> m_ctx;
+
+  public:
+    ctx_use(device_context_mgr* mgr, const hwctx_handle* hwctx_hdl)
+      : m_mgr(mgr), m_hdl(hwctx_hdl)
+    {
+      std::lock_guard<std::mutex> lk(m_mgr->m_mutex);
+      auto& shard = m_mgr->m_ctx[m_hdl];
+      if (!shard)
+        shard = std::make_shared<ctx>();
+      ++shard->users;
+      m_ctx = shard;
+    }
+
+    ~ctx_use()
+    {
+      std::lock_guard<std::mutex> lk(m_mgr->m_mutex);
+      if (--m_ctx->users)
+        return;
+
+      std::lock_guard<std::mutex> slk(m_ctx->m_mutex);
+      if (m_ctx->m_nm2ip.empty())
+        m_mgr->m_ctx.erase(m_hdl);
+    }
+
+    ctx_use(const ctx_use&) = delete;
+    ctx_use& operator=(const ctx_use&) = delete;
+
+    ctx*
+    operator->() const
+    {
+      return m_ctx.get();
+    }
+  };
 
 public:
   // Open context on IP in specified hardware context.
-  // Open the IP context when it is safe to do so.  Note, that usage
-  // of the context manager does not support multiple threads calling
-  // this open() function on the same ip. The intended use-case
-  // (xrt::kernel) prevents this situation.
+  // If the IP is already opened in the hardware context, then the
+  // existing context is shared.  If the IP is in the process of being
+  // opened or closed by another thread, then wait for that to finish.
   cuidx_type
   open(const xrt::hw_context& hwctx, const std::string& ipname)
   {
-    std::unique_lock<std::mutex> ul(m_mutex);
     auto hwctx_hdl = static_cast<hwctx_handle*>(hwctx);
-    auto& ctx = m_ctx[hwctx_hdl];
-    while (ctx.get(ipname)) {
-      if (m_cv.wait_for(ul, 100ms) == std::cv_status::timeout) // NOLINT
-        throw std::runtime_error("aquiring cu context timed out");
-    }
+    ctx_use ctx{this, hwctx_hdl};
+    auto [cu, must_open] = ctx->acquire(ipname);
+    if (!must_open)
+      return cu->ipidx;
 
-    auto ipidx = hwctx_hdl->open_cu_context(ipname);
-    ctx.add(ipname, ipidx);
-    return ipidx;
+    try {
+      auto ipidx = hwctx_hdl->open_cu_context(ipname);
+      ctx->opened(cu, ipidx);
+      return ipidx;
+    }
+    catch (...) {
+      ctx->erase(cu);
+      throw;
+    }
   }
 
-  // Close the cu context and notify threads that might be waiting
-  // to open this cu
+  // Release a reference to the cu context.  The last reference closes
+  // the context and notifies threads that might be waiting to open it.
   void
   close(const xrt::hw_context& hwctx, cuidx_type ipidx)
   {
-    std::lock_guard<std::mutex> lk(m_mutex);
     auto hwctx_hdl = static_cast<hwctx_handle*>(hwctx);
-    auto& ctx = m_ctx[hwctx_hdl];
-    if (!ctx.get(ipidx))
-      throw std::runtime_error("ctx " + std::to_string(ipidx.index) + " not open");
+    ctx_use ctx{this, hwctx_hdl};
+    auto cu = ctx->release(ipidx);
+    if (!cu)
+      return;
 
-    hwctx_hdl->close_cu_context(ipidx);
-    ctx.erase(ipidx);
-    m_cv.notify_all();
+    try {
+      hwctx_hdl->close_cu_context(ipidx);
+    }
+    catch (...) {
+      ctx->erase(cu);
+      throw;
+    }
+    ctx->erase(cu);
   }
 };
 
@@ -36,16 +36,11 @@ create(const xrt_core::device* device);
 // @ipname: name of IP to open
 // @Return: the index of the IP as cuidx_type.
 //
-// The function blocks until the context can be acquired.  If
-// timeout, then the function throws.
-//
-// Note that the context manager is not intended to support two or
-// more threads opening a context on the same compute unit. This
-// situation must be guarded by the client (xrt::kernel) of the
-// manager.
-//
-// The function is simply a synchronization between two threads
-// simultanous use of open_context and close_context.
+// If the IP is already open in the hardware context, then the open
+// context is shared and its reference count incremented.  If another
+// thread is in the process of opening or closing the IP, then the
+// function blocks until that thread is done.  The function throws
+// if the context cannot be opened.
 cuidx_type
 open_context(const xrt::hw_context& hwctx, const std::string& ipname);
 
@@ -54,7 +49,8 @@ open_context(const xrt::hw_context& hwctx, const std::string& ipname);
 // @hwctx:  hardware context that has the CU opened
 // @cuidx:  index of CU
 //
-// The function throws if no context is open on specified CU.
+// The context is closed when the last reference is released.  The
+// function throws if no context is open on specified CU.
 void
 close_context(const xrt::hw_context& hwctx, cuidx_type cuidx);
 
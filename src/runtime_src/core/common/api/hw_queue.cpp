@@ -5,6 +5,7 @@
 #define XRT_API_SOURCE         // in same dll as API sources
 #include "hw_queue.h"
 
+#include "callback_dispatcher.h"
 #include "command.h"
 #include "hw_context_int.h"
 #include "fence_int.h"
@@ -12,6 +13,7 @@
 
 #include "core/common/debug.h"
 #include "core/common/device.h"
+#include "core/common/numa.h"
 #include "core/common/thread.h"
 #include "core/include/xrt/detail/ert.h"
 #include "core/include/xrt_hwqueue.h"
@@ -120,6 +122,7 @@ private:
   std::condition_variable work_cond;
   command_queue_type submitted_cmds;
   bool stop = false;
+  int numa_node = -1;
 
   // thread can be constructed only after data members are initialized
   std::thread monitor_thread;
@@ -235,6 +238,18 @@ public:
   command_manager& operator=(const command_manager&) = delete;
   command_manager& operator=(command_manager&&) = delete;
 
+  // Place monitor thread on the NUMA node of the executor's device.
+  // A recycled manager keeps its placement if the node is unknown.
+  void
+  set_numa_node(int node)
+  {
+    if (node < 0 || node == numa_node)
+      return;
+
+    xrt_core::numa::set_thread_node(monitor_thread, node);
+    numa_node = node;
+  }
+
   void
   clear_executor()
   {
@@ -324,6 +339,7 @@ class hw_queue_impl : public command_manager::executor
 {
   std::unique_ptr<command_manager> m_cmd_manager;
   unsigned int m_uid = 0;
+  int m_numa_node = -1;
 
   // Thread safe on-demand creation of m_cmd_manager
   command_manager*
@@ -339,16 +355,20 @@ class hw_queue_impl : public command_manager::executor
       m_cmd_manager = std::move(s_command_manager_pool.back());
       s_command_manager_pool.pop_back();
       m_cmd_manager->set_executor(this);
+      m_cmd_manager->set_numa_node(m_numa_node);
       return m_cmd_manager.get();
     }
 
     // Construct new manager
     m_cmd_manager = std::make_unique<command_manager>(this);
+    m_cmd_manager->set_numa_node(m_numa_node);
     return m_cmd_manager.get();
   }
 
 public:
-  hw_queue_impl()
+  // @numa_node: host NUMA node of the device, -1 if unknown
+  explicit hw_queue_impl(int numa_node = -1)
+    : m_numa_node(numa_node)
   {
     static unsigned int count = 0;
     m_uid = count++;
@@ -410,6 +430,14 @@ public:
   virtual void
   submit_signal(const xrt::fence& fence) = 0;
 
+  // Check if command dependencies are supported
+  virtual bool
+  has_fence_support() const = 0;
+
+  // Max number of commands in a chained command
+  virtual size_t
+  get_max_chain_size() const = 0;
+
   // Managed start uses command manager for monitoring command
   // completion
   virtual void
@@ -418,6 +446,13 @@ public:
     get_cmd_manager()->launch(cmd);
   }
 
+  // Check if managed start is supported
+  virtual bool
+  has_managed_support() const
+  {
+    return true;
+  }
+
   // Unmanaged start submits command directly for execution
   // Command completion must be explicitly managed by application
   void
@@ -450,6 +485,12 @@ public:
     throw std::runtime_error("Managed execution is not supported for this device");
   }
 
+  bool
+  has_managed_support() const override
+  {
+    return false;
+  }
+
   std::cv_status
   wait(size_t /*timeout_ms*/) override
   {
@@ -531,6 +572,18 @@ public:
   {
     m_qhdl->submit_signal(xrt_core::fence_int::get_fence_handle(fence));
   }
+
+  bool
+  has_fence_support() const override
+  {
+    return m_qhdl->has_fence_support();
+  }
+
+  size_t
+  get_max_chain_size() const override
+  {
+    return m_qhdl->get_max_chain_size();
+  }
 };
 
 // class kds_device - queue implementation for legacy shim support
@@ -658,7 +711,8 @@ class kds_device : public hw_queue_impl
 
 public:
   explicit kds_device(xrt_core::device* device)
-    : m_device(device)
+    : hw_queue_impl(xrt_core::numa::get_device_node(device))
+    , m_device(device)
   {}
 
   std::cv_status
@@ -751,6 +805,18 @@ public:
   {
     throw std::runtime_error("kds_device::submit_wait_on_fence not implemented");
   }
+
+  bool
+  has_fence_support() const override
+  {
+    return false;
+  }
+
+  size_t
+  get_max_chain_size() const override
+  {
+    return 0;
+  }
 };
 
 }  // xrt_core
@@ -902,6 +968,13 @@ unmanaged_start(xrt_core::command* cmd)
   get_handle()->unmanaged_start(cmd);
 }
 
+bool
+hw_queue::
+has_managed_support() const
+{
+  return get_handle()->has_managed_support();
+}
+
 void
 hw_queue::
 submit(xrt_core::buffer_handle* cmd)
@@ -952,6 +1025,20 @@ submit_signal(const xrt::fence& fence)
   get_handle()->submit_signal(fence);
 }
 
+bool
+hw_queue::
+has_fence_support() const
+{
+  return get_handle()->has_fence_support();
+}
+
+size_t
+hw_queue::
+get_max_chain_size() const
+{
+  return get_handle()->get_max_chain_size();
+}
+
 // Wait for command completion for unmanaged command execution with timeout
 std::cv_status
 hw_queue::
@@ -994,6 +1081,7 @@ stop()
   // undefined
   wait_while_devices();   // all devices must be done
   stop_monitor_threads(); // stop all idle threads
+  callback_dispatcher::drain(); // callbacks posted by monitor threads
 
   XRT_DEBUGF("<- xrt_core::kds::stop()\n");
 }
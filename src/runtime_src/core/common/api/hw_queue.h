@@ -53,6 +53,11 @@ public:
   void
   unmanaged_start(xrt_core::command* cmd);
 
+  // True if managed_start() is supported, i.e. if the queue can
+  // monitor commands and notify them when they complete
+  bool
+  has_managed_support() const;
+
   // Submit a raw cmd for execution
   void
   submit(xrt_core::buffer_handle* cmd);
@@ -92,6 +97,14 @@ public:
   void
   submit_signal(const xrt::fence& fence);
 
+  // True if submit_wait() and submit_signal() are supported
+  bool
+  has_fence_support() const;
+
+  // Max number of commands in a chained command, 0 if unknown
+  size_t
+  get_max_chain_size() const;
+
   // Wait for one call to exec_wait to return either from
   // some command completing or from a timeout.
   XRT_CORE_COMMON_EXPORT
@@ -11,6 +11,7 @@
 #include "core/common/config.h"
 #include "core/common/xclbin_parser.h"
 
+#include <chrono>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -68,6 +69,22 @@ XRT_CORE_COMMON_EXPORT
 std::string
 get_project_name(const xrt::xclbin& xclbin);
 
+// struct decode_stat - Time to decode an xclbin section or meta data
+// Sections and meta data are decoded when first used, size is
+// the section size or 0 for meta data derived from sections.
+struct decode_stat
+{
+  std::string name;
+  size_t size;
+  std::chrono::nanoseconds time;
+};
+
+// get_decode_stats() - Sections and meta data decoded so far
+// In order of decode.
+XRT_CORE_COMMON_EXPORT
+std::vector<decode_stat>
+get_decode_stats(const xrt::xclbin& xclbin);
+
 }} // xclbin_int, xrt_core
 
 #endif
@@ -21,9 +21,12 @@
 #include "hw_context_int.h"
 #include "kernel_int.h"
 #include "core/common/api/bo_int.h"
+#include "core/common/config_reader.h"
 #include "core/common/device.h"
+#include "core/common/huge_page.h"
 #include "core/common/memalign.h"
 #include "core/common/message.h"
+#include "core/common/numa.h"
 #include "core/common/query_requests.h"
 #include "core/common/system.h"
 #include "core/common/trace.h"
@@ -33,12 +36,29 @@
 #include "core/common/shim/buffer_handle.h"
 #include "core/common/shim/shared_handle.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstdlib>
+#include <exception>
+#include <functional>
+#include <future>
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#if defined(__x86_64__) || defined(_M_X64)
+# include <emmintrin.h>
+#endif
+
 #ifdef _WIN32
 # pragma warning( disable : 4244 4100 4996 4505 26813)
 #endif
@@ -112,6 +132,201 @@ send_exception_message(const std::string& msg)
   send_exception_message(msg.c_str());
 }
 
+// Copy host memory of a buffer that is synced to device after the
+// copy.  Large copies use non-temporal stores so that the
+// destination, which the host does not read again, does not evict
+// the working set from the cpu caches.
+static void
+stream_copy(char* dst, const char* src, size_t sz)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+  constexpr size_t stream_threshold = 256 * 1024;
+  constexpr size_t vsz = sizeof(__m128i);
+  if (sz >= stream_threshold) {
+    // Align destination for the streaming stores
+    auto head = (vsz - (reinterpret_cast<uintptr_t>(dst) % vsz)) % vsz;
+    std::memcpy(dst, src, head);
+    dst += head; src += head; sz -= head;
+
+    auto vdst = reinterpret_cast<__m128i*>(dst);
+    auto vsrc = reinterpret_cast<const __m128i*>(src);
+    size_t lines = sz / (4 * vsz);
+    for (size_t i = 0; i < lines; ++i, vdst += 4, vsrc += 4) {
+      auto v0 = _mm_loadu_si128(vsrc + 0);
+      auto v1 = _mm_loadu_si128(vsrc + 1);
+      auto v2 = _mm_loadu_si128(vsrc + 2);
+      auto v3 = _mm_loadu_si128(vsrc + 3);
+      _mm_stream_si128(vdst + 0, v0);
+      _mm_stream_si128(vdst + 1, v1);
+      _mm_stream_si128(vdst + 2, v2);
+      _mm_stream_si128(vdst + 3, v3);
+    }
+    _mm_sfence();
+
+    auto done = lines * 4 * vsz;
+    std::memcpy(dst + done, src + done, sz - done);
+    return;
+  }
+#endif
+  std::memcpy(dst, src, sz);
+}
+
+// class host_copy_pipeline - Pipelined copy of buffers through host
+//
+// The copied range is split into chunks that each go through three
+// stages: sync of source from device, copy of host memory, and sync
+// of destination to device.  The source is synced by one thread in
+// chunk order, chunks are copied by a number of threads each taking
+// every n'th chunk, and the destination is synced in chunk order by
+// the thread calling run().  Different chunks are in different stages
+// at the same time, so the total time approaches that of the slowest
+// stage rather than the sum of all three.
+//
+// An error in any stage stops all stages and is rethrown by run().
+class host_copy_pipeline
+{
+public:
+  // Stage function called with offset and size of a chunk relative
+  // to the start of the copied range
+  using stage_fn = std::function<void(size_t, size_t)>;
+
+private:
+  size_t m_size;
+  size_t m_chunk;
+  size_t m_chunks;
+
+  std::mutex m_mutex;
+  std::condition_variable m_work;
+  size_t m_synced = 0;           // source chunks synced so far
+  std::vector<bool> m_copied;    // chunks copied
+  std::exception_ptr m_error;
+
+  size_t
+  chunk_size(size_t idx) const
+  {
+    return std::min(m_chunk, m_size - idx * m_chunk);
+  }
+
+  void
+  fail(std::exception_ptr eptr)
+  {
+    std::lock_guard lk(m_mutex);
+    if (!m_error)
+      m_error = std::move(eptr);
+    m_work.notify_all();
+  }
+
+  void
+  sync_source(const stage_fn& sync_src)
+  {
+    try {
+      for (size_t idx = 0; idx < m_chunks; ++idx) {
+        {
+          std::lock_guard lk(m_mutex);
+          if (m_error)
+            return;
+        }
+        sync_src(idx * m_chunk, chunk_size(idx));
+        std::lock_guard lk(m_mutex);
+        m_synced = idx + 1;
+        m_work.notify_all();
+      }
+    }
+    catch (...) {
+      fail(std::current_exception());
+    }
+  }
+
+  void
+  copy_chunks(const stage_fn& copy, size_t first, size_t stride)
+  {
+    try {
+      for (size_t idx = first; idx < m_chunks; idx += stride) {
+        {
+          std::unique_lock lk(m_mutex);
+          m_work.wait(lk, [this, idx] { return m_error || m_synced > idx; });
+          if (m_error)
+            return;
+        }
+        copy(idx * m_chunk, chunk_size(idx));
+        std::lock_guard lk(m_mutex);
+        m_copied[idx] = true;
+        m_work.notify_all();
+      }
+    }
+    catch (...) {
+      fail(std::current_exception());
+    }
+  }
+
+  void
+  sync_destination(const stage_fn& sync_dst)
+  {
+    try {
+      for (size_t idx = 0; idx < m_chunks; ++idx) {
+        {
+          std::unique_lock lk(m_mutex);
+          m_work.wait(lk, [this, idx] { return m_error || m_copied[idx]; });
+          if (m_error)
+            return;
+        }
+        sync_dst(idx * m_chunk, chunk_size(idx));
+      }
+    }
+    catch (...) {
+      fail(std::current_exception());
+    }
+  }
+
+public:
+  host_copy_pipeline(size_t size, size_t chunk)
+    : m_size(size)
+    , m_chunk(chunk)
+    , m_chunks((size + chunk - 1) / chunk)
+    , m_copied(m_chunks, false)
+  {}
+
+  void
+  run(const stage_fn& sync_src, const stage_fn& copy, const stage_fn& sync_dst, unsigned int threads)
+  {
+    threads = static_cast<unsigned int>(std::min<size_t>(std::max(threads, 1u), m_chunks));
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads + 1);
+    workers.emplace_back([this, &sync_src] { sync_source(sync_src); });
+    for (unsigned int t = 0; t < threads; ++t)
+      workers.emplace_back([this, &copy, t, threads] { copy_chunks(copy, t, threads); });
+
+    sync_destination(sync_dst);
+
+    for (auto& worker : workers)
+      worker.join();
+
+    if (m_error)
+      std::rethrow_exception(m_error);
+  }
+};
+
+inline size_t
+get_copy_chunk_size()
+{
+  static size_t chunk = std::max<size_t>(xrt_core::config::get_bo_copy_chunk_kb(), 4) * 1024;
+  return chunk;
+}
+
+inline unsigned int
+get_copy_threads()
+{
+  static unsigned int threads = [] {
+    if (auto value = xrt_core::config::get_bo_copy_threads())
+      return value;
+    // Leave room for the source and destination sync threads
+    auto cores = std::thread::hardware_concurrency();
+    return std::clamp(cores > 2 ? cores - 2 : 1u, 1u, 4u);
+  }();
+  return threads;
+}
+
 } // namespace
 
 namespace {
@@ -433,13 +648,29 @@ public:
 
     // sync to src to ensure data integrity, logically const
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast) // special case
-    const_cast<bo_impl*>(src)->sync(XCL_BO_SYNC_BO_FROM_DEVICE, sz, src_offset);
-
-    // copy host side buffer
-    std::memcpy(dst_hbuf + dst_offset, src_hbuf + src_offset, sz);
+    auto src_sync = const_cast<bo_impl*>(src);
+
+    // small copies are not worth the threads of a pipeline
+    auto chunk = get_copy_chunk_size();
+    if (sz <= chunk) {
+      src_sync->sync(XCL_BO_SYNC_BO_FROM_DEVICE, sz, src_offset);
+      stream_copy(dst_hbuf + dst_offset, src_hbuf + src_offset, sz);
+      sync(XCL_BO_SYNC_BO_TO_DEVICE, sz, dst_offset);
+      return;
+    }
 
-    // sync modified host buffer to device
-    sync(XCL_BO_SYNC_BO_TO_DEVICE, sz, dst_offset);
+    host_copy_pipeline pipeline{sz, chunk};
+    pipeline.run
+      ([src_sync, src_offset] (size_t off, size_t len) {
+         src_sync->sync(XCL_BO_SYNC_BO_FROM_DEVICE, len, src_offset + off);
+       },
+       [dst_hbuf, src_hbuf, src_offset, dst_offset] (size_t off, size_t len) {
+         stream_copy(dst_hbuf + dst_offset + off, src_hbuf + src_offset + off, len);
+       },
+       [this, dst_offset] (size_t off, size_t len) {
+         sync(XCL_BO_SYNC_BO_TO_DEVICE, len, dst_offset + off);
+       },
+       get_copy_threads());
   }
 
   void
@@ -473,6 +704,25 @@ public:
     m_usage_logger->log_buffer_sync(device->get_device_id(), device.get_hwctx_handle(), sz, dir);
   }
 
+  // Resolve a range of this buffer to the buffer that owns the
+  // device memory and the offset of the range in that buffer
+  virtual std::pair<bo_impl*, size_t>
+  get_sync_target(size_t offset)
+  {
+    return {this, offset};
+  }
+
+  // True if sync() of this buffer is a sync of its shim handle, false
+  // if the buffer implements sync() differently
+  virtual bool
+  has_handle_sync() const
+  {
+    return true;
+  }
+
+  static void
+  sync_batch(const std::vector<xrt::bo::sync_range>& ranges);
+
   virtual uint64_t
   get_address() const
   {
@@ -620,6 +870,30 @@ public:
 // Initialize static data member for async info
 aie::bo::async_handle_impl::handle_map aie::bo::async_handle_impl::async_info;
 
+// class background_handle_impl - Buffer operation run in the background
+//
+// The operation runs on its own thread and must hold references to
+// the buffers it uses for the duration of the operation.  wait()
+// joins the operation and rethrows any error from it, every time it
+// is called.
+class background_handle_impl : public xrt::bo::async_handle_impl
+{
+  std::shared_future<void> m_done;
+
+public:
+  template <typename Operation>
+  background_handle_impl(xrt::bo bo, Operation&& op)
+    : xrt::bo::async_handle_impl(std::move(bo))
+    , m_done(std::async(std::launch::async, std::forward<Operation>(op)))
+  {}
+
+  void
+  wait() override
+  {
+    m_done.get();
+  }
+};
+
 xrt::bo::async_handle
 bo_impl::
 async(xrt::bo& bo, const std::string& port, xclBOSyncDirection dir, size_t sz, size_t offset)
@@ -645,6 +919,73 @@ async(xrt::bo& bo, xclBOSyncDirection dir, size_t sz, size_t offset)
 #endif
 }
 
+// Resolve ranges to the buffers that own the device memory, merge
+// overlapping and adjacent ranges per buffer and direction, and sync
+// the merged ranges with one shim call per device.  Buffers that do
+// not sync through their shim handle are synced one range at a time.
+void
+bo_impl::
+sync_batch(const std::vector<xrt::bo::sync_range>& ranges)
+{
+  struct target_range
+  {
+    bo_impl* bo;
+    xclBOSyncDirection dir;
+    size_t begin;
+    size_t end;
+  };
+
+  std::vector<target_range> targets;
+  targets.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    auto impl = range.buffer.get_handle().get();
+    if (!impl)
+      throw xrt_core::system_error(EINVAL, "empty buffer in sync batch");
+    if (range.size + range.offset > impl->get_size())
+      throw xrt_core::error(-EINVAL, "Invalid offset and size when syncing buffer");
+    auto [bo, offset] = impl->get_sync_target(range.offset);
+    targets.push_back({bo, range.dir, offset, offset + range.size});
+  }
+
+  std::sort(targets.begin(), targets.end(), [](const auto& lhs, const auto& rhs) {
+    return std::tie(lhs.bo, lhs.dir, lhs.begin) < std::tie(rhs.bo, rhs.dir, rhs.begin);
+  });
+
+  std::vector<target_range> merged;
+  for (const auto& target : targets) {
+    if (!merged.empty()) {
+      auto& last = merged.back();
+      if (last.bo == target.bo && last.dir == target.dir && target.begin <= last.end) {
+        last.end = std::max(last.end, target.end);
+        continue;
+      }
+    }
+    merged.push_back(target);
+  }
+
+  std::map<xrt_core::device*, std::vector<xrt_core::buffer_handle::sync_range>> batches;
+  for (const auto& range : merged) {
+    if (!range.bo->has_handle_sync()) {
+      range.bo->sync(range.dir, range.end - range.begin, range.begin);
+      continue;
+    }
+
+    batches[range.bo->get_device().get()].push_back
+      ({range.bo->handle.get(), static_cast<xrt_core::buffer_handle::direction>(range.dir),
+        range.end - range.begin, range.begin});
+  }
+
+  for (const auto& [device, batch] : batches)
+    batch.front().bo->sync_batch(batch);
+
+  for (const auto& range : merged) {
+    if (range.bo->has_handle_sync())
+      range.bo->m_usage_logger->log_buffer_sync
+        (range.bo->device->get_device_id(), range.bo->device.get_hwctx_handle(),
+         range.end - range.begin, range.dir);
+  }
+}
+
 // class buffer_ubuf - User provide host side buffer
 //
 // Provided buffer must be aligned or exception is thrown
@@ -653,7 +994,7 @@ class buffer_ubuf : public bo_impl
   void* ubuf;
 
 public:
-  buffer_ubuf(const device_type& dev, std::unique_ptr<xrt_core::buffer_handle> bhdl, size_t sz, void* buf)
+  buffer_ubuf(const device_type& dev, std::shared_ptr<xrt_core::buffer_handle> bhdl, size_t sz, void* buf)
     : bo_impl(dev, std::move(bhdl), sz)
     , ubuf(buf)
   {}
@@ -687,6 +1028,27 @@ public:
   }
 };
 
+// class buffer_huge - XRT allocated huge page host side buffer
+//
+// Host side buffer in huge page backed virtual memory, used for
+// normal buffers when huge pages are requested.
+class buffer_huge : public bo_impl
+{
+  xrt_core::huge_page::ptr_type hbuf;
+
+public:
+  buffer_huge(const device_type& dev, std::unique_ptr<xrt_core::buffer_handle> bhdl, size_t sz, xrt_core::huge_page::ptr_type&& b)
+    : bo_impl(dev, std::move(bhdl), sz)
+    , hbuf(std::move(b))
+  {}
+
+  void*
+  get_hbuf() const override
+  {
+    return hbuf.get();
+  }
+};
+
 // class buffer_kbuf - Kernel driver host side buffer
 //
 // Kernel driver allocated host side buffer.  The host side buffer
@@ -863,6 +1225,12 @@ public:
     return m_host_only.get_hbuf();
   }
 
+  bool
+  has_handle_sync() const override
+  {
+    return false;
+  }
+
   // sync is M2M copy between host and device bo
   // nodma is guaranteed to have M2M
   void
@@ -947,6 +1315,40 @@ public:
     // sync through parent buffer, which handles nodma case also
     m_parent->sync(dir, sz, off);
   }
+
+  std::pair<bo_impl*, size_t>
+  get_sync_target(size_t offset) override
+  {
+    return m_parent->get_sync_target(offset + m_offset);
+  }
+};
+
+// class buffer_arena - Sub buffer allocated from a bo_arena slab
+//
+// The block of the slab is returned to the arena when the buffer is
+// destroyed.  If the arena itself is gone, then the block is released
+// along with the slab.
+class buffer_arena : public buffer_sub
+{
+  std::weak_ptr<ext::bo_arena_impl> m_arena;
+  std::shared_ptr<bo_impl> m_slab;
+  size_t m_class;
+
+public:
+  buffer_arena(std::weak_ptr<ext::bo_arena_impl> arena, std::shared_ptr<bo_impl> slab,
+               size_t size, size_t offset, size_t cls)
+    : buffer_sub(slab, size, offset)
+    , m_arena(std::move(arena))
+    , m_slab(std::move(slab))
+    , m_class(cls)
+  {}
+
+  ~buffer_arena() override;
+
+  buffer_arena(const buffer_arena&) = delete;
+  buffer_arena(buffer_arena&&) = delete;
+  buffer_arena& operator=(buffer_arena&) = delete;
+  buffer_arena& operator=(buffer_arena&&) = delete;
 };
 
 // class buffer_xbuf - Wrapper for extern managed xclBufferHandle
@@ -982,6 +1384,12 @@ public:
     throw xrt_core::error(std::errc::not_supported, "no sync of xcl managed BOs");
   }
 
+  bool
+  has_handle_sync() const override
+  {
+    return false;
+  }
+
   bool
   is_sub() const override
   {
@@ -1069,6 +1477,239 @@ alloc_bo(const device_type& device, size_t sz, xrtBufferFlags flags, xrtMemoryGr
   }
 }
 
+// class userptr_cache - Cache of pinned user pointer registrations
+//
+// A registration is the shim buffer handle created for a user
+// pointer, which pins the user memory for as long as it lives.
+// Buffers get the handle through an aliasing shared pointer whose
+// deleter returns the registration to the cache, so the cache knows
+// when a registration is unused.  Unused registrations stay pinned,
+// in least recently used order, until their total size exceeds the
+// cache limit or their memory is invalidated.
+//
+// Registrations refer to their device only weakly so that cached
+// registrations do not keep the device open.  Instead the cache is
+// cleared of a device's registrations when the device is closed and
+// of a hardware context's registrations when the context is
+// destroyed, both of which happen only after all buffers using the
+// registrations are gone.
+class userptr_cache : public std::enable_shared_from_this<userptr_cache>
+{
+  struct key_type
+  {
+    const xrt_core::device* device;
+    const xrt_core::hwctx_handle* hwctx;
+    uintptr_t addr;
+    size_t size;
+    xrtBufferFlags flags;
+    xrtMemoryGroup grp;
+
+    bool
+    operator<(const key_type& rhs) const
+    {
+      return std::tie(device, hwctx, addr, size, flags, grp)
+        < std::tie(rhs.device, rhs.hwctx, rhs.addr, rhs.size, rhs.flags, rhs.grp);
+    }
+  };
+
+  struct entry
+  {
+    key_type key;
+    std::weak_ptr<xrt_core::device> device;
+    std::shared_ptr<xrt_core::buffer_handle> handle;
+    size_t refs = 0;
+    bool valid = true;
+    std::list<entry*>::iterator lru; // valid when refs == 0
+  };
+
+  using entry_ptr = std::shared_ptr<entry>;
+
+  using entry_map = std::map<key_type, entry_ptr>;
+
+  size_t m_capacity;
+  std::mutex m_mutex;
+  entry_map m_entries;
+  std::list<entry*> m_lru;  // unused entries, most recently used first
+  xrt::ext::userptr_cache::stats m_stats {};
+
+  // Entries to be unpinned are collected and released after the
+  // lock is dropped, since freeing a handle calls the driver.
+  using retired_list = std::vector<entry_ptr>;
+
+  void
+  evict(retired_list& retired)
+  {
+    while (m_stats.cached_bytes > m_capacity && !m_lru.empty()) {
+      auto ent = m_lru.back();
+      m_lru.pop_back();
+      auto itr = m_entries.find(ent->key);
+      retired.push_back(itr->second);
+      m_entries.erase(itr);
+      m_stats.cached_bytes -= ent->key.size;
+      m_stats.pinned_bytes -= ent->key.size;
+      ++m_stats.evictions;
+    }
+  }
+
+  void
+  release(const entry_ptr& ent)
+  {
+    retired_list retired;
+    std::shared_ptr<xrt_core::buffer_handle> unpin;
+    std::lock_guard lk(m_mutex);
+    if (--ent->refs)
+      return;
+
+    if (!ent->valid) {
+      // Invalidated while in use, already removed from the map
+      m_stats.pinned_bytes -= ent->key.size;
+      unpin = std::move(ent->handle);
+      return;
+    }
+
+    m_lru.push_front(ent.get());
+    ent->lru = m_lru.begin();
+    m_stats.cached_bytes += ent->key.size;
+    evict(retired);
+  }
+
+  // Handle used by buffer objects for this entry.  A buffer can
+  // outlive the cache at exit, in which case the registration is
+  // released along with the buffer.
+  std::shared_ptr<xrt_core::buffer_handle>
+  use(const entry_ptr& ent)
+  {
+    if (ent->refs++ == 0 && ent->lru != m_lru.end()) {
+      m_lru.erase(ent->lru);
+      ent->lru = m_lru.end();
+      m_stats.cached_bytes -= ent->key.size;
+    }
+    return {ent->handle.get(), [cache = weak_from_this(), ent](xrt_core::buffer_handle*) {
+      if (auto impl = cache.lock())
+        impl->release(ent);
+    }};
+  }
+
+  // Remove an entry from the map.  An unused entry is unpinned with
+  // the retired list, an entry in use when it is released.
+  entry_map::iterator
+  remove(entry_map::iterator itr, retired_list& retired)
+  {
+    auto& ent = itr->second;
+    ent->valid = false;
+    if (!ent->refs) {
+      m_lru.erase(ent->lru);
+      m_stats.cached_bytes -= ent->key.size;
+      m_stats.pinned_bytes -= ent->key.size;
+      retired.push_back(ent);
+    }
+    return m_entries.erase(itr);
+  }
+
+  // Remove all entries matching pred, returns number removed
+  template <typename Predicate>
+  size_t
+  remove_if(Predicate pred)
+  {
+    size_t count = 0;
+    retired_list retired;
+    std::lock_guard lk(m_mutex);
+    for (auto itr = m_entries.begin(); itr != m_entries.end();) {
+      if (!pred(*itr->second)) {
+        ++itr;
+        continue;
+      }
+      itr = remove(itr, retired);
+      ++count;
+    }
+    return count;
+  }
+
+public:
+  explicit userptr_cache(size_t capacity)
+    : m_capacity(capacity)
+  {}
+
+  std::shared_ptr<xrt_core::buffer_handle>
+  acquire(const device_type& device, void* userptr, size_t sz, xrtBufferFlags flags, xrtMemoryGroup grp)
+  {
+    key_type key {device.get_core_device(), device.get_hwctx_handle(),
+                  reinterpret_cast<uintptr_t>(userptr), sz, flags, grp};
+    {
+      retired_list retired;
+      std::lock_guard lk(m_mutex);
+      if (auto itr = m_entries.find(key); itr != m_entries.end()) {
+        if (!itr->second->device.expired()) {
+          ++m_stats.hits;
+          return use(itr->second);
+        }
+
+        // Device was closed and reopened without the cache being
+        // cleared, the registration belongs to the closed device
+        remove(itr, retired);
+      }
+      ++m_stats.misses;
+    }
+
+    // Pin outside the lock, another thread may have pinned the same
+    // memory meanwhile in which case its registration is used
+    auto ent = std::make_shared<entry>();
+    ent->key = key;
+    ent->device = device.get_device();
+    ent->handle = alloc_bo(device, userptr, sz, flags, grp);
+
+    std::lock_guard lk(m_mutex);
+    ent->lru = m_lru.end();
+    auto [itr, inserted] = m_entries.emplace(key, ent);
+    if (inserted)
+      m_stats.pinned_bytes += sz;
+    return use(itr->second);
+  }
+
+  void
+  invalidate(const void* userptr, size_t sz)
+  {
+    auto begin = reinterpret_cast<uintptr_t>(userptr);
+    auto end = begin + sz;
+    auto count = remove_if([begin, end](const entry& ent) {
+      return ent.key.addr < end && ent.key.addr + ent.key.size > begin;
+    });
+
+    std::lock_guard lk(m_mutex);
+    m_stats.invalidations += count;
+  }
+
+  void
+  clear(const xrt_core::device* device)
+  {
+    remove_if([device](const entry& ent) { return ent.key.device == device; });
+  }
+
+  void
+  clear(const xrt_core::hwctx_handle* hwctx)
+  {
+    remove_if([hwctx](const entry& ent) { return ent.key.hwctx == hwctx; });
+  }
+
+  xrt::ext::userptr_cache::stats
+  get_stats()
+  {
+    std::lock_guard lk(m_mutex);
+    return m_stats;
+  }
+};
+
+// The cache is destroyed at exit, which unpins all unused
+// registrations
+static userptr_cache*
+get_userptr_cache()
+{
+  static auto cache = xrt_core::config::get_userptr_cache_mb()
+    ? std::make_shared<userptr_cache>(static_cast<size_t>(xrt_core::config::get_userptr_cache_mb()) * 1024 * 1024)
+    : nullptr;
+  return cache.get();
+}
+
 // driver allocates host buffer
 static std::shared_ptr<xrt::bo_impl>
 alloc_kbuf(const device_type& device, size_t sz, xrtBufferFlags flags, xrtMemoryGroup grp)
@@ -1095,8 +1736,12 @@ alloc_ubuf(const device_type& device, void* userptr, size_t sz, xrtBufferFlags f
   if (!is_aligned_ptr(userptr))
     throw xrt_core::error(EINVAL, "userptr is not aligned");
 
-  // driver pins and manages userptr
-  auto handle = alloc_bo(device, userptr, sz, flags, grp);
+  // driver pins and manages userptr, possibly cached from a previous
+  // buffer created from the same memory
+  auto cache = get_userptr_cache();
+  auto handle = cache
+    ? cache->acquire(device, userptr, sz, flags, grp)
+    : alloc_bo(device, userptr, sz, flags, grp);
   auto boh = std::make_shared<xrt::buffer_ubuf>(device, std::move(handle), sz, userptr);
   boh->get_usage_logger()->log_buffer_info_construct(device->get_device_id(), sz, device.get_hwctx_handle());
   return boh;
@@ -1106,12 +1751,47 @@ static std::shared_ptr<xrt::bo_impl>
 alloc_hbuf(const device_type& device, xrt_core::aligned_ptr_type&& hbuf, size_t sz, xrtBufferFlags flags, xrtMemoryGroup grp)
 {
   XRT_TRACE_POINT_SCOPE(xrt_bo_alloc_hbuf);
+
+  // Place the pages on the device node before the driver pins them
+  xrt_core::numa::bind_memory(hbuf.get(), sz, xrt_core::numa::get_device_node(device.get_core_device()));
   auto handle =  alloc_bo(device, hbuf.get(), sz, flags, grp);
   auto boh = std::make_shared<xrt::buffer_hbuf>(device, std::move(handle), sz, std::move(hbuf));
   boh->get_usage_logger()->log_buffer_info_construct(device->get_device_id(), sz, device.get_hwctx_handle());
   return boh;
 }
 
+// Allocate buffer with huge page backed host memory if requested by
+// Runtime.huge_pages.  Returns nullptr if huge pages are not used,
+// not available, or if the driver does not accept the memory, in
+// which case the caller allocates the buffer as usual.  Not used for
+// host only buffers, which drivers such as xocl do not allow to be
+// created from user memory.
+static std::shared_ptr<xrt::bo_impl>
+alloc_huge(const device_type& device, size_t sz, xrtBufferFlags flags, xrtMemoryGroup grp)
+{
+  if (!xrt_core::huge_page::use(sz))
+    return nullptr;
+
+  XRT_TRACE_POINT_SCOPE(xrt_bo_alloc_huge);
+  auto hbuf = xrt_core::huge_page::alloc(sz);
+  if (!hbuf)
+    return nullptr;
+
+  xrt_core::numa::bind_memory(hbuf.get(), sz, xrt_core::numa::get_device_node(device.get_core_device()));
+  std::unique_ptr<xrt_core::buffer_handle> handle;
+  try {
+    handle = alloc_bo(device, hbuf.get(), sz, flags, grp);
+  }
+  catch (const std::exception&) {
+    // driver does not support user memory for this buffer type
+    return nullptr;
+  }
+
+  auto boh = std::make_shared<xrt::buffer_huge>(device, std::move(handle), sz, std::move(hbuf));
+  boh->get_usage_logger()->log_buffer_info_construct(device->get_device_id(), sz, device.get_hwctx_handle());
+  return boh;
+}
+
 static std::shared_ptr<xrt::bo_impl>
 alloc_dbuf(const device_type& device, size_t sz, xrtBufferFlags, xrtMemoryGroup grp)
 {
@@ -1152,6 +1832,8 @@ alloc(const device_type& device, size_t sz, xrtBufferFlags flags, xrtMemoryGroup
       // In DC scenario, for sw_emu, use the xclAllocBO and xclMapBO instead of xclAllocUserPtrBO,
       // which helps to remove the extra copy in sw_emu.
       return alloc_kbuf(device, sz, flags, grp);
+    else if (auto boh = alloc_huge(device, sz, flags, grp))
+      return boh;
     else  // NOLINT hicpp-braces-around-statements
       return alloc_hbuf(device, xrt_core::aligned_alloc(get_alignment(), sz), sz, flags, grp);
 #endif
@@ -1558,6 +2240,42 @@ copy(const bo& src, size_t sz, size_t src_offset, size_t dst_offset)
     });
 }
 
+bo::async_handle
+bo::
+copy_async(const bo& src, size_t sz, size_t src_offset, size_t dst_offset)
+{
+  return xdp::native::profiling_wrapper("xrt::bo::copy_async",
+    [this, &src, sz, src_offset, dst_offset]{
+      auto op = [dst = handle, src = src.handle, sz, src_offset, dst_offset] {
+        dst->copy(src.get(), sz, src_offset, dst_offset);
+      };
+      return async_handle{std::make_shared<background_handle_impl>(*this, std::move(op))};
+    });
+}
+
+void
+bo::
+sync_batch(const std::vector<sync_range>& ranges)
+{
+  xdp::native::profiling_wrapper("xrt::bo::sync_batch", [&ranges]{
+    bo_impl::sync_batch(ranges);
+  });
+}
+
+bo::async_handle
+bo::
+sync_batch_async(std::vector<sync_range> ranges)
+{
+  if (ranges.empty())
+    throw xrt_core::system_error(EINVAL, "no buffers to sync");
+
+  return xdp::native::profiling_wrapper("xrt::bo::sync_batch_async", [&ranges]{
+    auto bo = ranges.front().buffer;
+    auto op = [ranges = std::move(ranges)] { bo_impl::sync_batch(ranges); };
+    return async_handle{std::make_shared<background_handle_impl>(std::move(bo), std::move(op))};
+  });
+}
+
 bo::
 ~bo() = default;
 
@@ -1670,6 +2388,228 @@ bo(const xrt::hw_context& hwctx, pid_type pid, xrt::bo::export_handle ehdl)
 
 } // xrt::ext
 
+////////////////////////////////////////////////////////////////
+// xrt::ext::bo_arena and xrt::ext::userptr_cache C++ API
+// implmentations (xrt_ext.h)
+////////////////////////////////////////////////////////////////
+namespace xrt::ext {
+
+// class bo_arena_impl - Slab allocator of sub-buffers
+//
+// Each slab is dedicated to one power of two size class and is carved
+// into equal blocks, so every block is aligned to its size class and
+// at least page aligned.  Free blocks are owned by the arena and kept
+// per size class in a small number of locked shards.  A thread
+// allocates from and releases to the shard selected by its id, takes
+// blocks from the other shards when its own is empty, and only
+// reserves a new slab when all shards are empty.  Since no free
+// block is held outside the arena, the slabs are released when the
+// arena and the last buffer allocated from it are destroyed.
+class bo_arena_impl : public std::enable_shared_from_this<bo_arena_impl>
+{
+  static constexpr size_t default_slab_size = 4 * 1024 * 1024;
+  static constexpr size_t min_blocks_per_slab = 8;
+  static constexpr size_t num_shards = 8;
+
+  struct block
+  {
+    std::shared_ptr<xrt::bo_impl> slab;
+    size_t offset;
+  };
+
+  using block_list = std::vector<block>;
+
+  struct shard
+  {
+    std::mutex mutex;
+    std::vector<block_list> free;  // free blocks per class
+  };
+
+  device_type m_device;
+  xrtBufferFlags m_flags;
+  xrt::memory_group m_grp;
+  size_t m_slab_size;
+  size_t m_min_block;
+  size_t m_classes;
+
+  std::array<shard, num_shards> m_shards;
+
+  std::atomic<size_t> m_slabs {0};
+  std::atomic<size_t> m_allocations {0};
+  std::atomic<size_t> m_outstanding {0};
+  std::atomic<size_t> m_oversize {0};
+
+  // Size class index for a buffer size, or npos if too large
+  size_t
+  get_class(size_t sz) const
+  {
+    size_t block = m_min_block;
+    for (size_t cls = 0; cls < m_classes; ++cls, block <<= 1)
+      if (sz <= block)
+        return cls;
+    return std::string::npos;
+  }
+
+  size_t
+  class_size(size_t cls) const
+  {
+    return m_min_block << cls;
+  }
+
+  // Index of the calling thread's shard, same for all arenas
+  static size_t
+  shard_index()
+  {
+    static thread_local const size_t idx = std::hash<std::thread::id>{}(std::this_thread::get_id()) % num_shards;
+    return idx;
+  }
+
+  // Pop a free block of class cls from shard, returns false if none
+  static bool
+  pop(shard& sh, size_t cls, block& blk)
+  {
+    std::lock_guard<std::mutex> lk(sh.mutex);
+    auto& list = sh.free[cls];
+    if (list.empty())
+      return false;
+    blk = std::move(list.back());
+    list.pop_back();
+    return true;
+  }
+
+  // Get a free block of class cls, preferably from the calling
+  // thread's shard, reserving a new slab if all shards are empty
+  block
+  get_block(size_t cls)
+  {
+    block blk;
+    auto idx = shard_index();
+    for (size_t i = 0; i < num_shards; ++i)
+      if (pop(m_shards[(idx + i) % num_shards], cls, blk))
+        return blk;
+
+    // Slab allocation is a driver call, done without holding a lock.
+    // The remaining blocks of the slab go to the thread's shard.
+    auto slab = ::alloc(m_device, m_slab_size, m_flags, m_grp);
+    ++m_slabs;
+    auto bsz = class_size(cls);
+    auto& sh = m_shards[idx];
+    std::lock_guard<std::mutex> lk(sh.mutex);
+    auto& list = sh.free[cls];
+    for (size_t offset = bsz; offset + bsz <= m_slab_size; offset += bsz)
+      list.push_back({slab, offset});
+    return {std::move(slab), 0};
+  }
+
+public:
+  bo_arena_impl(device_type device, xrtBufferFlags flags, xrt::memory_group grp, size_t slab_size)
+    : m_device(std::move(device))
+    , m_flags(flags)
+    , m_grp(grp)
+    , m_slab_size(slab_size ? slab_size : default_slab_size)
+    , m_min_block(get_alignment())
+  {
+    if (m_slab_size % m_min_block)
+      throw xrt_core::error(EINVAL, "bo_arena slab size must be a multiple of page size");
+
+    // Size classes from one page up to a size that fits at least
+    // min_blocks_per_slab blocks in a slab
+    size_t classes = 0;
+    for (size_t block = m_min_block; block * min_blocks_per_slab <= m_slab_size; block <<= 1)
+      ++classes;
+    m_classes = std::max<size_t>(classes, 1);
+    for (auto& sh : m_shards)
+      sh.free.resize(m_classes);
+  }
+
+  xrt::bo
+  alloc(size_t sz)
+  {
+    auto cls = get_class(sz);
+    if (cls == std::string::npos) {
+      ++m_oversize;
+      return xrt::bo{::alloc(m_device, sz, m_flags, m_grp)};
+    }
+
+    auto blk = get_block(cls);
+    auto boh = std::make_shared<xrt::buffer_arena>(weak_from_this(), std::move(blk.slab), sz, blk.offset, cls);
+    ++m_allocations;
+    ++m_outstanding;
+    return xrt::bo{std::move(boh)};
+  }
+
+  // Return a block to the calling thread's shard
+  void
+  release(size_t cls, std::shared_ptr<xrt::bo_impl> slab, size_t offset)
+  {
+    --m_outstanding;
+    auto& sh = m_shards[shard_index()];
+    std::lock_guard<std::mutex> lk(sh.mutex);
+    sh.free[cls].push_back({std::move(slab), offset});
+  }
+
+  bo_arena::stats
+  get_stats() const
+  {
+    return {m_slabs, m_slabs * m_slab_size, m_allocations, m_outstanding, m_oversize};
+  }
+};
+
+bo_arena::
+bo_arena(const xrt::device& device, xrt::bo::flags flags, xrt::memory_group grp, size_t slab_size)
+  : detail::pimpl<bo_arena_impl>(std::make_shared<bo_arena_impl>
+      (device_type{device.get_handle()}, adjust_buffer_flags(device_type{device.get_handle()}, flags, grp), grp, slab_size))
+{}
+
+bo_arena::
+bo_arena(const xrt::hw_context& hwctx, xrt::bo::flags flags, xrt::memory_group grp, size_t slab_size)
+  : detail::pimpl<bo_arena_impl>(std::make_shared<bo_arena_impl>
+      (device_type{hwctx}, adjust_buffer_flags(device_type{hwctx}, flags, grp), grp, slab_size))
+{}
+
+xrt::bo
+bo_arena::
+alloc(size_t sz)
+{
+  return handle->alloc(sz);
+}
+
+bo_arena::stats
+bo_arena::
+get_stats() const
+{
+  return handle->get_stats();
+}
+
+void
+userptr_cache::
+invalidate(const void* userptr, size_t sz)
+{
+  if (auto cache = get_userptr_cache())
+    cache->invalidate(userptr, sz);
+}
+
+userptr_cache::stats
+userptr_cache::
+get_stats()
+{
+  auto cache = get_userptr_cache();
+  return cache ? cache->get_stats() : stats{};
+}
+
+} // xrt::ext
+
+namespace xrt {
+
+buffer_arena::
+~buffer_arena()
+{
+  if (auto arena = m_arena.lock())
+    arena->release(m_class, std::move(m_slab), get_offset());
+}
+
+} // xrt
+
 ////////////////////////////////////////////////////////////////
 // XRT implmentation access to internal BO APIs
 ////////////////////////////////////////////////////////////////
@@ -1717,6 +2657,24 @@ create_dtrace_bo(const xrt::hw_context& hwctx, size_t sz)
   return create_bo_helper(hwctx, sz, XRT_BO_USE_DTRACE);
 }
 
+void
+finish(const xrt_core::device* device)
+{
+  if (auto cache = get_userptr_cache())
+    cache->clear(device);
+}
+
+void
+finish(const xrt_core::hwctx_handle* hwctx)
+{
+  // Buffers without a hwctx are cleared when the device is closed
+  if (!hwctx)
+    return;
+
+  if (auto cache = get_userptr_cache())
+    cache->clear(hwctx);
+}
+
 } // xrt_core::bo_int
 
 ////////////////////////////////////////////////////////////////
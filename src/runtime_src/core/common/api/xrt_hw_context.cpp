@@ -9,11 +9,14 @@
 
 #include "core/include/xrt/xrt_hw_context.h"
 #include "core/include/xrt/experimental/xrt_module.h"
+#include "bo_int.h"
 #include "hw_context_int.h"
 #include "module_int.h"
 #include "xclbin_int.h"
 
+#include "core/common/config_reader.h"
 #include "core/common/device.h"
+#include "core/common/message.h"
 #include "core/common/trace.h"
 #include "core/common/shim/hwctx_handle.h"
 #include "core/common/usage_metrics.h"
@@ -21,6 +24,49 @@
 
 #include <limits>
 #include <memory>
+#include <sstream>
+
+namespace {
+
+bool
+is_debug_enabled()
+{
+  return xrt_core::config::get_verbosity() >= static_cast<unsigned int>(xrt_core::message::severity_level::debug);
+}
+
+// Number of xclbin sections and meta data items decoded so far
+size_t
+get_decode_count(const xrt::xclbin& xclbin)
+{
+  return (xclbin && is_debug_enabled()) ? xrt_core::xclbin_int::get_decode_stats(xclbin).size() : 0;
+}
+
+// Report xclbin sections and meta data decoded since first, with
+// their decode time, at debug verbosity
+void
+report_decode(const xrt::xclbin& xclbin, size_t first)
+{
+  if (!xclbin || !is_debug_enabled())
+    return;
+
+  auto stats = xrt_core::xclbin_int::get_decode_stats(xclbin);
+  std::chrono::nanoseconds total{0};
+  std::ostringstream ostr;
+  ostr << "xclbin sections decoded during hw context creation:";
+  for (auto idx = first; idx < stats.size(); ++idx) {
+    const auto& stat = stats[idx];
+    ostr << ' ' << stat.name << " (";
+    if (stat.size)
+      ostr << stat.size << " bytes, ";
+    ostr << stat.time.count() / 1000.0 << " us)";
+    total += stat.time;
+  }
+  ostr << ", total " << total.count() / 1000.0 << " us, "
+       << stats.size() << " sections and meta data items decoded for xclbin " << xclbin.get_uuid().to_string();
+  xrt_core::message::send(xrt_core::message::severity_level::debug, "XRT", ostr.str());
+}
+
+} // namespace
 
 namespace xrt {
 
@@ -48,16 +94,21 @@ public:
     , m_xclbin(m_core_device->get_xclbin(xclbin_id))
     , m_cfg_param(std::move(cfg_param))
     , m_mode(xrt::hw_context::access_mode::shared)
-    , m_hdl{m_core_device->create_hw_context(xclbin_id, m_cfg_param, m_mode)}
   {
+    auto decoded = get_decode_count(m_xclbin);
+    m_hdl = m_core_device->create_hw_context(xclbin_id, m_cfg_param, m_mode);
+    report_decode(m_xclbin, decoded);
   }
 
   hw_context_impl(std::shared_ptr<xrt_core::device> device, const xrt::uuid& xclbin_id, access_mode mode)
     : m_core_device{std::move(device)}
     , m_xclbin{m_core_device->get_xclbin(xclbin_id)}
     , m_mode{mode}
-    , m_hdl{m_core_device->create_hw_context(xclbin_id, m_cfg_param, m_mode)}
-  {}
+  {
+    auto decoded = get_decode_count(m_xclbin);
+    m_hdl = m_core_device->create_hw_context(xclbin_id, m_cfg_param, m_mode);
+    report_decode(m_xclbin, decoded);
+  }
 
   hw_context_impl(std::shared_ptr<xrt_core::device> device, cfg_param_type cfg_param, access_mode mode)
     : m_core_device{std::move(device)}
@@ -99,7 +150,10 @@ public:
       // shared pointer must already exist to call get_shared_ptr(),
       // which is not true at that time.
       xrt_core::xdp::finish_flush_device(this);
-      
+
+      // Release cached buffer registrations of this context
+      xrt_core::bo_int::finish(m_hdl.get());
+
       // Reset within scope of dtor for trace point to measure time to reset
       m_hdl.reset();
     }
@@ -22,6 +22,7 @@
 #include "core/include/ert_fa.h"
 
 #include "bo.h"
+#include "callback_dispatcher.h"
 #include "command.h"
 #include "context_mgr.h"
 #include "device_int.h"
@@ -57,11 +58,15 @@
 #include <cstdarg>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <fstream>
+#include <thread>
 #include <type_traits>
 #include <utility>
 using namespace std::chrono_literals;
@@ -572,20 +577,34 @@ public:
     // The function also ensures that different devices can share same
     // hwctx handle, implying that even for same handle index, the CU
     // should be opened again if the device is different
+    //
+    // The ip_context is constructed without holding the lock, so that
+    // kernels in different hwctx or on different CUs are created
+    // concurrently.  CU contexts are reference counted by the context
+    // manager, so if two threads race to construct the same ip_context,
+    // the loser simply drops its copy in favor of the cached one.
     using ctx_ips = std::map<std::string, std::weak_ptr<ip_context>>;
     using ctx_to_ips = std::map<const xrt_core::hwctx_handle*, ctx_ips>;
     static std::mutex mutex;
     static std::map<xrt_core::device*, ctx_to_ips> dev2ips;
     auto device = xrt_core::hw_context_int::get_core_device_raw(hwctx);
     auto hwctx_hdl = static_cast<xrt_core::hwctx_handle*>(hwctx);
+    {
+      std::lock_guard<std::mutex> lk(mutex);
+      if (auto ipctx = dev2ips[device][hwctx_hdl][ip.get_name()].lock())
+        return ipctx;
+    }
+
+    // NOLINTNEXTLINE(modernize-make-shared)  used in weak_ptr
+    auto ipctx = std::shared_ptr<ip_context>(new ip_context(hwctx, ip));
     std::lock_guard<std::mutex> lk(mutex);
     auto& ctx2ips = dev2ips[device]; // hwctx handle -> [ip_context]*
     auto& ips = ctx2ips[hwctx_hdl];     // ipname -> ip_context
-    auto ipctx = ips[ip.get_name()].lock();
-    if (!ipctx)
-      // NOLINTNEXTLINE(modernize-make-shared)  used in weak_ptr
-      ips[ip.get_name()] = ipctx = std::shared_ptr<ip_context>(new ip_context(hwctx, ip));
+    auto& cached = ips[ip.get_name()];
+    if (auto existing = cached.lock())
+      return existing; // ipctx destructs after lk is released
 
+    cached = ipctx;
     return ipctx;
   }
 
@@ -730,19 +749,16 @@ public:
   kernel_command& operator=(kernel_command&) = delete;
   kernel_command& operator=(kernel_command&&) = delete;
 
+  // Encode the cumask one 32-bit word at a time rather than testing
+  // each of the max_cus bits individually.
   void
   encode_compute_units(const std::bitset<max_cus>& cumask, size_t num_cumasks)
   {
+    static const std::bitset<max_cus> word_mask {0xffffffff};
     auto ecmd = get_ert_cmd<ert_packet*>();
-    std::fill(ecmd->data, ecmd->data + num_cumasks, 0);
-
-    for (size_t cu_idx = 0; cu_idx < max_cus; ++cu_idx) {
-      if (!cumask.test(cu_idx))
-        continue;
-      auto mask_idx = cu_idx / cus_per_word;
-      auto idx_in_mask = cu_idx - mask_idx * cus_per_word;
-      ecmd->data[mask_idx] |= (1 << idx_in_mask);
-    }
+    for (size_t mask_idx = 0; mask_idx < num_cumasks; ++mask_idx)
+      ecmd->data[mask_idx] =
+        static_cast<uint32_t>(((cumask >> (mask_idx * cus_per_word)) & word_mask).to_ulong());
   }
 
   // Check if this kernel_command object is in done state
@@ -826,6 +842,17 @@ public:
       m_callbacks->pop_back();
   }
 
+  // Set internal completion listener, used by a command graph to be
+  // notified when the command completes.  A command with a listener
+  // is started managed.  The listener is called from the thread that
+  // observes the completion and must not block.
+  void
+  set_listener(std::function<void()> fcn)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_listener = std::move(fcn);
+  }
+
   // Run registered callbacks.
   void
   run_callbacks(ert_cmd_state state) const
@@ -861,7 +888,7 @@ public:
       std::lock_guard<std::mutex> lk(m_mutex);
       if (!m_done)
         throw std::runtime_error("bad command state, can't launch");
-      m_managed = (m_callbacks && !m_callbacks->empty());
+      m_managed = (m_callbacks && !m_callbacks->empty()) || m_listener;
       m_done = false;
     }
     if (m_managed)
@@ -937,6 +964,7 @@ public:
   {
     bool complete = false;
     bool callbacks = false;
+    std::function<void()> listener;
     if (s >= ERT_CMD_STATE_COMPLETED) {
       std::lock_guard<std::mutex> lk(m_mutex);
 
@@ -949,13 +977,28 @@ public:
       XRT_DEBUGF("kernel_command::notify() m_uid(%d) m_state(%d)\n", m_uid, s);
       complete = m_done = true;
       callbacks = (m_callbacks && !m_callbacks->empty());
+      if (m_listener)
+        listener = m_listener;
     }
 
-    if (complete) {
-      m_exec_done.notify_all();
-      if (callbacks)
-        run_callbacks(s);
+    if (!complete)
+      return;
+
+    m_exec_done.notify_all();
+    if (listener)
+      listener();
+
+    if (!callbacks)
+      return;
+
+    // Keep the command alive until the pool has called the callbacks
+    if (xrt_core::callback_dispatcher::enabled()) {
+      auto self = std::static_pointer_cast<const kernel_command>(shared_from_this());
+      xrt_core::callback_dispatcher::post(this, [self = std::move(self), s] { self->run_callbacks(s); });
+      return;
     }
+
+    run_callbacks(s);
   }
 
   void
@@ -980,6 +1023,7 @@ private:
   mutable std::condition_variable m_exec_done;
 
   std::unique_ptr<callback_list> m_callbacks;
+  std::function<void()> m_listener;
 };
 
 // class argument - get argument value from va_arg
@@ -1273,6 +1317,43 @@ public:
   { return arg.type; }
 };
 
+// struct arg_layout - register map placement of a kernel argument
+//
+// Computed once per kernel from the argument meta data, so that
+// setting an argument that is written directly to the register map
+// is a table lookup and a copy.  Arguments without an index (rtinfo)
+// are not settable and always take the validating path.
+struct arg_layout
+{
+  size_t offset;  // byte offset in register map
+  size_t size;    // bytes per meta data
+  bool settable;  // argument has an index
+};
+
+// Copy argument value to register map, common scalar and address
+// sizes are fixed size copies that compile to plain stores
+template <size_t bytes>
+inline void
+copy_arg_value(uint8_t* dst, const void* src)
+{
+  std::memcpy(dst, src, bytes);
+}
+
+inline void
+copy_arg_value(uint8_t* dst, const void* src, size_t bytes)
+{
+  switch (bytes) {
+  case sizeof(uint32_t):
+    copy_arg_value<sizeof(uint32_t)>(dst, src);
+    break;
+  case sizeof(uint64_t):
+    copy_arg_value<sizeof(uint64_t)>(dst, src);
+    break;
+  default:
+    std::memcpy(dst, src, bytes);
+  }
+}
+
 } // namespace
 
 namespace xrt {
@@ -1307,6 +1388,7 @@ private:
   xrt::xclbin xclbin;                  // xclbin with this kernel
   xrt::xclbin::kernel xkernel;         // kernel xclbin metadata
   std::vector<argument> args;          // kernel args sorted by argument index
+  std::vector<arg_layout> arg_layouts; // register map placement per args entry
   std::vector<ipctx> ipctxs;           // CU context locks
   const property_type& properties;     // Kernel properties from XML meta
   std::bitset<max_cus> cumask;         // cumask for command execution
@@ -1432,6 +1514,21 @@ private:
     case kernel_type::none:
       throw std::runtime_error("Internal error: wrong kernel type can't set cmd opcode");
     }
+
+    init_arg_layouts();
+  }
+
+  // Compute the register map placement of the amended args.  For
+  // FAST_ADAPTER kernels the arguments are placed in descriptor
+  // entries, these are set through the argument setter and the
+  // layout is unused.
+  void
+  init_arg_layouts()
+  {
+    arg_layouts.clear();
+    arg_layouts.reserve(args.size());
+    for (const auto& arg : args)
+      arg_layouts.push_back({arg.offset(), arg.size(), arg.index() != argument::no_index});
   }
 
   unsigned int
@@ -1820,6 +1917,12 @@ public:
     return args;
   }
 
+  const std::vector<arg_layout>&
+  get_arg_layouts() const
+  {
+    return arg_layouts;
+  }
+
   const argument&
   get_arg(size_t argidx, bool nocheck=false) const
   {
@@ -1886,6 +1989,15 @@ class run_impl
 
     virtual arg_range<uint8_t>
     get_arg_value(const argument& arg) = 0;
+
+    // Register map to which argument values are copied as is, per
+    // kernel arg_layout, or nullptr if setting an argument requires
+    // more than a copy
+    virtual uint8_t*
+    get_direct_regmap()
+    {
+      return nullptr;
+    }
   };
 
   // AP_CTRL_HS, AP_CTRL_CHAIN
@@ -1916,6 +2028,12 @@ class run_impl
     {
       return { data + arg.offset(), arg.size() };
     }
+
+    uint8_t*
+    get_direct_regmap() override
+    {
+      return data;
+    }
   };
 
   // FAST_ADAPTER
@@ -1966,6 +2084,13 @@ class run_impl
       uint64_t value[2] = {bo.address(), bo.size()}; // NOLINT
       hs_arg_setter::set_arg_value(arg, arg_range<uint8_t>{value, sizeof(value)});
     }
+
+    // global arguments are address and size
+    uint8_t*
+    get_direct_regmap() override
+    {
+      return nullptr;
+    }
   };
 
   static uint32_t
@@ -2011,12 +2136,31 @@ class run_impl
   arg_setter*
   get_arg_setter()
   {
-    if (!asetter)
+    if (!asetter) {
       asetter = make_arg_setter();
+      // arguments patched into the module are not plain copies
+      m_direct_regmap = m_module ? nullptr : asetter->get_direct_regmap();
+    }
 
     return asetter.get();
   }
 
+  // Set argument at index with a copy into the register map per the
+  // kernel argument layout.  Returns false if the argument must be
+  // set through the argument setter.
+  bool
+  set_arg_direct(size_t index, const void* value, size_t bytes)
+  {
+    get_arg_setter();
+    const auto& layouts = kernel->get_arg_layouts();
+    if (!m_direct_regmap || index >= layouts.size() || !layouts[index].settable)
+      return false;
+
+    const auto& layout = layouts[index];
+    copy_arg_value(m_direct_regmap + layout.offset, value, std::min(layout.size, bytes));
+    return true;
+  }
+
   bool
   validate_ip_arg_connectivity(size_t argidx, int32_t grpidx)
   {
@@ -2113,6 +2257,16 @@ class run_impl
     return payload;
   }
 
+  // Patch state of the instruction module.  A clone shares the module
+  // of the run it was cloned from, so the values patched into the
+  // module and whether it must be synced are kept with the module
+  // rather than with each run object.
+  struct module_patch_state
+  {
+    std::vector<std::vector<uint8_t>> args; // last value patched per arg index
+    bool dirty = true;                      // patched since last sync
+  };
+
   using callback_function_type = std::function<void(ert_cmd_state)>;
   std::shared_ptr<kernel_impl> kernel;    // shared ownership
   xrt::module m_module;                   // instruction module (optional)
@@ -2125,7 +2279,9 @@ class run_impl
   uint32_t m_header;                      // cached intialized command header
   uint32_t uid;                           // internal unique id for debug
   std::unique_ptr<arg_setter> asetter;    // helper to populate payload data
+  uint8_t* m_direct_regmap = nullptr;     // payload data if args are plain copies
   bool encode_cumasks = false;            // indicate if cmd cumasks must be re-encoded
+  std::shared_ptr<module_patch_state> m_patch_state; // shared with clones
   std::shared_ptr<xrt_core::usage_metrics::base_logger> m_usage_logger =
       xrt_core::usage_metrics::get_usage_metrics_logger();
 
@@ -2175,6 +2331,7 @@ public:
     , data(initialize_command(cmd.get()))
     , m_header(0)
     , uid(create_uid())
+    , m_patch_state(std::make_shared<module_patch_state>())
   {
     XRT_DEBUGF("run_impl::run_impl(%d)\n" , uid);
   }
@@ -2194,6 +2351,7 @@ public:
     , m_header(rhs->m_header)
     , uid(create_uid())
     , encode_cumasks(rhs->encode_cumasks)
+    , m_patch_state(rhs->m_patch_state)
   {
     XRT_DEBUGF("run_impl::run_impl(%d)\n" , uid);
   }
@@ -2288,13 +2446,41 @@ public:
     get_arg_setter()->set_arg_value(arg, value);
   }
 
+  // Record the value patched into the module for an argument.
+  // Returns false if the module is already patched with the same
+  // value, in which case patching and syncing the module again can
+  // be skipped.  Repeated starts of a run object that change only
+  // some arguments then patch only the changed ones, and prep_start()
+  // skips the module sync altogether when nothing changed.  The
+  // state is shared with clones, so a patch by either is seen by both.
+  bool
+  update_patched_arg(size_t index, const void* value, size_t bytes)
+  {
+    auto& args = m_patch_state->args;
+    if (index >= args.size())
+      args.resize(index + 1);
+
+    auto& prev = args[index];
+    auto begin = static_cast<const uint8_t*>(value);
+    if (!prev.empty() && prev.size() == bytes && std::equal(prev.begin(), prev.end(), begin))
+      return false;
+
+    prev.assign(begin, begin + bytes);
+    m_patch_state->dirty = true;
+    return true;
+  }
+
   void
   set_arg_value(const argument& arg, const xrt::bo& bo)
   {
     get_arg_setter()->set_arg_value(arg, bo);
     cmd->bind_arg_at_index(arg.index(), bo);
 
-    if (m_module)
+    if (!m_module)
+      return;
+
+    auto addr = bo.address();
+    if (update_patched_arg(arg.index(), &addr, sizeof(addr)))
       xrt_core::module_int::patch(m_module, arg.name(), arg.index(), bo);
   }
 
@@ -2303,7 +2489,7 @@ public:
   {
     set_arg_value(arg, arg_range<uint8_t>{value, bytes});
 
-    if (m_module)
+    if (m_module && update_patched_arg(arg.index(), value, bytes))
       xrt_core::module_int::patch(m_module, arg.name(), arg.index(), value, bytes);
   }
 
@@ -2329,6 +2515,12 @@ public:
   set_arg_at_index(size_t index, const xrt::bo& argbo)
   {
     auto bo = validate_bo_at_index(index, argbo);
+    auto addr = bo.address();
+    if (set_arg_direct(index, &addr, sizeof(addr))) {
+      cmd->bind_arg_at_index(index, bo);
+      return;
+    }
+
     auto& arg = kernel->get_arg(index);
     set_arg_value(arg, bo);
   }
@@ -2343,10 +2535,26 @@ public:
   void
   set_arg_at_index(size_t index, const void* value, size_t bytes)
   {
+    if (set_arg_direct(index, value, bytes))
+      return;
+
     auto& arg = kernel->get_arg(index);
     set_arg_value(arg, value, bytes);
   }
 
+  // Set arguments 0 through count-1
+  void
+  set_args(const xrt::run::arg_value* values, size_t count)
+  {
+    for (size_t index = 0; index < count; ++index) {
+      const auto& value = values[index];
+      if (value.bo)
+        set_arg_at_index(index, *value.bo);
+      else
+        set_arg_at_index(index, value.value, value.bytes);
+    }
+  }
+
   void
   get_arg_at_index(size_t index, uint32_t* out, size_t bytes)
   {
@@ -2391,10 +2599,12 @@ public:
   void
   prep_start()
   {
-    if (m_module)
+    if (m_module && m_patch_state->dirty) {
       // Sync the module to device to ensure any patches are applied,
-      // noop if module patching hasn't changed since last sync.
+      // skipped if no argument changed since last sync.
       xrt_core::module_int::sync(m_module);
+      m_patch_state->dirty = false;
+    }
 
     encode_compute_units();
 
@@ -2658,6 +2868,13 @@ class mailbox_impl : public run_impl
       mbox->kernel->read_register_n(arg.offset(), arg.size() / wsize, data32 + arg.offset() / wsize);
       return run_impl::hs_arg_setter::get_arg_value(arg);
     }
+
+    // arguments are written to mailbox as well
+    uint8_t*
+    get_direct_regmap() override
+    {
+      return nullptr;
+    }
   };
 
   void
@@ -2963,31 +3180,47 @@ public:
 //
 // Execution of a runlist is carved into multiple
 // submissions of chained ert commands.  The size
-// of a chain is currently hardwired, but at some
-// point will be dyanmic.
+// of a chain is the limit reported by the hw queue,
+// capped by what fits in a page sized execbuf.
+//
+// The chained commands are built as run objects are
+// added and are reused by every execution.  Each
+// execution prepares all run objects before the first
+// chain is submitted.  Preparing a run object restores
+// its command header, which execution overwrites, and
+// syncs its module or re-encodes its CUs only if they
+// changed.  The run objects' commands are shared by
+// consecutive executions, so the next execution cannot
+// be prepared while the current one is running; use
+// two runlists to overlap preparation and execution.
 class runlist_impl
 {
-  static constexpr size_t submit_size = 24;
+  static constexpr size_t default_submit_size = 24;
   static constexpr size_t noidx = std::numeric_limits<size_t>::max();
-  static constexpr size_t execbuf_size = sizeof(ert_packet) + sizeof(ert_cmd_chain_data) + submit_size * sizeof(uint64_t);
+  static constexpr size_t max_execbuf_size = 4096;
+  static constexpr size_t max_submit_size = (max_execbuf_size - sizeof(ert_packet) - sizeof(ert_cmd_chain_data)) / sizeof(uint64_t);
   static constexpr size_t word_size = sizeof(uint32_t); // ert payload word size
 
   // The runlist creates its own execution buffers, which are
   // ert_packets with payload interpreted as ert_cmd_chain_data
   using cmd_type = ert_packet;
   using execbuf_type = xrt_core::bo_cache::cmd_bo<cmd_type>;
-  xrt_core::bo_cache_t<execbuf_size> m_exec_buffer_cache;
 
   enum class state { idle, closed, running, error };
   mutable state m_state = state::idle;
   
   xrt::hw_context m_hwctx;
   xrt_core::hw_queue m_hwqueue;
+  size_t m_submit_size;
+
+  // Execution buffers sized for m_submit_size chained commands
+  xrt_core::bo_cache_t<max_execbuf_size> m_exec_buffer_cache;
+
   std::vector<xrt::run> m_runlist;
   std::vector<xrt_core::buffer_handle*> m_bos;
 
   // Commands are submitted in chained ert commands where the number
-  // of chained commands in less than 'submit_size'. The ert chained
+  // of chained commands in less than 'm_submit_size'. The ert chained
   // commands are created when run objects are added to the runlist.
   // The created commands are owned by m_cmds, but passed around as
   // pointers. Successfully submitted chained commands are added to
@@ -3007,6 +3240,26 @@ class runlist_impl
     return st2str.at(st);
   }
 
+  // Number of run objects per chained command.  An explicit ini
+  // setting takes precedence over the limit reported by the queue.
+  static size_t
+  get_submit_size(const xrt_core::hw_queue& hwqueue)
+  {
+    size_t size = xrt_core::config::get_runlist_chain_size();
+    if (!size)
+      size = hwqueue.get_max_chain_size();
+    if (!size)
+      size = default_submit_size;
+
+    return std::min(size, max_submit_size);
+  }
+
+  static constexpr size_t
+  get_execbuf_size(size_t submit_size)
+  {
+    return sizeof(ert_packet) + sizeof(ert_cmd_chain_data) + submit_size * sizeof(uint64_t);
+  }
+
   static std::pair<xrt_core::buffer_handle*, cmd_type*>
   unpack(const execbuf_type& execbuf)
   {
@@ -3040,7 +3293,7 @@ class runlist_impl
   execbuf_type*
   get_cmd_chain_for_run_at_index(size_t runidx)
   {
-    auto idx = runidx / submit_size;
+    auto idx = runidx / m_submit_size;
     if (idx < m_cmds.size())
       return &m_cmds[idx];
 
@@ -3135,7 +3388,7 @@ class runlist_impl
     for (auto execbuf : m_submitted_cmds) {
       auto state = get_completed_state(execbuf, 1ms);
       if (state == ERT_CMD_STATE_COMPLETED) {
-        runidx += submit_size;
+        runidx += m_submit_size;
         continue;
       }
 
@@ -3196,9 +3449,10 @@ public:
 public:
   explicit
   runlist_impl(xrt::hw_context hwctx)
-    : m_exec_buffer_cache{hwctx.get_device().get_handle(), 128}
-    , m_hwctx{std::move(hwctx)}
+    : m_hwctx{std::move(hwctx)}
     , m_hwqueue{m_hwctx}
+    , m_submit_size{get_submit_size(m_hwqueue)}
+    , m_exec_buffer_cache{m_hwctx.get_device().get_handle(), 128, get_execbuf_size(m_submit_size)}
   {}
 
   ~runlist_impl()
@@ -3264,7 +3518,8 @@ public:
     if (m_runlist.empty())
       return;
 
-    // Prep each run object
+    // Prep each run object before any chain is submitted, so that a
+    // prep error leaves the runlist idle
     for (auto& run : m_runlist)
       run.get_handle()->prep_start();
 
@@ -3372,6 +3627,482 @@ public:
   {}
 };
 
+
+// class command_graph_impl - The internals of a command graph
+//
+// Run objects are nodes and dependencies are edges.  When all run
+// objects are in fence capable queues of the same device, the graph
+// is submitted in dependency order with a fence for each edge, and
+// the device enforces the dependencies.  Otherwise a helper thread
+// resolves the dependencies on the host by starting run objects as
+// it is notified of the completion of their dependencies.
+class command_graph_impl
+{
+  using node = xrt::command_graph::node;
+
+  struct node_type
+  {
+    xrt::run run;
+    std::vector<node> successors;
+    size_t predecessors = 0;
+  };
+
+  enum class state { idle, running };
+  state m_state = state::idle;
+
+  std::vector<node_type> m_nodes;
+  std::vector<node> m_order;      // topological order of last execute
+  bool m_native = false;          // device enforces dependencies
+
+  // Native execution.  Fences are kept alive until the graph has
+  // completed.  m_started is the number of run objects (in m_order)
+  // that were started, m_wait_idx is the next one to wait for.
+  std::vector<xrt::fence> m_fences;
+  size_t m_started = 0;
+  size_t m_wait_idx = 0;
+
+  // First failure, reported by wait()
+  struct failure
+  {
+    ert_cmd_state state;
+    std::string message;
+  };
+  std::optional<failure> m_failure;
+
+  // Completed run objects posted by the completion listeners of run
+  // objects executing on the host.  Shared with the listeners so that
+  // a late notification never refers to a destroyed graph.
+  struct completion_queue
+  {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<node> nodes;
+  };
+  std::shared_ptr<completion_queue> m_completions = std::make_shared<completion_queue>();
+
+  // Host execution.  The helper thread is created on first host
+  // execute and lives until the graph is destroyed.
+  std::thread m_worker;
+  std::mutex m_mutex;
+  std::condition_variable m_work;
+  std::condition_variable m_done;
+  bool m_submitted = false;
+  bool m_completed = false;
+  bool m_stop = false;
+
+  static xrt_core::hw_queue
+  get_hw_queue(const xrt::run& run)
+  {
+    return run.get_handle()->get_kernel()->get_hw_queue();
+  }
+
+  static const xrt_core::device*
+  get_core_device(const xrt::run& run)
+  {
+    return run.get_handle()->get_kernel()->get_core_device();
+  }
+
+  node_type&
+  get_node(node nd)
+  {
+    if (nd >= m_nodes.size())
+      throw xrt_core::error(std::errc::invalid_argument, "invalid command graph node: " + std::to_string(nd));
+
+    return m_nodes[nd];
+  }
+
+  // True if 'to' can be reached from 'from'
+  bool
+  reachable(node from, node to) const
+  {
+    std::vector<bool> visited(m_nodes.size(), false);
+    std::vector<node> stack{from};
+    while (!stack.empty()) {
+      auto nd = stack.back();
+      stack.pop_back();
+      if (nd == to)
+        return true;
+      if (visited[nd])
+        continue;
+      visited[nd] = true;
+      for (auto succ : m_nodes[nd].successors)
+        stack.push_back(succ);
+    }
+    return false;
+  }
+
+  // Kahn's algorithm, ties are broken by order of insertion so that
+  // run objects are submitted in the order they were added.
+  void
+  sort()
+  {
+    std::vector<size_t> pending(m_nodes.size());
+    std::vector<node> ready;
+    for (node nd = m_nodes.size(); nd-- > 0;) {
+      pending[nd] = m_nodes[nd].predecessors;
+      if (!pending[nd])
+        ready.push_back(nd);
+    }
+
+    m_order.clear();
+    m_order.reserve(m_nodes.size());
+    while (!ready.empty()) {
+      auto nd = ready.back();
+      ready.pop_back();
+      m_order.push_back(nd);
+      for (auto succ : m_nodes[nd].successors)
+        if (--pending[succ] == 0)
+          ready.push_back(succ);
+    }
+  }
+
+  // Native execution requires all run objects to be in fence capable
+  // queues of the same device
+  bool
+  is_native() const
+  {
+    auto device = get_core_device(m_nodes.front().run);
+    return std::all_of(m_nodes.begin(), m_nodes.end(), [device](const auto& nd) {
+      return get_core_device(nd.run) == device && get_hw_queue(nd.run).has_fence_support();
+    });
+  }
+
+  void
+  record_failure(ert_cmd_state state, std::string msg)
+  {
+    std::lock_guard lk(m_mutex);
+    if (!m_failure)
+      m_failure = failure{state, std::move(msg)};
+  }
+
+  // Submit all run objects in dependency order.  A run object waits
+  // on its own copy of the fence signaled by each run object it
+  // depends on.  Queues are not assumed to execute in order, so
+  // dependencies within a queue are fenced too.
+  //
+  // A failed submission is reported by wait(), which waits only for
+  // the run objects that were started.  These always complete because
+  // a run object is started only after the signals of all run objects
+  // it depends on have been submitted.
+  void
+  submit_native()
+  {
+    std::vector<std::vector<xrt::fence>> waits(m_nodes.size());
+    std::vector<std::optional<xrt::fence>> signals(m_nodes.size());
+    m_fences.clear();
+    m_started = 0;
+    m_wait_idx = 0;
+
+    try {
+      for (node nd = 0; nd < m_nodes.size(); ++nd) {
+        if (m_nodes[nd].successors.empty())
+          continue;
+
+        signals[nd] = xrt::fence{m_nodes[nd].run.get_handle()->get_kernel()->get_hw_context().get_device(),
+                                 xrt::fence::access_mode::local};
+
+        // Copies must be made before the fence is signaled
+        for (auto succ : m_nodes[nd].successors)
+          waits[succ].emplace_back(*signals[nd]);
+      }
+
+      for (auto nd : m_order) {
+        auto run = m_nodes[nd].run.get_handle();
+        for (const auto& fence : waits[nd])
+          run->submit_wait(fence);
+        run->start();
+        ++m_started;
+        if (signals[nd])
+          run->submit_signal(*signals[nd]);
+      }
+    }
+    catch (const std::exception& ex) {
+      record_failure(ERT_CMD_STATE_ERROR, std::string{"Command graph failed to submit run object: "} + ex.what());
+    }
+
+    // Keep fences alive while queues may refer to them
+    for (auto& fences : waits)
+      std::move(fences.begin(), fences.end(), std::back_inserter(m_fences));
+    for (auto& fence : signals)
+      if (fence)
+        m_fences.push_back(std::move(*fence));
+  }
+
+  // Wait for started run objects in dependency order.  On timeout the
+  // wait resumes at the same run object next time.
+  std::cv_status
+  wait_native(const std::chrono::milliseconds& timeout)
+  {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (; m_wait_idx < m_started; ++m_wait_idx) {
+      auto run = m_nodes[m_order[m_wait_idx]].run.get_handle();
+      if (timeout.count()) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0)
+          return std::cv_status::timeout;
+        if (run->get_cmd()->wait(remaining).second == std::cv_status::timeout)
+          return std::cv_status::timeout;
+      }
+
+      if (auto state = run->wait(0ms); state != ERT_CMD_STATE_COMPLETED)
+        record_failure(state, "Command graph run object failed to complete successfully ("
+                       + cmd_state_to_string(state) + ")");
+    }
+
+    m_fences.clear();
+    return std::cv_status::no_timeout;
+  }
+
+  // Start a run object from the helper thread, a start failure is
+  // treated as failure of the run object.  A run object in a queue
+  // that monitors commands gets a listener that posts its completion
+  // to m_completions.
+  bool
+  start_on_host(node nd, bool monitored)
+  {
+    auto run = m_nodes[nd].run.get_handle();
+    try {
+      if (monitored) {
+        run->get_cmd()->set_listener([completions = m_completions, nd] {
+          {
+            std::lock_guard lk(completions->mutex);
+            completions->nodes.push_back(nd);
+          }
+          completions->cv.notify_one();
+        });
+      }
+      run->start();
+      return true;
+    }
+    catch (const std::exception& ex) {
+      if (monitored)
+        run->get_cmd()->set_listener(nullptr);
+      record_failure(ERT_CMD_STATE_ERROR, std::string{"Command graph failed to start run object: "} + ex.what());
+      return false;
+    }
+  }
+
+  // Take completions posted by listeners, optionally blocking until
+  // there is at least one
+  void
+  take_completions(std::vector<node>& completed, bool block)
+  {
+    std::unique_lock lk(m_completions->mutex);
+    if (block)
+      m_completions->cv.wait(lk, [this] { return !m_completions->nodes.empty(); });
+    completed.swap(m_completions->nodes);
+  }
+
+  // Execute the graph on the helper thread.  Run objects in queues
+  // that monitor commands post their completion through a listener
+  // and the helper thread sleeps until notified.  The helper thread
+  // itself waits for run objects in queues that do not monitor
+  // commands, oldest first, when no completion has been posted.
+  // After a failure, including failure to start a root run object, no
+  // new run objects are started, but started run objects are drained.
+  void
+  run_on_host()
+  {
+    std::vector<size_t> pending(m_nodes.size());
+    std::deque<node> unmonitored;
+    size_t inflight = 0;
+    bool failed = false;
+
+    auto start = [&](node nd) {
+      if (failed)
+        return;
+      auto monitored = get_hw_queue(m_nodes[nd].run).has_managed_support();
+      if (!start_on_host(nd, monitored)) {
+        failed = true;
+        return;
+      }
+      ++inflight;
+      if (!monitored)
+        unmonitored.push_back(nd);
+    };
+
+    {
+      // Discard completions of run objects started outside the graph
+      std::lock_guard lk(m_completions->mutex);
+      m_completions->nodes.clear();
+    }
+
+    for (auto nd : m_order) {
+      pending[nd] = m_nodes[nd].predecessors;
+      if (!pending[nd])
+        start(nd);
+    }
+
+    std::vector<node> completed;
+    while (inflight) {
+      take_completions(completed, unmonitored.empty());
+      if (completed.empty()) {
+        (void) m_nodes[unmonitored.front()].run.get_handle()->get_cmd()->wait();
+        completed.push_back(unmonitored.front());
+        unmonitored.pop_front();
+      }
+
+      for (auto nd : completed) {
+        --inflight;
+        auto run = m_nodes[nd].run.get_handle();
+        run->get_cmd()->set_listener(nullptr);
+        if (auto state = run->wait(0ms); state != ERT_CMD_STATE_COMPLETED) {
+          record_failure(state, "Command graph run object failed to complete successfully ("
+                         + cmd_state_to_string(state) + ")");
+          failed = true;
+        }
+
+        for (auto succ : m_nodes[nd].successors)
+          if (--pending[succ] == 0)
+            start(succ);
+      }
+      completed.clear();
+    }
+  }
+
+  void
+  worker()
+  {
+    std::unique_lock lk(m_mutex);
+    while (true) {
+      m_work.wait(lk, [this] { return m_stop || m_submitted; });
+      if (m_stop)
+        return;
+
+      m_submitted = false;
+      lk.unlock();
+      run_on_host();
+      lk.lock();
+      m_completed = true;
+      m_done.notify_all();
+    }
+  }
+
+  std::cv_status
+  wait_on_host(const std::chrono::milliseconds& timeout)
+  {
+    std::unique_lock lk(m_mutex);
+    auto completed = [this] { return m_completed; };
+    if (!timeout.count())
+      m_done.wait(lk, completed);
+    else if (!m_done.wait_for(lk, timeout, completed))
+      return std::cv_status::timeout;
+
+    return std::cv_status::no_timeout;
+  }
+
+public:
+  command_graph_impl() = default;
+
+  ~command_graph_impl()
+  {
+    try {
+      if (m_state == state::running)
+        (void) (m_native ? wait_native(0ms) : wait_on_host(0ms));
+    }
+    catch (const std::exception& ex) {
+      xrt_core::send_exception_message("command graph wait error: " + std::string(ex.what()));
+    }
+
+    if (m_worker.joinable()) {
+      {
+        std::lock_guard lk(m_mutex);
+        m_stop = true;
+      }
+      m_work.notify_one();
+      m_worker.join();
+    }
+  }
+
+  command_graph_impl(const command_graph_impl&) = delete;
+  command_graph_impl(command_graph_impl&&) = delete;
+  command_graph_impl& operator=(const command_graph_impl&) = delete;
+  command_graph_impl& operator=(command_graph_impl&&) = delete;
+
+  node
+  add(const xrt::run& run)
+  {
+    if (m_state != state::idle)
+      throw xrt_core::error("command graph must be idle before adding run objects");
+
+    auto found = std::any_of(m_nodes.begin(), m_nodes.end(), [&run](const auto& nd) {
+      return nd.run.get_handle() == run.get_handle();
+    });
+    if (found)
+      throw xrt_core::error(std::errc::invalid_argument, "run object is already part of command graph");
+
+    m_nodes.push_back({run, {}, 0});
+    return m_nodes.size() - 1;
+  }
+
+  void
+  add_dependency(node before, node after)
+  {
+    if (m_state != state::idle)
+      throw xrt_core::error("command graph must be idle before adding dependencies");
+
+    auto& from = get_node(before);
+    auto& to = get_node(after);
+    if (before == after || reachable(after, before))
+      throw xrt_core::error(std::errc::invalid_argument, "command graph dependency "
+                            + std::to_string(before) + " -> " + std::to_string(after) + " creates a cycle");
+
+    if (std::find(from.successors.begin(), from.successors.end(), after) != from.successors.end())
+      return;
+
+    from.successors.push_back(after);
+    ++to.predecessors;
+  }
+
+  void
+  execute()
+  {
+    if (m_state != state::idle)
+      throw xrt_core::error("command graph is already executing");
+
+    if (m_nodes.empty())
+      return;
+
+    sort();
+    m_failure.reset();
+    m_native = is_native();
+
+    if (m_native) {
+      m_state = state::running;
+      submit_native();
+      return;
+    }
+
+    if (!m_worker.joinable())
+      m_worker = std::thread([this] { worker(); });
+
+    {
+      std::lock_guard lk(m_mutex);
+      m_completed = false;
+      m_submitted = true;
+    }
+    m_state = state::running;
+    m_work.notify_one();
+  }
+
+  std::cv_status
+  wait(const std::chrono::milliseconds& timeout)
+  {
+    if (m_state != state::running)
+      return std::cv_status::no_timeout;
+
+    auto status = m_native ? wait_native(timeout) : wait_on_host(timeout);
+    if (status == std::cv_status::timeout)
+      return status;
+
+    m_state = state::idle;
+    if (auto error = std::exchange(m_failure, std::nullopt))
+      throw xrt::run::command_error(error->state, error->message);
+
+    return std::cv_status::no_timeout;
+  }
+};
+
 } // namespace xrt
 
 namespace {
@@ -3847,6 +4578,13 @@ set_arg_at_index(int index, const xrt::bo& glb)
   handle->set_arg_at_index(index, glb);
 }
 
+void
+run::
+set_args_at_index(const arg_value* values, size_t count)
+{
+  handle->set_args(values, count);
+}
+
 void
 run::
 update_arg_at_index(int index, const void* value, size_t bytes)
@@ -4076,6 +4814,51 @@ reset()
   handle->reset();
 }
 
+////////////////////////////////////////////////////////////////
+// xrt_kernel C++ experimental command_graph API implmentations
+// see experimental/xrt_kernel.h
+////////////////////////////////////////////////////////////////
+command_graph::
+command_graph()
+  : detail::pimpl<command_graph_impl>(std::make_shared<command_graph_impl>())
+{}
+
+command_graph::
+~command_graph()
+{
+  // For interception
+}
+
+command_graph::node
+command_graph::
+add(const xrt::run& run)
+{
+  return handle->add(run);
+}
+
+void
+command_graph::
+add_dependency(node before, node after)
+{
+  handle->add_dependency(before, after);
+}
+
+void
+command_graph::
+execute()
+{
+  XRT_TRACE_POINT_SCOPE(xrt_command_graph_execute);
+  handle->execute();
+}
+
+std::cv_status
+command_graph::
+wait(const std::chrono::milliseconds& timeout) const
+{
+  XRT_TRACE_POINT_SCOPE(xrt_command_graph_wait);
+  return handle->wait(timeout);
+}
+
 } // namespace xrt
 
 ////////////////////////////////////////////////////////////////
@@ -25,8 +25,11 @@
 #include <boost/algorithm/string.hpp>
 
 #include <array>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <map>
+#include <memory>
 #include <numeric>
 #include <regex>
 #include <set>
@@ -45,7 +48,7 @@ namespace {
 // NOLINTNEXTLINE
 constexpr size_t operator"" _kb(unsigned long long v)  { return 1024u * v; }
 
-constexpr size_t max_sections = 15;
+constexpr size_t max_sections = 16;
 static const std::array<axlf_section_kind, max_sections> kinds = {
   EMBEDDED_METADATA,
   AIE_METADATA,
@@ -61,9 +64,41 @@ static const std::array<axlf_section_kind, max_sections> kinds = {
   SOFT_KERNEL,
   AIE_PARTITION,
   IP_METADATA,
-  AIE_TRACE_METADATA
+  AIE_TRACE_METADATA,
+  PDI
 };
 
+// Sections that can appear more than once in an xclbin
+static bool
+is_multi_section(axlf_section_kind kind)
+{
+  return kind == SOFT_KERNEL || kind == PDI;
+}
+
+static std::string
+section_name(axlf_section_kind kind)
+{
+  switch (kind) {
+  case EMBEDDED_METADATA:      return "EMBEDDED_METADATA";
+  case AIE_METADATA:           return "AIE_METADATA";
+  case IP_LAYOUT:              return "IP_LAYOUT";
+  case CONNECTIVITY:           return "CONNECTIVITY";
+  case ASK_GROUP_CONNECTIVITY: return "GROUP_CONNECTIVITY";
+  case ASK_GROUP_TOPOLOGY:     return "GROUP_TOPOLOGY";
+  case MEM_TOPOLOGY:           return "MEM_TOPOLOGY";
+  case DEBUG_IP_LAYOUT:        return "DEBUG_IP_LAYOUT";
+  case SYSTEM_METADATA:        return "SYSTEM_METADATA";
+  case CLOCK_FREQ_TOPOLOGY:    return "CLOCK_FREQ_TOPOLOGY";
+  case BUILD_METADATA:         return "BUILD_METADATA";
+  case SOFT_KERNEL:            return "SOFT_KERNEL";
+  case AIE_PARTITION:          return "AIE_PARTITION";
+  case IP_METADATA:            return "IP_METADATA";
+  case AIE_TRACE_METADATA:     return "AIE_TRACE_METADATA";
+  case PDI:                    return "PDI";
+  default:                     return std::to_string(kind);
+  }
+}
+
 static std::vector<char>
 read_file(const std::string& fnm)
 {
@@ -375,24 +410,90 @@ class xclbin_impl
 {
   // struct xclbin_info - on demand xclbin meta data access
   //
-  // Constructed first time data is needed.  The class keeps
+  // Each item is constructed first time it is needed, so that only
+  // the sections it depends on are decoded.  The class keeps
   // xclbin::mem, xclbin::ip, and xclbin::kernel objects along with
   // references into the xclbin data itself.
   //
   // Also adds some computed data that is used by XRT core implementation.
   struct xclbin_info
   {
+    template <typename ItemType>
+    struct lazy
+    {
+      std::once_flag flag;
+      ItemType value;
+    };
+
     const xclbin_impl* m_ximpl;
-    std::string m_project_name;           // <project name="foo">
-    std::string m_fpga_device_name;       // <device fpgaDevice="foo">
-    std::vector<xclbin::mem> m_mems;
-    std::vector<xclbin::ip> m_ips;
-    std::vector<xclbin::kernel> m_kernels;
-    std::vector<xclbin::aie_partition> m_aie_partitions;
+    lazy<std::string> m_project_name;           // <project name="foo">
+    lazy<std::string> m_fpga_device_name;       // <device fpgaDevice="foo">
+    lazy<std::vector<xclbin::mem>> m_mems;
+    lazy<std::vector<xclbin::ip>> m_ips;
+    lazy<std::vector<xclbin::kernel>> m_kernels;
+    lazy<std::vector<xclbin::aie_partition>> m_aie_partitions;
 
     // encoded / compressed memory connection used by
     // xrt core to manage compute unit connectivity.
-    std::vector<size_t> m_membank_encoding;
+    lazy<std::vector<size_t>> m_membank_encoding;
+
+    // get() - construct item first time it is accessed
+    //
+    // Construction of an item may access other items, the time
+    // recorded for an item includes the time to construct those.
+    template <typename ItemType, typename InitFunction>
+    const ItemType&
+    get(lazy<ItemType>& item, const char* name, InitFunction init)
+    {
+      std::call_once(item.flag, [this, &item, name, &init] {
+        auto start = std::chrono::steady_clock::now();
+        item.value = init();
+        m_ximpl->record_decode(name, 0, std::chrono::steady_clock::now() - start);
+      });
+      return item.value;
+    }
+
+    const std::string&
+    get_project_name()
+    {
+      return get(m_project_name, "project_name", [this] { return init_project_name(m_ximpl); });
+    }
+
+    const std::string&
+    get_fpga_device_name()
+    {
+      return get(m_fpga_device_name, "fpga_device_name", [this] { return init_fpga_device_name(m_ximpl); });
+    }
+
+    const std::vector<xclbin::mem>&
+    get_mems()
+    {
+      return get(m_mems, "mems", [this] { return init_mems(m_ximpl); });
+    }
+
+    const std::vector<xclbin::ip>&
+    get_ips()
+    {
+      return get(m_ips, "ips", [this] { return init_ips(m_ximpl, get_mems()); });
+    }
+
+    const std::vector<xclbin::kernel>&
+    get_kernels()
+    {
+      return get(m_kernels, "kernels", [this] { return init_kernels(m_ximpl, get_ips()); });
+    }
+
+    const std::vector<xclbin::aie_partition>&
+    get_aie_partitions()
+    {
+      return get(m_aie_partitions, "aie_partitions", [this] { return init_aie_partitions(m_ximpl); });
+    }
+
+    const std::vector<size_t>&
+    get_membank_encoding()
+    {
+      return get(m_membank_encoding, "membank_encoding", [this] { return init_mem_encoding(get_mems()); });
+    }
 
     // init_mems() - populate m_mems with xrt::mem objects
     //
@@ -572,20 +673,17 @@ class xclbin_impl
     explicit
     xclbin_info(const xrt::xclbin_impl* impl)
       : m_ximpl(impl)
-      , m_project_name(init_project_name(m_ximpl))
-      , m_fpga_device_name(init_fpga_device_name(m_ximpl))
-      , m_mems(init_mems(m_ximpl))
-      , m_ips(init_ips(m_ximpl, m_mems))
-      , m_kernels(init_kernels(m_ximpl, m_ips))
-      , m_aie_partitions(init_aie_partitions(m_ximpl))
-      , m_membank_encoding(init_mem_encoding(m_mems))
     {}
   };
 
   // cache of meta data extracted from xclbin
   mutable std::unique_ptr<xclbin_info> m_info;
 
-  const xclbin_info*
+  // sections and meta data decoded so far
+  mutable std::mutex m_decode_mutex;
+  mutable std::vector<xrt_core::xclbin_int::decode_stat> m_decode_stats;
+
+  xclbin_info*
   get_xclbin_info() const
   {
     static std::mutex m;
@@ -595,6 +693,16 @@ class xclbin_impl
     return m_info.get();
   }
 
+protected:
+  // record_decode() - record time to decode a section or meta data item
+  void
+  record_decode(std::string name, size_t size, std::chrono::steady_clock::duration time) const
+  {
+    std::lock_guard<std::mutex> lk(m_decode_mutex);
+    m_decode_stats.push_back
+      ({std::move(name), size, std::chrono::duration_cast<std::chrono::nanoseconds>(time)});
+  }
+
 public:
   xclbin_impl() = default;
 
@@ -676,13 +784,13 @@ public:
   const std::vector<xclbin::kernel>&
   get_kernels() const
   {
-    return get_xclbin_info()->m_kernels;
+    return get_xclbin_info()->get_kernels();
   }
 
   xclbin::kernel
   get_kernel(const std::string& nm) const
   {
-    for (auto& kernel : get_xclbin_info()->m_kernels)
+    for (auto& kernel : get_xclbin_info()->get_kernels())
       if (kernel.get_name() == nm)
         return kernel;
 
@@ -692,14 +800,14 @@ public:
   const std::vector<xclbin::ip>&
   get_ips() const
   {
-    return get_xclbin_info()->m_ips;
+    return get_xclbin_info()->get_ips();
   }
 
   std::vector<xclbin::ip>
   get_ips(const std::string& name)
   {
     // Filter ips to those matching specified name
-    const auto& ips = get_xclbin_info()->m_ips;
+    const auto& ips = get_xclbin_info()->get_ips();
     if (name.empty())
       return ips;
 
@@ -711,7 +819,7 @@ public:
   xclbin::ip
   get_ip(const std::string& nm) const
   {
-    for (auto& ip : get_xclbin_info()->m_ips)
+    for (auto& ip : get_xclbin_info()->get_ips())
       if (ip.get_name() == nm)
         return ip;
 
@@ -721,31 +829,38 @@ public:
   const std::vector<xclbin::mem>&
   get_mems() const
   {
-    return get_xclbin_info()->m_mems;
+    return get_xclbin_info()->get_mems();
   }
 
   const std::vector<size_t>&
   get_membank_encoding() const
   {
-    return get_xclbin_info()->m_membank_encoding;
+    return get_xclbin_info()->get_membank_encoding();
   }
 
   const std::string&
   get_project_name() const
   {
-    return get_xclbin_info()->m_project_name;
+    return get_xclbin_info()->get_project_name();
   }
 
   const std::string&
   get_fpga_device_name() const
   {
-    return get_xclbin_info()->m_fpga_device_name;
+    return get_xclbin_info()->get_fpga_device_name();
   }
 
   const std::vector<xclbin::aie_partition>&
   get_aie_partitions() const
   {
-    return get_xclbin_info()->m_aie_partitions;
+    return get_xclbin_info()->get_aie_partitions();
+  }
+
+  std::vector<xrt_core::xclbin_int::decode_stat>
+  get_decode_stats() const
+  {
+    std::lock_guard<std::mutex> lk(m_decode_mutex);
+    return m_decode_stats;
   }
 };
 
@@ -753,33 +868,64 @@ public:
 //
 // A full xclbin is constructed from a file on disk or from a complete
 // binary images for file content
+//
+// Construction only indexes the section headers.  A section is copied
+// out of the raw data when first accessed, so a context that uses
+// only AIE or only PL sections does not pay for the others.
 class xclbin_full : public xclbin_impl
 {
+  // struct section - section within this xclbin
+  struct section
+  {
+    const axlf_section_header* hdr;
+    std::once_flag flag;
+    std::vector<char> data;     // valid when flag is set
+
+    explicit
+    section(const axlf_section_header* h)
+      : hdr(h)
+    {}
+  };
+
   std::vector<char> m_axlf;    // complete copy of xclbin raw data
   const axlf* m_top = nullptr; // axlf pointer to the raw data
   uuid m_uuid;                 // uuid of xclbin
   uuid m_intf_uuid;
 
-  // sections within this xclbin
-  std::multimap<axlf_section_kind, std::vector<char>> m_axlf_sections;
+  // sections within this xclbin by kind, in order of appearance
+  std::map<axlf_section_kind, std::vector<std::unique_ptr<section>>> m_axlf_sections;
 
   void
   emplace_section(const axlf_section_header* hdr, axlf_section_kind kind)
   {
-    auto section_data = reinterpret_cast<const char*>(m_top) + hdr->m_sectionOffset;
-    std::vector<char> data{section_data, section_data + hdr->m_sectionSize};
-    m_axlf_sections.emplace(kind , std::move(data));
+    m_axlf_sections[kind].push_back(std::make_unique<section>(hdr));
   }
 
   void
-  emplace_soft_kernel_sections(const axlf_section_header* hdr)
+  emplace_multi_sections(const axlf_section_header* hdr, axlf_section_kind kind)
   {
     while (hdr != nullptr) {
-      emplace_section(hdr, SOFT_KERNEL);
-      hdr = ::xclbin::get_axlf_section_next(m_top, hdr, SOFT_KERNEL);
+      emplace_section(hdr, kind);
+      hdr = ::xclbin::get_axlf_section_next(m_top, hdr, kind);
     }
   }
 
+  // materialize() - copy section data first time it is accessed
+  std::pair<const char*, size_t>
+  materialize(axlf_section_kind kind, size_t idx, section& sec) const
+  {
+    std::call_once(sec.flag, [this, kind, idx, &sec] {
+      auto start = std::chrono::steady_clock::now();
+      auto section_data = reinterpret_cast<const char*>(m_top) + sec.hdr->m_sectionOffset;
+      sec.data.assign(section_data, section_data + sec.hdr->m_sectionSize);
+      auto name = section_name(kind);
+      if (is_multi_section(kind))
+        name += "[" + std::to_string(idx) + "]";
+      record_decode(std::move(name), sec.data.size(), std::chrono::steady_clock::now() - start);
+    });
+    return {sec.data.data(), sec.data.size()};
+  }
+
   void
   init_axlf()
   {
@@ -797,9 +943,9 @@ class xclbin_full : public xclbin_impl
       if (!hdr)
         continue;
 
-      // account for multiple soft_kernel sections
-      if (kind == SOFT_KERNEL)
-        emplace_soft_kernel_sections(hdr);
+      // account for multiple soft_kernel and pdi sections
+      if (is_multi_section(kind))
+        emplace_multi_sections(hdr, kind);
       else
         emplace_section(hdr, kind);
     }
@@ -875,28 +1021,22 @@ public:
   {
     auto itr = m_axlf_sections.find(kind);
     return itr != m_axlf_sections.end()
-      ? std::make_pair((*itr).second.data(), (*itr).second.size())
+      ? materialize(kind, 0, *(*itr).second.front())
       : std::make_pair(nullptr, size_t(0));
   }
 
   std::vector<std::pair<const char*, size_t>>
   get_axlf_sections(axlf_section_kind kind) const override
   {
-    auto result = m_axlf_sections.equal_range(kind);
-
-    int count = std::distance(result.first, result.second);
-
-    if (count > 0) {
-      std::vector<std::pair<const char*, size_t>> return_sections;
+    auto itr = m_axlf_sections.find(kind);
+    if (itr == m_axlf_sections.end())
+      return {};
 
-      for (auto itr = result.first; itr != result.second; itr++)
-        return_sections.emplace_back(std::make_pair(itr->second.data(), itr->second.size()));
+    std::vector<std::pair<const char*, size_t>> return_sections;
+    for (size_t idx = 0; idx < (*itr).second.size(); ++idx)
+      return_sections.emplace_back(materialize(kind, idx, *(*itr).second[idx]));
 
-      return return_sections;
-    }
-    else {
-      return {};
-    }
+    return return_sections;
   }
 
   const axlf*
@@ -1607,6 +1747,12 @@ get_project_name(const xrt::xclbin& xclbin)
   return xclbin.get_handle()->get_project_name();
 }
 
+std::vector<decode_stat>
+get_decode_stats(const xrt::xclbin& xclbin)
+{
+  return xclbin.get_handle()->get_decode_stats();
+}
+
 } // xrt_core::xclbin_int
 
 ////////////////////////////////////////////////////////////////
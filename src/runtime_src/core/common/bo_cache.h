@@ -10,6 +10,7 @@
 #include "core/common/shim/buffer_handle.h"
 #include "core/include/xrt/detail/ert.h"
 
+#include <algorithm>
 #include <vector>
 #include <utility>
 #include <mutex>
@@ -34,8 +35,10 @@ private:
 
   // We are really allocating a page size as that is what xocl/zocl do. Note on
   // POWER9 pagesize maybe more than 4K, xocl would upsize the allocation to the
-  // correct pagesize. unmap always unmaps the full page.
-  static constexpr size_t m_bo_size = BoSize;
+  // correct pagesize. unmap always unmaps the full page.  Users that know the
+  // size of their commands can request smaller BOs for shims that allocate
+  // exactly the requested size.
+  const size_t m_bo_size = BoSize;
   std::shared_ptr<device> m_device;
   // Maximum number of BOs that can be cached in the pool. Value of 0 indicates
   // caching should be disabled.
@@ -52,6 +55,11 @@ public:
     : m_device(get_userpf_device(handle)), m_cache_max_size(max_size)
   {}
 
+  // Cache of BOs of bo_size bytes, at most BoSize
+  bo_cache_t(std::shared_ptr<xrt_core::device> device, unsigned int max_size, size_t bo_size)
+    : m_bo_size(std::min(bo_size, BoSize)), m_device(std::move(device)), m_cache_max_size(max_size)
+  {}
+
   ~bo_cache_t()
   {
     try {
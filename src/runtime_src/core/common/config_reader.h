@@ -160,6 +160,14 @@ get_power_profile_interval_ms()
   return value ;
 }
 
+inline unsigned int
+get_power_profile_max_samples()
+{
+  // NOLINTNEXTLINE
+  static unsigned int value = detail::get_uint_value("Debug.power_profile_max_samples", 65536) ;
+  return value ;
+}
+
 inline bool
 get_aie_profile()
 {
@@ -233,6 +241,20 @@ get_trace_file_dump_interval_s()
   return value;
 }
 
+inline std::string
+get_trace_file_format()
+{
+  static std::string value = detail::get_string_value("Debug.trace_file_format", "csv");
+  return value;
+}
+
+inline unsigned int
+get_trace_file_max_size_mb()
+{
+  static unsigned int value = detail::get_uint_value("Debug.trace_file_max_size_mb", 256);
+  return value;
+}
+
 inline std::string
 get_trace_buffer_size()
 {
@@ -371,6 +393,30 @@ get_logging()
   return value;
 }
 
+/**
+ * Write messages from a background thread.  Messages are staged per
+ * thread and written in order; error and more severe messages are
+ * written before send() returns.
+ */
+inline bool
+get_logging_async()
+{
+  static bool value = detail::get_bool_value("Runtime.runtime_log_async",false);
+  return value;
+}
+
+/**
+ * With asynchronous logging, identical messages repeated within this
+ * many milliseconds are written once followed by a count of the
+ * repeats.  The default (0) writes all messages.
+ */
+inline unsigned int
+get_logging_dedup_ms()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.runtime_log_dedup_ms",0);
+  return value;
+}
+
 inline bool
 get_trace_logging()
 {
@@ -554,6 +600,109 @@ get_cdma()
   return value;
 }
 
+/**
+ * Chunk size in KB used when copying buffers through host memory.
+ * Copies larger than one chunk are pipelined so that syncing of
+ * source, host copy, and syncing of destination overlap.
+ */
+inline unsigned int
+get_bo_copy_chunk_kb()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.bo_copy_chunk_kb",4096);
+  return value;
+}
+
+/**
+ * Number of threads copying chunks in a pipelined host copy of
+ * buffers.  The default (0) picks a number based on the number of
+ * available cores.
+ */
+inline unsigned int
+get_bo_copy_threads()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.bo_copy_threads",0);
+  return value;
+}
+
+/**
+ * Back XRT allocated host memory of normal buffers of 2MB or more
+ * with huge pages, falls back to regular pages if huge pages are not
+ * available or the driver does not accept the memory.  Host only
+ * buffers are allocated by the driver and are not affected.
+ */
+inline bool
+get_huge_pages()
+{
+  static bool value = detail::get_bool_value("Runtime.huge_pages",false);
+  return value;
+}
+
+/**
+ * Place runtime threads and XRT allocated host buffers of a device
+ * on the host NUMA node the device is attached to.  An explicit
+ * Runtime.cpu_affinity takes precedence for threads.
+ */
+inline bool
+get_numa_placement()
+{
+  static bool value = detail::get_bool_value("Runtime.numa_placement",true);
+  return value;
+}
+
+/**
+ * Number of threads delivering completion callbacks of managed runs.
+ * The default (0) calls the callbacks from the command monitor
+ * thread, where a slow callback delays completion of all commands on
+ * the same queue.
+ */
+inline unsigned int
+get_callback_threads()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.callback_threads",0);
+  return value;
+}
+
+/**
+ * Deliver completion callbacks of a run in completion order, one at
+ * a time, when callbacks are delivered by callback threads.  When
+ * false, callbacks of successive executions of the same run may be
+ * called concurrently.
+ */
+inline bool
+get_callback_ordered()
+{
+  static bool value = detail::get_bool_value("Runtime.callback_ordered",true);
+  return value;
+}
+
+/**
+ * Size in MB of unused pinned user pointer buffers that are kept
+ * registered with the driver for reuse by later buffers created from
+ * the same user pointer.  The default (0) disables the cache.  An
+ * application that enables the cache must invalidate cached ranges
+ * (xrt::ext::userptr_cache::invalidate) before freeing the memory.
+ */
+inline unsigned int
+get_userptr_cache_mb()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.userptr_cache_mb",0);
+  return value;
+}
+
+/**
+ * Number of run objects chained in one runlist submission.  The
+ * default (0) uses the limit reported by the hardware queue, or 24 if
+ * the queue reports none.  The value is capped by what fits in a
+ * page sized chain command buffer.  Each chain command buffer takes 8
+ * bytes per run object in addition to its header.
+ */
+inline unsigned int
+get_runlist_chain_size()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.runlist_chain_size",0);
+  return value;
+}
+
 inline bool
 get_enable_pr()
 {
@@ -600,6 +749,60 @@ get_noop_completion_delay_us()
   return delay;
 }
 
+/**
+ * Device model of the noop shim.  Service time distribution of each
+ * CU, the mean service time is noop_completion_delay_us.  One of
+ * constant, uniform, or exponential.
+ */
+inline std::string
+get_noop_service_time_distribution()
+{
+  static std::string value = detail::get_string_value("Runtime.noop_service_time_distribution", "constant");
+  return value;
+}
+
+/**
+ * Device model of the noop shim.  Number of commands the device
+ * accepts at a time, additional commands are held back by the
+ * shim.  0 is unbounded.
+ */
+inline unsigned int
+get_noop_queue_depth()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.noop_queue_depth", 0);
+  return value;
+}
+
+/**
+ * Device model of the noop shim.  Fixed latency and bandwidth in MB/s
+ * of a sync_bo transfer, 0 for no latency and unlimited bandwidth.
+ */
+inline unsigned int
+get_noop_dma_latency_us()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.noop_dma_latency_us", 0);
+  return value;
+}
+
+inline unsigned int
+get_noop_dma_bandwidth_mbps()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.noop_dma_bandwidth_mbps", 0);
+  return value;
+}
+
+/**
+ * Device model of the noop shim.  Expose a hardware queue per hardware
+ * context with its own completion channel instead of the device wide
+ * exec_wait.
+ */
+inline bool
+get_noop_hw_queue()
+{
+  static bool value = detail::get_bool_value("Runtime.noop_hw_queue", false);
+  return value;
+}
+
 /**
  * Set CMD BO cache size. CUrrently it is only used in xclCopyBO()
  */
@@ -760,6 +963,53 @@ get_flag_sw_emu_kernel_debug()
   return value;
 }
 
+/**
+ * Back sw_emu device memory with shared memory mapped into the
+ * device process, so that buffer transfers are plain copies instead
+ * of RPC messages.  Requires support in the device process.
+ */
+inline bool
+get_flag_sw_emu_shared_memory()
+{
+  static bool value = detail::get_bool_value("Emulation.sw_emu_shared_memory", false);
+  return value;
+}
+
+/**
+ * Number of emulation RPC requests, such as register writes and
+ * buffer writes, that are sent without waiting for their response.
+ * 0 waits for every response.
+ */
+inline unsigned int
+get_emulation_rpc_pipeline_depth()
+{
+  static unsigned int value = detail::get_uint_value("Emulation.rpc_pipeline_depth", 0);
+  return value;
+}
+
+/**
+ * Max number of small pipelined buffer writes combined into one
+ * emulation RPC request, 0 disables batching.  Requires support in
+ * the device process.
+ */
+inline unsigned int
+get_emulation_rpc_batch_size()
+{
+  static unsigned int value = detail::get_uint_value("Emulation.rpc_batch_size", 0);
+  return value;
+}
+
+/**
+ * Print per request latency of emulation RPC when the device is
+ * closed
+ */
+inline bool
+get_emulation_rpc_latency_stats()
+{
+  static bool value = detail::get_bool_value("Emulation.rpc_latency_stats", false);
+  return value;
+}
+
 // This flag is added to exit device offline status check loop forcibly.
 // By default, device offline status loop runs for 320 seconds.
 inline unsigned int
@@ -1017,6 +1267,18 @@ get_aie_trace_settings_file_dump_interval_s()
   return value;
 }
 
+/**
+ * Write AIE trace to the trace files while the application runs
+ * using a fixed pool of host buffers, rather than keeping all of
+ * it in memory until the end of the run
+ */
+inline bool
+get_aie_trace_settings_stream_to_file()
+{
+  static bool value = detail::get_bool_value("AIE_trace_settings.stream_to_file", false);
+  return value;
+}
+
 inline unsigned int
 get_aie_trace_settings_poll_timers_interval_us()
 {
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+#define XRT_CORE_COMMON_SOURCE
+#include "huge_page.h"
+#include "config_reader.h"
+#include "debug.h"
+
+#include <cerrno>
+#include <cstdint>
+
+#ifdef __linux__
+# include <sys/mman.h>
+# include <linux/mman.h>
+#endif
+
+namespace {
+
+namespace platform_specific {
+
+#ifdef __linux__
+
+constexpr size_t gb_page_size = 1024 * 1024 * 1024;
+
+static size_t
+round_up(size_t size, size_t align)
+{
+  return (size + align - 1) / align * align;
+}
+
+// Reserved huge pages from the hugetlb pool
+static void*
+alloc_hugetlb(size_t size, int page_flag)
+{
+  auto addr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | page_flag, -1, 0);
+  return (addr == MAP_FAILED) ? nullptr : addr;
+}
+
+// Huge page aligned anonymous memory advised for transparent huge
+// pages.  The mapping is over allocated by one huge page and trimmed
+// to alignment.
+static void*
+alloc_transparent(size_t size)
+{
+  auto addr = mmap(nullptr, size + xrt_core::huge_page::min_size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (addr == MAP_FAILED)
+    return nullptr;
+
+  auto start = reinterpret_cast<uintptr_t>(addr);
+  auto aligned = round_up(start, xrt_core::huge_page::min_size);
+  if (aligned > start)
+    munmap(addr, aligned - start);
+  if (auto tail = start + size + xrt_core::huge_page::min_size - (aligned + size))
+    munmap(reinterpret_cast<void*>(aligned + size), tail);
+
+  auto ptr = reinterpret_cast<void*>(aligned);
+  if (madvise(ptr, size, MADV_HUGEPAGE)) {
+    XRT_DEBUGF("huge_page::alloc madvise failed errno(%d)\n", errno);
+    munmap(ptr, size);
+    return nullptr;
+  }
+  return ptr;
+}
+
+static xrt_core::huge_page::ptr_type
+alloc(size_t size)
+{
+  if (size >= gb_page_size) {
+    auto mapped = round_up(size, gb_page_size);
+    if (auto addr = alloc_hugetlb(mapped, MAP_HUGE_1GB))
+      return {addr, {mapped}};
+  }
+
+  auto mapped = round_up(size, xrt_core::huge_page::min_size);
+  if (auto addr = alloc_hugetlb(mapped, 0))
+    return {addr, {mapped}};
+
+  if (auto addr = alloc_transparent(mapped))
+    return {addr, {mapped}};
+
+  return {};
+}
+
+static void
+free(void* addr, size_t size)
+{
+  munmap(addr, size);
+}
+
+#else
+
+static xrt_core::huge_page::ptr_type
+alloc(size_t)
+{
+  return {};
+}
+
+static void
+free(void*, size_t)
+{}
+
+#endif
+
+} // platform_specific
+
+} // namespace
+
+namespace xrt_core::huge_page {
+
+void
+deleter::
+operator() (void* addr) const
+{
+  platform_specific::free(addr, size);
+}
+
+bool
+use(size_t size, bool requested)
+{
+  return size >= min_size && (requested || xrt_core::config::get_huge_pages());
+}
+
+ptr_type
+alloc(size_t size)
+{
+  auto ptr = platform_specific::alloc(size);
+  XRT_DEBUGF("huge_page::alloc size(%zu) mapped(%zu)\n", size, ptr.get_deleter().size);
+  return ptr;
+}
+
+} // xrt_core::huge_page
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrtcore_huge_page_h_
+#define xrtcore_huge_page_h_
+
+#include "config.h"
+
+#include <cstddef>
+#include <memory>
+
+// Host memory backed by huge pages.  Large buffers that are written
+// by the host and pinned by the driver take fewer TLB entries and
+// fewer pages to pin when backed by 2MB or 1GB pages.
+//
+// Memory is taken from the hugetlb pools if pages are reserved there,
+// 1GB pages for buffers of at least 1GB, otherwise the default huge
+// page size.  If the pools are empty, the memory is a huge page
+// aligned anonymous mapping advised for transparent huge pages.  If
+// that fails too, allocation returns an empty pointer and the caller
+// uses regular memory.
+namespace xrt_core::huge_page {
+
+// Size of the smallest huge page, buffers smaller than this are not
+// backed by huge pages
+constexpr size_t min_size = 2 * 1024 * 1024;
+
+struct deleter
+{
+  size_t size = 0;  // size of mapping
+
+  XRT_CORE_COMMON_EXPORT
+  void
+  operator() (void* addr) const;
+};
+
+using ptr_type = std::unique_ptr<void, deleter>;
+
+// True if a buffer of size bytes should be backed by huge pages,
+// either because it is requested by the caller or because
+// Runtime.huge_pages is set
+XRT_CORE_COMMON_EXPORT
+bool
+use(size_t size, bool requested = false);
+
+// Allocate huge page backed memory of at least size bytes, aligned
+// to the huge page size.  The memory is not touched.  Returns empty
+// pointer if huge pages are not available.
+XRT_CORE_COMMON_EXPORT
+ptr_type
+alloc(size_t size);
+
+} // xrt_core::huge_page
+
+#endif
@@ -30,6 +30,17 @@
 #include "utils.h"
 #include "core/common/unistd.h"
 
+#include <boost/crc.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
 namespace {
 // Holds the parsed data from the memory topology object
 struct mem_bank_t
@@ -126,12 +137,19 @@ enum class operation_type {
   write
 };
 
-// Ensure safe access into a device's memory banks based on memory
-// bank boundary and if the bank is in use
-static void 
-perform_memory_action(xrt_core::device* device, xrt_core::aligned_ptr_type& buf, const uint64_t start_addr, const uint64_t size, operation_type action)
+// Contiguous range of device memory within one bank
+struct mem_segment_t
+{
+  uint64_t m_address;
+  uint64_t m_size;
+  const mem_bank_t* m_bank;
+};
+
+// Split an access of size bytes from start_addr into per bank
+// segments.  The access skips the gaps between used banks.
+static std::vector<mem_segment_t>
+get_segments(std::vector<mem_bank_t>& vec_banks, const uint64_t start_addr, const uint64_t size, operation_type action)
 {
-  auto vec_banks = get_ddr_banks(device);
   auto validated_start_addr = get_starting_address(vec_banks, start_addr);
   auto start_bank = get_starting_bank(vec_banks, validated_start_addr);
   auto available_size = get_available_memory_size(vec_banks, start_bank, validated_start_addr);
@@ -147,11 +165,11 @@ perform_memory_action(xrt_core::device* device, xrt_core::aligned_ptr_type& buf,
   if ((size == 0) && (action == operation_type::read))
     validated_size = available_size;
 
+  std::vector<mem_segment_t> segments;
   uint64_t current_addr = validated_start_addr;
-  size_t remaining_bytes_to_see = size;
-  size_t bytes_seen = 0;
+  uint64_t remaining_bytes_to_see = validated_size;
 
-  // continue to operate as long as there are bytes left to see or we run out of banks
+  // continue as long as there are bytes left to see or we run out of banks
   for (auto it = start_bank; (it != vec_banks.end()) && (remaining_bytes_to_see > 0); ++it) {
     // Validate the amount of memory the current memory bank has
     uint64_t available_bank_size = 0;
@@ -162,39 +180,314 @@ perform_memory_action(xrt_core::device* device, xrt_core::aligned_ptr_type& buf,
     else 
       available_bank_size = it->m_size - (current_addr - it->m_base_address);
 
-    // If the available bank size is less than the source buffer see what bytes we are able to and move to the next bank
-    uint64_t bytes_to_edit = std::min(available_bank_size, validated_size);
+    // If the available bank size is less than the remaining size see what bytes we are able to and move to the next bank
+    uint64_t bytes_to_edit = std::min(available_bank_size, remaining_bytes_to_see);
+    if (bytes_to_edit)
+      segments.push_back({current_addr, bytes_to_edit, &(*it)});
+    remaining_bytes_to_see -= bytes_to_edit;
+  }
+
+  if (remaining_bytes_to_see > 0) {
+    auto err_msg = boost::format("Warning: Saw %llu bytes. Requested %llu bytes") % (validated_size - remaining_bytes_to_see) % validated_size;
+    throw std::runtime_error(err_msg.str());
+  }
+
+  return segments;
+}
+
+// Access one range of device memory within a bank
+static void
+access_segment(xrt_core::device* device, void* buffer, uint64_t size, uint64_t address, const mem_bank_t& bank, operation_type action)
+{
+  boost::format err_fmt("%s: Code : %d - %s %u bytes from %s(0x%x)");
+  err_fmt % __func__;
+  switch (action) {
+    case operation_type::read:
+      try {
+        device->unmgd_pread(buffer, size, address);
+      } catch (const std::exception&) {
+        const auto err_msg = err_fmt % errno % "reading" % size % bank.m_tag % address;
+        throw xrt_core::error(std::errc::operation_canceled, err_msg.str());
+      }
+      break;
+    case operation_type::write:
+      try {
+        device->unmgd_pwrite(buffer, size, address);
+      } catch (const std::exception&) {
+        const auto err_msg = err_fmt % errno % "writing" % size % bank.m_tag % address;
+        throw xrt_core::error(std::errc::operation_canceled, err_msg.str());
+      }
+      break;
+  }
+}
 
-    // Update the buffer index based on how far we have read
+// Ensure safe access into a device's memory banks based on memory
+// bank boundary and if the bank is in use
+static void 
+perform_memory_action(xrt_core::device* device, xrt_core::aligned_ptr_type& buf, const uint64_t start_addr, const uint64_t size, operation_type action)
+{
+  if (size == 0)
+    return;
+
+  auto vec_banks = get_ddr_banks(device);
+  uint64_t bytes_seen = 0;
+  for (const auto& segment : get_segments(vec_banks, start_addr, size, action)) {
+    // Update the buffer index based on how far we have accessed
     void* current_buffer_location = static_cast<char *>(buf.get()) + bytes_seen;
-    boost::format err_fmt("%s: Code : %d - %s %u bytes from %s(0x%x)");
-    err_fmt % __func__;
-    switch (action) {
-      case operation_type::read:
-        try {
-          device->unmgd_pread(current_buffer_location, bytes_to_edit, validated_start_addr);
-        } catch (const std::exception&) {
-          const auto err_msg = err_fmt % errno % "reading" % bytes_to_edit % it->m_tag % current_addr;
-          throw xrt_core::error(std::errc::operation_canceled, err_msg.str());
-        }
-        break;
-      case operation_type::write:
-        try {
-          device->unmgd_pwrite(current_buffer_location, bytes_to_edit, validated_start_addr);
-        } catch (const std::exception&) {
-          const auto err_msg = err_fmt % errno % "writing" % bytes_to_edit % it->m_tag % current_addr;
-          throw xrt_core::error(std::errc::operation_canceled, err_msg.str());
+    access_segment(device, current_buffer_location, segment.m_size, segment.m_address, *segment.m_bank, action);
+    bytes_seen += segment.m_size;
+  }
+}
+
+static bool
+is_zero(const char* data, uint64_t size)
+{
+  return std::all_of(data, data + size, [](char c) { return c == 0; });
+}
+
+// Part of a memory segment transferred in one device access
+struct mem_chunk_t
+{
+  uint64_t m_address;
+  uint64_t m_offset;     // offset in the file
+  uint64_t m_size;
+  const mem_bank_t* m_bank;
+};
+
+// Transfer a device memory range to or from a file in chunks.
+//
+// Each chunk passes through two stages, the device access and the
+// file access, in the order of the transfer direction.  File access is
+// sequential and done by the calling thread in chunk order, device
+// accesses are done by worker threads.  A chunk occupies one of a
+// fixed number of buffers from its first stage until its second stage
+// is done, chunk i uses buffer i % slots after chunk i - slots has
+// released it.
+static xrt_core::mem_stream_result
+stream_memory_action(xrt_core::device* device, const uint64_t start_addr, const uint64_t size,
+                     const std::string& file, const xrt_core::mem_stream_options& options, operation_type action)
+{
+  auto vec_banks = get_ddr_banks(device);
+  auto segments = get_segments(vec_banks, start_addr, size, action);
+
+  xrt_core::mem_stream_result result;
+  for (const auto& segment : segments)
+    result.bytes += segment.m_size;
+
+  if (options.resume_offset > result.bytes) {
+    auto err_msg = boost::format("Resume offset %llu is beyond the %llu bytes to access") % options.resume_offset % result.bytes;
+    throw xrt_core::error(std::errc::operation_canceled, err_msg.str());
+  }
+
+  // Chunks are whole pages, the sparse check is per page
+  const uint64_t page_size = xrt_core::getpagesize();
+  const uint64_t chunk_size = std::max(page_size, (options.chunk_size + page_size - 1) / page_size * page_size);
+
+  std::vector<mem_chunk_t> chunks;
+  uint64_t offset = 0;
+  for (const auto& segment : segments) {
+    for (uint64_t pos = 0; pos < segment.m_size; pos += chunk_size) {
+      auto chunk_bytes = std::min(chunk_size, segment.m_size - pos);
+      // Skip what is done already, the resume offset may split a chunk
+      if (offset + pos + chunk_bytes <= options.resume_offset)
+        continue;
+      auto skip = (offset + pos < options.resume_offset) ? options.resume_offset - offset - pos : 0;
+      chunks.push_back({segment.m_address + pos + skip, offset + pos + skip, chunk_bytes - skip, segment.m_bank});
+    }
+    offset += segment.m_size;
+  }
+
+  // Open the file, keeping the completed part when resuming a read.
+  // Content beyond it is dropped, sparse skipped pages must read as zero.
+  if (action == operation_type::read && options.resume_offset) {
+    if (!std::filesystem::exists(file) || std::filesystem::file_size(file) < options.resume_offset)
+      throw xrt_core::error(std::errc::operation_canceled, "File is smaller than the resume offset: " + file);
+    std::filesystem::resize_file(file, options.resume_offset);
+  }
+
+  std::fstream fs;
+  if (action == operation_type::read)
+    fs.open(file, std::ios::binary | std::ios::out | (options.resume_offset ? std::ios::in : std::ios::trunc));
+  else
+    fs.open(file, std::ios::binary | std::ios::in);
+  if (!fs.is_open())
+    throw xrt_core::error(std::errc::operation_canceled, "Failed to open file: " + file);
+
+  const size_t slots = std::min<size_t>(std::max(chunks.size(), size_t(1)), 2 * std::max(options.threads, 1u));
+  std::vector<xrt_core::aligned_ptr_type> buffers;
+  for (size_t idx = 0; idx < slots; ++idx) {
+    buffers.emplace_back(xrt_core::aligned_alloc(page_size, chunk_size));
+    if (!buffers.back())
+      throw std::runtime_error("stream_memory_action: Failed to allocate aligned buffer");
+  }
+
+  // The checksum covers the entire range, including the part
+  // transferred before resuming
+  boost::crc_32_type crc;
+  if (options.checksum && options.resume_offset) {
+    auto data = static_cast<char*>(buffers[0].get());
+    for (uint64_t pos = 0; pos < options.resume_offset; pos += chunk_size) {
+      auto bytes = std::min(chunk_size, options.resume_offset - pos);
+      if (!fs.read(data, bytes))
+        throw xrt_core::error(std::errc::operation_canceled, "Failed to read the resumed part of file: " + file);
+      crc.process_bytes(data, bytes);
+    }
+  }
+  fs.seekg(options.resume_offset);
+  fs.seekp(options.resume_offset);
+
+  auto device_stage = [&](const mem_chunk_t& chunk, char* data) {
+    if (!options.sparse || action == operation_type::read) {
+      access_segment(device, data, chunk.m_size, chunk.m_address, *chunk.m_bank, action);
+      return;
+    }
+
+    // Write runs of non zero pages
+    for (uint64_t pos = 0; pos < chunk.m_size;) {
+      auto bytes = std::min(page_size, chunk.m_size - pos);
+      if (is_zero(data + pos, bytes)) {
+        pos += bytes;
+        continue;
+      }
+      auto end = pos + bytes;
+      while (end < chunk.m_size && !is_zero(data + end, std::min(page_size, chunk.m_size - end)))
+        end += std::min(page_size, chunk.m_size - end);
+      access_segment(device, data + pos, end - pos, chunk.m_address + pos, *chunk.m_bank, action);
+      pos = end;
+    }
+  };
+
+  auto file_stage = [&](const mem_chunk_t& chunk, char* data) {
+    if (action == operation_type::write) {
+      // Bytes beyond the end of the file are zeros
+      fs.read(data, chunk.m_size);
+      auto bytes = static_cast<uint64_t>(fs.gcount());
+      std::memset(data + bytes, 0, chunk.m_size - bytes);
+      if (bytes < chunk.m_size)
+        fs.clear();
+    }
+
+    if (options.checksum)
+      crc.process_bytes(data, chunk.m_size);
+
+    if (action == operation_type::read) {
+      for (uint64_t pos = 0; pos < chunk.m_size;) {
+        auto bytes = std::min(page_size, chunk.m_size - pos);
+        if (options.sparse && is_zero(data + pos, bytes)) {
+          result.skipped += bytes;
+          pos += bytes;
+          continue;
         }
-        break;
+        fs.seekp(chunk.m_offset + pos);
+        fs.write(data + pos, bytes);
+        pos += bytes;
+      }
+      if (!fs)
+        throw xrt_core::error(std::errc::operation_canceled, "Error writing to file: " + file);
     }
-    remaining_bytes_to_see -= bytes_to_edit;
-    bytes_seen += bytes_to_edit;
+    else if (options.sparse) {
+      for (uint64_t pos = 0; pos < chunk.m_size; pos += page_size) {
+        auto bytes = std::min(page_size, chunk.m_size - pos);
+        if (is_zero(data + pos, bytes))
+          result.skipped += bytes;
+      }
+    }
+  };
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::exception_ptr error;
+  std::vector<uint64_t> generation(slots, 0);   // chunks done with the buffer
+  std::vector<bool> filled(slots, false);       // first stage done
+  std::vector<bool> done(chunks.size(), false);
+  size_t done_prefix = 0;                        // chunks done in order
+  size_t next_chunk = 0;                         // next chunk for a worker
+  const bool device_first = (action == operation_type::read);
+
+  // Run one stage of a chunk once its buffer is ready for it, false
+  // if the transfer failed
+  auto run_stage = [&](size_t idx, bool first) {
+    auto slot = idx % slots;
+    {
+      std::unique_lock<std::mutex> lk(mutex);
+      cv.wait(lk, [&] { return error || (generation[slot] == idx / slots && filled[slot] != first); });
+      if (error)
+        return false;
+    }
+
+    try {
+      auto data = static_cast<char*>(buffers[slot].get());
+      if (first == device_first)
+        device_stage(chunks[idx], data);
+      else
+        file_stage(chunks[idx], data);
+    }
+    catch (...) {
+      std::lock_guard<std::mutex> lk(mutex);
+      if (!error)
+        error = std::current_exception();
+      cv.notify_all();
+      return false;
+    }
+
+    {
+      std::lock_guard<std::mutex> lk(mutex);
+      filled[slot] = first;
+      if (!first) {
+        ++generation[slot];
+        done[idx] = true;
+        while (done_prefix < chunks.size() && done[done_prefix])
+          ++done_prefix;
+      }
+    }
+    cv.notify_all();
+    return true;
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t idx = 0; idx < std::min<size_t>(std::max(options.threads, 1u), chunks.size()); ++idx) {
+    workers.emplace_back([&] {
+      while (true) {
+        size_t chunk = 0;
+        {
+          std::lock_guard<std::mutex> lk(mutex);
+          if (error || next_chunk >= chunks.size())
+            return;
+          chunk = next_chunk++;
+        }
+        if (!run_stage(chunk, device_first))
+          return;
+      }
+    });
   }
 
-  if (remaining_bytes_to_see > 0) {
-    auto err_msg = boost::format("Warning: Saw %llu bytes. Requested %llu bytes") % bytes_seen % size;
-    throw std::runtime_error(err_msg.str());
+  for (size_t idx = 0; idx < chunks.size(); ++idx)
+    if (!run_stage(idx, !device_first))
+      break;
+
+  for (auto& worker : workers)
+    worker.join();
+
+  if (error) {
+    auto completed = (done_prefix < chunks.size()) ? chunks[done_prefix].m_offset : result.bytes;
+    try {
+      std::rethrow_exception(error);
+    }
+    catch (const std::exception& ex) {
+      auto err_msg = boost::format("%s\nThe first %llu bytes of the range were transferred") % ex.what() % completed;
+      throw std::runtime_error(err_msg.str());
+    }
   }
+
+  fs.close();
+
+  // Skipped trailing zero pages still count towards the file size
+  if (action == operation_type::read && options.sparse && std::filesystem::file_size(file) < result.bytes)
+    std::filesystem::resize_file(file, result.bytes);
+
+  if (options.checksum)
+    result.crc32 = crc.checksum();
+  return result;
 }
 
 } // Empty namespace
@@ -232,4 +525,18 @@ device_mem_write(device* device, const uint64_t start_addr, const std::vector<ch
   perform_memory_action(device, buf, start_addr, src.size(), operation_type::write);
 }
 
+mem_stream_result
+device_mem_read(device* device, const uint64_t start_addr, const uint64_t size,
+                const std::string& file, const mem_stream_options& options)
+{
+  return stream_memory_action(device, start_addr, size, file, options, operation_type::read);
+}
+
+mem_stream_result
+device_mem_write(device* device, const uint64_t start_addr, const uint64_t size,
+                 const std::string& file, const mem_stream_options& options)
+{
+  return stream_memory_action(device, start_addr, size, file, options, operation_type::write);
+}
+
 } // xrt_core namespace
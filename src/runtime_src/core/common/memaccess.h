@@ -23,9 +23,27 @@
 #include "core/common/device.h"
 
 // System includes
+#include <cstdint>
 #include <string>
 namespace xrt_core {
 
+// Options of device memory transfers to and from a file
+struct mem_stream_options
+{
+  uint64_t chunk_size = 0x400000;  // bytes per device access
+  unsigned int threads = 4;        // device accesses in flight
+  uint64_t resume_offset = 0;      // leading bytes of the range already transferred
+  bool checksum = false;           // compute crc32 of the entire range
+  bool sparse = false;             // skip pages of zeros
+};
+
+struct mem_stream_result
+{
+  uint64_t bytes = 0;      // size of the range, including resume_offset
+  uint64_t skipped = 0;    // bytes of zero pages that were skipped
+  uint32_t crc32 = 0;      // valid if checksum was requested
+};
+
 // This function safely reads from a device's memory banks. It will
 // ensure that the read attempts start/end on memory bank borders
 // when applicable. This prevents reading from an unused bank or
@@ -43,6 +61,31 @@ device_mem_read(device* device, const uint64_t start_addr, const uint64_t size);
 XRT_CORE_COMMON_EXPORT
 void
 device_mem_write(device* device, const uint64_t start_addr, const std::vector<char>& src);
+
+// Read size bytes of device memory into a file, with the same bank
+// handling as device_mem_read.  A size of 0 reads all memory from the
+// start address.
+//
+// The range is read in chunks by several threads while the calling
+// thread writes completed chunks to the file in order, so host memory
+// use is bounded by the chunks in flight.  With resume_offset, the
+// first resume_offset bytes of the range are assumed to be in the file
+// already.  With sparse, pages of zeros are not written, leaving holes
+// in the file.  On failure the exception tells how many leading bytes
+// of the range were completed.
+XRT_CORE_COMMON_EXPORT
+mem_stream_result
+device_mem_read(device* device, const uint64_t start_addr, const uint64_t size,
+                const std::string& file, const mem_stream_options& options);
+
+// Write size bytes from a file to device memory, the counterpart of
+// the file based device_mem_read.  Bytes beyond the end of the file are
+// written as zeros.  With sparse, pages of zeros are not written, which
+// requires the device memory to be zero already.
+XRT_CORE_COMMON_EXPORT
+mem_stream_result
+device_mem_write(device* device, const uint64_t start_addr, const uint64_t size,
+                 const std::string& file, const mem_stream_options& options);
 }
 
 #endif /* MEMACCESS_H */
@@ -27,8 +27,15 @@
 #include <thread>
 #include <mutex>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdarg>
 #include <climits>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <unordered_map>
 #ifdef __linux__
 # include <syslog.h>
 # include <linux/limits.h>
@@ -66,6 +73,24 @@ get_exe_path()
 
 using severity_level = xrt_core::message::severity_level;
 
+// Same format as xrt_core::timestamp(), but for the time at which a
+// message was sent
+static std::string
+format_time(std::time_t time)
+{
+  std::tm tm{};
+#ifdef _WIN32
+  if (gmtime_s(&tm, &time))
+    return "Time conversion failed";
+#else
+  if (!gmtime_r(&time, &tm))
+    return "Time conversion failed";
+#endif
+  char buf[64] = {0};
+  return std::strftime(buf, sizeof(buf), "%c GMT", &tm)
+    ? buf : "Time conversion failed";
+}
+
 //--
 class message_dispatch
 {
@@ -74,7 +99,8 @@ public:
   virtual ~message_dispatch() {}
   static message_dispatch* make_dispatcher(const std::string& choice);
 public:
-  virtual void send(severity_level l, const char* tag, const char* msg) = 0;
+  virtual void send(severity_level l, const char* tag, const char* msg,
+                    std::time_t time, std::thread::id tid) = 0;
 };
 
 //--
@@ -83,7 +109,7 @@ class null_dispatch : public message_dispatch
 public:
   null_dispatch() {}
   virtual ~null_dispatch() {}
-  virtual void send(severity_level, const char*, const char*) {};
+  virtual void send(severity_level, const char*, const char*, std::time_t, std::thread::id) {};
 };
 
 //--
@@ -92,7 +118,8 @@ class console_dispatch : public message_dispatch
 public:
   console_dispatch();
   virtual ~console_dispatch() {}
-  virtual void send(severity_level l, const char* tag, const char* msg) override;
+  virtual void send(severity_level l, const char* tag, const char* msg,
+                    std::time_t time, std::thread::id tid) override;
 private:
   std::map<severity_level, const char*> severityMap = {
     { severity_level::emergency, "EMERGENCY: "},
@@ -117,7 +144,8 @@ public:
   virtual ~syslog_dispatch()
   { closelog(); }
 
-  virtual void send(severity_level l, const char* tag, const char* msg) override
+  virtual void send(severity_level l, const char*, const char* msg,
+                    std::time_t, std::thread::id) override
   { syslog(severityMap[l], "%s", msg); }
 
 private:
@@ -141,7 +169,8 @@ public:
   explicit
   file_dispatch(const std::string& file);
   virtual ~file_dispatch();
-  virtual void send(severity_level l, const char* tag, const char* msg) override;
+  virtual void send(severity_level l, const char* tag, const char* msg,
+                    std::time_t time, std::thread::id tid) override;
 private:
   std::ofstream handle;
   std::map<severity_level, const char*> severityMap = {
@@ -206,12 +235,12 @@ file_dispatch::~file_dispatch() {
 
 void
 file_dispatch::
-send(severity_level l, const char* tag, const char* msg)
+send(severity_level l, const char* tag, const char* msg, std::time_t time, std::thread::id tid)
 {
   static std::mutex mutex;
   std::lock_guard<std::mutex> lk(mutex);
-  handle << "[" << xrt_core::timestamp() <<"] [" << tag << "] Tid: "
-         << std::this_thread::get_id() << ", " << " " << severityMap[l]
+  handle << "[" << format_time(time) <<"] [" << tag << "] Tid: "
+         << tid << ", " << " " << severityMap[l]
          << msg << std::endl;
 }
 
@@ -232,7 +261,7 @@ console_dispatch()
 
 void
 console_dispatch::
-send(severity_level l, const char* tag, const char* msg)
+send(severity_level l, const char* tag, const char* msg, std::time_t, std::thread::id)
 {
   static std::mutex mutex;
   std::lock_guard<std::mutex> lk(mutex);
@@ -240,6 +269,340 @@ send(severity_level l, const char* tag, const char* msg)
             << msg << std::endl;
 }
 
+// class async_logger - Writes messages from a background thread
+//
+// Each sending thread stages its messages in its own ring, which the
+// sender fills and the writer drains without locking.  Messages of
+// one thread are written in the order they were sent.  Messages carry
+// a sequence number taken when sent, and the writer orders each
+// drained batch by it, so messages of different threads are in send
+// order within a batch only; a message staged late can be written in
+// a later batch than a message sent after it by another thread.
+// Messages of error severity or more are written before send()
+// returns, and all staged messages are written at exit.
+//
+// With dedup enabled, an identical message repeated within the dedup
+// window is counted rather than written, and the count is written when
+// the window expires.
+class async_logger
+{
+  static constexpr size_t ring_size = 1024;
+  static constexpr std::chrono::milliseconds flush_interval{10};
+
+  struct record
+  {
+    severity_level level = severity_level::debug;
+    std::string tag;
+    std::string msg;
+    std::function<std::string()> formatter;  // deferred formatting
+    std::time_t time = 0;
+    std::thread::id tid;
+    uint64_t seq = 0;
+  };
+
+  // Single producer, single consumer ring of records.  The producer
+  // is the owning thread, the consumer is whoever holds the drain
+  // lock.  The ring is closed when the owning thread exits.
+  class ring
+  {
+    std::vector<record> m_slots{ring_size};
+    std::atomic<size_t> m_head{0};
+    std::atomic<size_t> m_tail{0};
+    std::atomic<bool> m_closed{false};
+
+  public:
+    bool
+    push(record& rec)
+    {
+      auto tail = m_tail.load(std::memory_order_relaxed);
+      if (tail - m_head.load(std::memory_order_acquire) == ring_size)
+        return false;
+
+      m_slots[tail % ring_size] = std::move(rec);
+      m_tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    template <typename Consumer>
+    void
+    pop_all(Consumer&& consume)
+    {
+      auto head = m_head.load(std::memory_order_relaxed);
+      auto tail = m_tail.load(std::memory_order_acquire);
+      for (; head != tail; ++head)
+        consume(std::move(m_slots[head % ring_size]));
+      m_head.store(head, std::memory_order_release);
+    }
+
+    size_t
+    size() const
+    {
+      return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_relaxed);
+    }
+
+    void
+    close()
+    {
+      m_closed.store(true, std::memory_order_release);
+    }
+
+    bool
+    is_closed() const
+    {
+      return m_closed.load(std::memory_order_acquire);
+    }
+  };
+
+  struct repeat
+  {
+    std::chrono::steady_clock::time_point window;
+    uint64_t suppressed = 0;
+    record last;
+  };
+
+  message_dispatch* m_dispatcher;
+  std::chrono::milliseconds m_dedup;
+  std::atomic<uint64_t> m_seq{0};
+  std::atomic<bool> m_running{true};
+
+  std::mutex m_rings_mutex;
+  std::vector<std::shared_ptr<ring>> m_rings;
+
+  // Consumer side, protected by m_drain_mutex
+  std::mutex m_drain_mutex;
+  std::vector<record> m_batch;
+  std::unordered_map<std::string, repeat> m_repeats;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_stop = false;
+  std::thread m_thread;
+
+  ring*
+  get_ring()
+  {
+    // Closes the ring of this thread when the thread exits.  The
+    // writer removes closed rings once they are drained.
+    struct holder
+    {
+      std::shared_ptr<ring> r;
+      ~holder()
+      {
+        if (r)
+          r->close();
+      }
+    };
+
+    thread_local holder h;
+    if (!h.r) {
+      h.r = std::make_shared<ring>();
+      std::lock_guard lk(m_rings_mutex);
+      m_rings.push_back(h.r);
+    }
+    return h.r.get();
+  }
+
+  void
+  write(const record& rec)
+  {
+    m_dispatcher->send(rec.level, rec.tag.c_str(), rec.msg.c_str(), rec.time, rec.tid);
+  }
+
+  void
+  write_repeats(repeat& rep)
+  {
+    if (!rep.suppressed)
+      return;
+
+    rep.last.msg = "Previous message repeated " + std::to_string(rep.suppressed)
+      + " times: " + rep.last.msg;
+    write(rep.last);
+    rep.suppressed = 0;
+  }
+
+  void
+  emit(record& rec)
+  {
+    if (rec.formatter)
+      rec.msg = rec.formatter();
+
+    if (m_dedup.count() && rec.level > severity_level::error) {
+      auto now = std::chrono::steady_clock::now();
+      auto key = std::to_string(static_cast<int>(rec.level)) + '\n' + rec.tag + '\n' + rec.msg;
+      auto [itr, inserted] = m_repeats.try_emplace(std::move(key));
+      auto& rep = itr->second;
+      if (!inserted && now - rep.window < m_dedup) {
+        ++rep.suppressed;
+        rep.last = std::move(rec);
+        return;
+      }
+
+      write_repeats(rep);
+      rep.window = now;
+    }
+
+    write(rec);
+  }
+
+  // Write the repeat count of messages whose dedup window expired, or
+  // of all messages
+  void
+  expire_repeats(bool all)
+  {
+    auto now = std::chrono::steady_clock::now();
+    for (auto itr = m_repeats.begin(); itr != m_repeats.end();) {
+      if (!all && now - itr->second.window < m_dedup) {
+        ++itr;
+        continue;
+      }
+      write_repeats(itr->second);
+      itr = m_repeats.erase(itr);
+    }
+  }
+
+  void
+  drain(bool all)
+  {
+    std::lock_guard drain_lock(m_drain_mutex);
+    std::vector<std::shared_ptr<ring>> rings;
+    {
+      std::lock_guard lk(m_rings_mutex);
+      rings = m_rings;
+    }
+
+    // A ring observed closed before it is drained receives no more
+    // records and is removed after draining
+    std::vector<ring*> closed;
+    for (auto& r : rings) {
+      if (r->is_closed())
+        closed.push_back(r.get());
+      r->pop_all([this](record&& rec) { m_batch.push_back(std::move(rec)); });
+    }
+
+    if (!closed.empty()) {
+      std::lock_guard lk(m_rings_mutex);
+      m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(), [&closed](const auto& r) {
+        return std::find(closed.begin(), closed.end(), r.get()) != closed.end();
+      }), m_rings.end());
+    }
+
+    std::sort(m_batch.begin(), m_batch.end(), [](const auto& a, const auto& b) { return a.seq < b.seq; });
+    for (auto& rec : m_batch)
+      emit(rec);
+    m_batch.clear();
+
+    if (m_dedup.count())
+      expire_repeats(all);
+  }
+
+  void
+  run()
+  {
+    std::unique_lock lk(m_mutex);
+    while (!m_stop) {
+      m_cv.wait_for(lk, flush_interval);
+      lk.unlock();
+      drain(false);
+      lk.lock();
+    }
+  }
+
+public:
+  explicit
+  async_logger(message_dispatch* dispatcher)
+    : m_dispatcher(dispatcher)
+    , m_dedup(xrt_core::config::get_logging_dedup_ms())
+    , m_thread([this] { run(); })
+  {}
+
+  // The logger is never destroyed, messages sent after stop() are
+  // written by the sending thread
+  ~async_logger() = delete;
+  async_logger(const async_logger&) = delete;
+  async_logger& operator=(const async_logger&) = delete;
+
+  // Stop the writer thread and write all staged messages
+  void
+  stop()
+  {
+    {
+      std::lock_guard lk(m_mutex);
+      if (m_stop)
+        return;
+      m_stop = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+    m_running = false;
+    drain(true);
+  }
+
+  void
+  flush()
+  {
+    drain(true);
+  }
+
+  void
+  send(severity_level l, const char* tag, std::string msg, std::function<std::string()> formatter)
+  {
+    record rec;
+    rec.level = l;
+    rec.tag = tag;
+    rec.msg = std::move(msg);
+    rec.formatter = std::move(formatter);
+    rec.time = std::time(nullptr);
+    rec.tid = std::this_thread::get_id();
+
+    if (!m_running) {
+      if (rec.formatter)
+        rec.msg = rec.formatter();
+      write(rec);
+      return;
+    }
+
+    rec.seq = m_seq.fetch_add(1, std::memory_order_relaxed);
+    auto r = get_ring();
+    while (!r->push(rec)) {
+      // Ring is full, let the writer make room.  The writer may have
+      // stopped, in which case this thread drains its own ring.
+      m_cv.notify_one();
+      std::this_thread::yield();
+      if (!m_running)
+        drain(false);
+    }
+
+    if (l <= severity_level::error)
+      drain(false);
+    else if (r->size() > ring_size / 2)
+      m_cv.notify_one();
+  }
+};
+
+message_dispatch*
+get_dispatcher()
+{
+  static const std::string logger = xrt_core::config::get_logging();
+  static message_dispatch* dispatcher = message_dispatch::make_dispatcher(logger);
+  return dispatcher;
+}
+
+// Asynchronous logger if enabled, created on first message.  The
+// writer thread is stopped and staged messages are written at exit.
+async_logger*
+get_async_logger(message_dispatch* dispatcher)
+{
+  static async_logger* logger = [dispatcher] {
+    if (!xrt_core::config::get_logging_async())
+      return static_cast<async_logger*>(nullptr);
+
+    auto al = new async_logger(dispatcher); // NOLINT, never destroyed
+    std::atexit([] { get_async_logger(nullptr)->stop(); });
+    return al;
+  }();
+  return logger;
+}
+
 } //end unnamed namespace
 
 namespace xrt_core { namespace message {
@@ -247,16 +610,45 @@ namespace xrt_core { namespace message {
 void
 send(severity_level l, const char* tag, const char* msg)
 {
-  static const std::string logger =  xrt_core::config::get_logging();
   int ver = xrt_core::config::get_verbosity();
   int lev = static_cast<int>(l);
 
   if(ver >= lev) {
-    static message_dispatch* dispatcher = message_dispatch::make_dispatcher(logger);
-    dispatcher->send(l, tag, msg);
+    auto dispatcher = get_dispatcher();
+    if (auto logger = get_async_logger(dispatcher)) {
+      logger->send(l, tag, msg, nullptr);
+      return;
+    }
+    dispatcher->send(l, tag, msg, std::time(nullptr), std::this_thread::get_id());
+  }
+}
+
+void
+send_deferred(severity_level l, const char* tag, std::function<std::string()> formatter)
+{
+  int ver = xrt_core::config::get_verbosity();
+  int lev = static_cast<int>(l);
+
+  if(ver >= lev) {
+    auto dispatcher = get_dispatcher();
+    if (auto logger = get_async_logger(dispatcher)) {
+      logger->send(l, tag, "", std::move(formatter));
+      return;
+    }
+    dispatcher->send(l, tag, formatter().c_str(), std::time(nullptr), std::this_thread::get_id());
   }
 }
 
+void
+flush()
+{
+  if (!xrt_core::config::get_logging_async())
+    return;
+
+  if (auto logger = get_async_logger(get_dispatcher()))
+    logger->flush();
+}
+
 void
 sendv(severity_level l, const char* tag, const char* format, va_list args)
 {
@@ -20,8 +20,10 @@
 #include "core/common/config_reader.h"
 #include "core/include/xrt.h"
 #include "core/include/xrt/experimental/xrt_message.h"
-#include <string>
 #include <cstdio>
+#include <functional>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 namespace xrt_core { namespace message {
@@ -35,12 +37,41 @@ send(severity_level l, const char* tag, const char* msg);
 void
 sendv(severity_level l, const char* tag, const char* format, va_list args);
 
+// Send a message that is formatted when written.  Used with
+// asynchronous logging for messages whose arguments are values.
+XRT_CORE_COMMON_EXPORT
+void
+send_deferred(severity_level l, const char* tag, std::function<std::string()> formatter);
+
+// Write all messages sent so far.  A no-op unless logging is
+// asynchronous.
+XRT_CORE_COMMON_EXPORT
+void
+flush();
+
 inline void
 send(severity_level l, const std::string& tag, const std::string& msg)
 {
   send(l, tag.c_str(), msg.c_str());
 }
 
+namespace detail {
+
+template <typename ...Args>
+std::string
+format(const char* format, Args ... args)
+{
+  auto sz = snprintf(nullptr, 0, format, args ...);
+  if (sz < 0)
+    return "";
+
+  std::vector<char> buf(sz + 1);
+  snprintf(buf.data(), sz + 1, format, args ...);
+  return buf.data();
+}
+
+} // detail
+
 template <typename ...Args>
 void
 send(severity_level l, const char* tag, const char* format, Args ... args)
@@ -49,6 +80,15 @@ send(severity_level l, const char* tag, const char* format, Args ... args)
   int lev = static_cast<int>(l);
 
   if (ver >= lev) {
+    // Arguments that are values can be captured, so formatting is
+    // left to the logging thread
+    if constexpr ((std::is_arithmetic_v<Args> && ...)) {
+      if (xrt_core::config::get_logging_async()) {
+        send_deferred(l, tag, [fmt = std::string(format), args ...] { return detail::format(fmt.c_str(), args ...); });
+        return;
+      }
+    }
+
     auto sz = snprintf(nullptr, 0, format, args ...);
     if (sz < 0) {
       send(severity_level::error, tag, "Illegal arguments in log format string");
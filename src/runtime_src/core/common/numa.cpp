@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+#define XRT_CORE_COMMON_SOURCE
+#include "numa.h"
+#include "config_reader.h"
+#include "debug.h"
+#include "device.h"
+#include "query_requests.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+# include <pthread.h>
+# include <sched.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+namespace {
+
+namespace platform_specific {
+
+#ifdef __linux__
+
+constexpr int mpol_preferred = 1;  // MPOL_PREFERRED, numaif.h
+
+// Parse a sysfs cpu or node list, e.g. "0-15,32-47"
+static std::vector<int>
+read_list(const std::string& path)
+{
+  std::vector<int> values;
+  std::ifstream ifs(path);
+  std::string range;
+  while (std::getline(ifs, range, ',')) {
+    try {
+      auto dash = range.find('-');
+      auto first = std::stoi(range.substr(0, dash));
+      auto last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+      for (auto value = first; value <= last; ++value)
+        values.push_back(value);
+    }
+    catch (const std::exception&) {
+      // skip malformed or empty entry
+    }
+  }
+  return values;
+}
+
+static bool
+is_online(int node)
+{
+  // Placement is pointless with a single node
+  static const auto nodes = read_list("/sys/devices/system/node/online");
+  return nodes.size() > 1 && std::find(nodes.begin(), nodes.end(), node) != nodes.end();
+}
+
+static const cpu_set_t*
+get_node_cpus(int node)
+{
+  static std::mutex mutex;
+  static std::map<int, cpu_set_t> node2cpus;
+  std::lock_guard lk(mutex);
+  auto itr = node2cpus.find(node);
+  if (itr == node2cpus.end()) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (auto cpu : read_list("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"))
+      if (cpu < CPU_SETSIZE)
+        CPU_SET(cpu, &cpus);
+    itr = node2cpus.emplace(node, cpus).first;
+  }
+  return CPU_COUNT(&itr->second) ? &itr->second : nullptr;
+}
+
+static void
+set_thread_node(std::thread& thread, int node)
+{
+  static bool explicit_affinity =
+    xrt_core::config::detail::get_string_value("Runtime.cpu_affinity", "default") != "default";
+  if (explicit_affinity)
+    return;
+
+  if (auto cpus = get_node_cpus(node)) {
+    XRT_DEBUGF("numa::set_thread_node node(%d)\n", node);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), cpus);
+  }
+}
+
+static void
+bind_memory(void* addr, size_t size, int node)
+{
+  // Only pages entirely within the range, the policy of pages shared
+  // with other allocations is left alone
+  static const auto page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  auto start = (reinterpret_cast<uintptr_t>(addr) + page - 1) & ~(page - 1);
+  auto end = (reinterpret_cast<uintptr_t>(addr) + size) & ~(page - 1);
+  if (end <= start)
+    return;
+
+  constexpr size_t bits = sizeof(unsigned long) * 8;
+  std::vector<unsigned long> mask(static_cast<size_t>(node) / bits + 1, 0);
+  mask[static_cast<size_t>(node) / bits] = 1UL << (static_cast<size_t>(node) % bits);
+
+  // mbind through syscall to avoid a dependency on libnuma, the
+  // kernel expects one more than the number of bits in the mask
+  if (syscall(SYS_mbind, start, end - start, mpol_preferred, mask.data(), mask.size() * bits + 1, 0))
+    XRT_DEBUGF("numa::bind_memory size(%zu) node(%d) failed errno(%d)\n", size, node, errno);
+}
+
+#else
+
+static bool
+is_online(int)
+{
+  return false;
+}
+
+static void
+set_thread_node(std::thread&, int)
+{}
+
+static void
+bind_memory(void*, size_t, int)
+{}
+
+#endif
+
+} // platform_specific
+
+} // namespace
+
+namespace xrt_core::numa {
+
+int
+get_device_node(const device* device)
+{
+  if (!xrt_core::config::get_numa_placement() || !device)
+    return -1;
+
+  static std::mutex mutex;
+  static std::map<unsigned int, int> dev2node;
+  std::lock_guard lk(mutex);
+  auto itr = dev2node.find(device->get_device_id());
+  if (itr != dev2node.end())
+    return itr->second;
+
+  int node = -1;
+  try {
+    node = xrt_core::device_query_default<xrt_core::query::numa_node>(device, -1);
+  }
+  catch (const std::exception&) {
+    // malformed sysfs value, no placement
+  }
+
+  if (node >= 0 && !platform_specific::is_online(node))
+    node = -1;
+
+  XRT_DEBUGF("numa::get_device_node device(%u) node(%d)\n", device->get_device_id(), node);
+  dev2node.emplace(device->get_device_id(), node);
+  return node;
+}
+
+void
+set_thread_node(std::thread& thread, int node)
+{
+  if (node >= 0)
+    platform_specific::set_thread_node(thread, node);
+}
+
+void
+bind_memory(void* addr, size_t size, int node)
+{
+  if (node >= 0 && addr && size)
+    platform_specific::bind_memory(addr, size, node);
+}
+
+} // xrt_core::numa
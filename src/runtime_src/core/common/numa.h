@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrtcore_numa_h_
+#define xrtcore_numa_h_
+
+#include "config.h"
+
+#include <cstddef>
+#include <thread>
+
+// Placement of runtime threads and host memory on the host NUMA node
+// a device is attached to.  Placement is best effort, failures are
+// ignored and leave the default placement.  It is a no-op on hosts
+// with a single node, for devices that report no node, and when
+// Runtime.numa_placement is false.
+namespace xrt_core {
+
+class device;
+
+namespace numa {
+
+// Host NUMA node of the device, -1 if unknown or placement is disabled
+XRT_CORE_COMMON_EXPORT
+int
+get_device_node(const device* device);
+
+// Restrict thread to the cpus of node.  Runtime.cpu_affinity, if
+// specified, takes precedence.
+XRT_CORE_COMMON_EXPORT
+void
+set_thread_node(std::thread& thread, int node);
+
+// Prefer node for the pages within [addr, addr+size).  Must be called
+// before the memory is touched, pages that are already present stay
+// where they are.
+XRT_CORE_COMMON_EXPORT
+void
+bind_memory(void* addr, size_t size, int node);
+
+}} // numa, xrt_core
+
+#endif
@@ -333,7 +333,9 @@ enum class key_type
   noop,
 
   xocl_errors_ex,
-  xocl_ex_error_code2string
+  xocl_ex_error_code2string,
+
+  numa_node
 };
 
 struct pcie_vendor : request
@@ -514,6 +516,24 @@ struct pcie_id : request
   }
 };
 
+// Host NUMA node the device is attached to, -1 if the platform
+// does not report one
+struct numa_node : request
+{
+  using result_type = int;
+  static const key_type key = key_type::numa_node;
+  static const char* name() { return "numa_node"; }
+
+  virtual std::any
+  get(const device*) const override = 0;
+
+  static std::string
+  to_string(result_type val)
+  {
+    return std::to_string(val);
+  }
+};
+
 struct edge_vendor : request
 {
   using result_type = uint16_t;
@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <memory>
+#include <vector>
 
 namespace xrt_core {
 
@@ -103,6 +104,25 @@ public:
   {
     throw xrt_core::error(std::errc::not_supported, __func__);
   }
+
+  // sync_range - range of a buffer in a batched sync
+  struct sync_range
+  {
+    buffer_handle* bo;
+    direction dir;
+    size_t size;
+    size_t offset;
+  };
+
+  // Sync ranges of this and other buffers of the same device.  Shims
+  // that can sync several buffers in one driver call override this,
+  // the default syncs one range at a time.
+  virtual void
+  sync_batch(const std::vector<sync_range>& ranges)
+  {
+    for (const auto& range : ranges)
+      range.bo->sync(range.dir, range.size, range.offset);
+  }
 };
 
 } // xrt_core
@@ -84,6 +84,23 @@ public:
   {
     throw std::runtime_error("not supported");
   }
+
+  // Return the max number of commands that can be chained in one
+  // ERT_CMD_CHAIN command, or 0 if the queue doesn't know its limit.
+  virtual size_t
+  get_max_chain_size() const
+  {
+    return 0;
+  }
+
+  // Return true if this queue implements submit_wait() and
+  // submit_signal().  Users of a queue that does not support fences
+  // must resolve dependencies on the host.
+  virtual bool
+  has_fence_support() const
+  {
+    return false;
+  }
 };
 
 } // xrt_core
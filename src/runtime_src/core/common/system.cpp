@@ -5,7 +5,9 @@
 // Local - Include Files
 #include "system.h"
 #include "device.h"
+#include "message.h"
 #include "module_loader.h"
+#include "core/common/api/bo_int.h"
 
 #include "gen/version.h"
 
@@ -120,8 +122,14 @@ get_userpf_device(device::id_type id)
 
   // Repackage raw ptr in new shared ptr with deleter that calls xclClose,
   // but leaves device object alone. The returned device is managed in that
-  // it calls xclClose when going out of scope.
-  auto close = [] (xrt_core::device* d) { d->close_device(); };
+  // it calls xclClose when going out of scope.  Cached buffer
+  // registrations of the device are released before it is closed,
+  // and asynchronously logged messages are written.
+  auto close = [] (xrt_core::device* d) {
+    xrt_core::bo_int::finish(d);
+    xrt_core::message::flush();
+    d->close_device();
+  };
   std::shared_ptr<xrt_core::device> ptr{device.get(), close};
 
   // The repackage raw ptr is the one that should be cached so
@@ -86,6 +86,11 @@ get_hw_queue(xclDeviceHandle handle, xrt_core::hwctx_handle* ctxhdl);
 void
 register_xclbin(xclDeviceHandle handle, const xrt::xclbin& xclbin);
 
+// create_fence() - Create a fence for synchronizing hw queues,
+// this function is implemented only in noop shim
+std::unique_ptr<xrt_core::fence_handle>
+create_fence(xclDeviceHandle handle, xrt::fence::access_mode access);
+
 // submit_command() -
 void
 submit_command(xclDeviceHandle handle, xrt_core::hwqueue_handle* qhdl, xrt_core::buffer_handle* cmdbo);
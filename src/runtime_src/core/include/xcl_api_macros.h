@@ -28,7 +28,25 @@ std::lock_guard<std::mutex> socketlk{mtx};
     func_name##_response r_msg; \
     SCOPE_GUARD_MUTEX()
 
-#if GOOGLE_PROTOBUF_VERSION < 3006001
+#if defined(XCL_EM_RPC_CHANNEL)
+// Shim sends through its xclemulation::rpc_channel (rpc_channel.h)
+#define SERIALIZE_AND_SEND_MSG(func_name)                               \
+    if (!mRpc.call(&*_s_inst, func_name##_n, c_msg, r_msg)) { if (mLogStream.is_open()) mLogStream << __func__ << "\n RPC failed, sk_read/sk_write failed, so exit the application now!"; exit(0); }
+
+// Request whose response is not needed, r_msg is not set.  The
+// response is checked with func_name##_POST_SUCCEEDED(r) and a
+// failure is reported at the next synchronous call.
+#define SERIALIZE_AND_POST_MSG(func_name,batchable)                     \
+    if (!mRpc.post(&*_s_inst, func_name##_n, c_msg, batchable,          \
+                   [](const void* data, size_t len) {                   \
+                     using status = xclemulation::rpc_channel::response_status; \
+                     func_name##_response r;                            \
+                     if (!r.ParseFromArray(data, static_cast<int>(len))) \
+                       return status::malformed;                        \
+                     return func_name##_POST_SUCCEEDED(r) ? status::ok : status::failed; \
+                   }))                                                  \
+    { if (mLogStream.is_open()) mLogStream << __func__ << "\n RPC failed, sk_read/sk_write failed, so exit the application now!"; exit(0); }
+#elif GOOGLE_PROTOBUF_VERSION < 3006001
 // Use the deprecated 32 bit version of the size
 #define SERIALIZE_AND_SEND_MSG(func_name)                               \
     auto c_len = c_msg.ByteSize();                                      \
@@ -79,6 +97,10 @@ std::lock_guard<std::mutex> socketlk{mtx};
     assert(true == rv);
 #endif
 
+#ifndef SERIALIZE_AND_POST_MSG
+#define SERIALIZE_AND_POST_MSG(func_name,batchable) SERIALIZE_AND_SEND_MSG(func_name)
+#endif
+
 #define xclSetEnvironment_SET_PROTOMESSAGE() \
   for (auto i : mEnvironmentNameValueMap) \
   { \
@@ -195,6 +217,13 @@ std::lock_guard<std::mutex> socketlk{mtx};
     xclWriteAddrSpaceDeviceRam_SET_PROTO_RESPONSE(); \
     xclWriteAddrSpaceDeviceRam_RETURN();
 
+#define xclWriteAddrSpaceDeviceRam_POST_SUCCEEDED(r) r.valid()
+
+#define xclWriteAddrSpaceDeviceRam_RPC_POST(func_name,address_space,address,data,size,pf_id,bar_id) \
+    RPC_PROLOGUE(func_name); \
+    xclWriteAddrSpaceDeviceRam_SET_PROTOMESSAGE(func_name,address_space,address,data,size,pf_id,bar_id); \
+    SERIALIZE_AND_POST_MSG(func_name,true)
+
 //--------------------xclWriteAddrKernelCtrl--------------------------------
 //Generate call and info message
 #define xclWriteAddrKernelCtrl_SET_PROTOMESSAGE(func_name,address_space,addr,data,size,kernelArgsInfo,pf_id,bar_id) \
@@ -226,6 +255,13 @@ std::lock_guard<std::mutex> socketlk{mtx};
     xclWriteAddrKernelCtrl_SET_PROTO_RESPONSE(); \
     xclWriteAddrKernelCtrl_RETURN();
 
+#define xclWriteAddrKernelCtrl_POST_SUCCEEDED(r) r.valid()
+
+#define xclWriteAddrKernelCtrl_RPC_POST(func_name,address_space,address,data,size,kernelArgsInfo,pf_id,bar_id) \
+    RPC_PROLOGUE(func_name); \
+    xclWriteAddrKernelCtrl_SET_PROTOMESSAGE(func_name,address_space,address,data,size,kernelArgsInfo,pf_id,bar_id); \
+    SERIALIZE_AND_POST_MSG(func_name,false)
+
 //--------------------xclRegWrite--------------------------------
 //Generate call and info message
 #define xclRegWrite_SET_PROTOMESSAGE(func_name,baseaddress,offset,data,pf_id,bar_id) \
@@ -365,6 +401,14 @@ std::lock_guard<std::mutex> socketlk{mtx};
     xclCopyBufferHost2Device_SET_PROTO_RESPONSE(); \
     xclCopyBufferHost2Device_RETURN();
 
+// The response carries no status, only the copied size
+#define xclCopyBufferHost2Device_POST_SUCCEEDED(r) true
+
+#define xclCopyBufferHost2Device_RPC_POST(func_name,dev_handle,dest,src,size,seek,space) \
+    RPC_PROLOGUE(func_name); \
+    xclCopyBufferHost2Device_SET_PROTOMESSAGE(func_name,dev_handle,dest,src,size,seek,space); \
+    SERIALIZE_AND_POST_MSG(func_name,true)
+
 //-----------xclCopyBufferDevice2Host-----------------
 #define xclCopyBufferDevice2Host_SET_PROTOMESSAGE(func_name,dev_handle,dest,src,size,skip,space) \
     c_msg.set_xcldevicehandle((char*)dev_handle); \
@@ -1033,3 +1077,21 @@ std::lock_guard<std::mutex> socketlk{mtx};
   SERIALIZE_AND_SEND_MSG(func_name)                     \
   swemuDriverVersion_SET_PROTO_RESPONSE();              
 
+#define swemuSetupDataPlane_SET_PROTOMESSAGE(regions)   \
+  for (auto& it : regions)                              \
+  {                                                     \
+    auto region = c_msg.add_regions();                  \
+    region->set_path(it.path);                          \
+    region->set_base(it.base);                          \
+    region->set_size(it.size);                          \
+  }
+
+#define swemuSetupDataPlane_SET_PROTO_RESPONSE()        \
+  success = r_msg.success();
+
+#define swemuSetupDataPlane_RPC_CALL(func_name, regions) \
+  RPC_PROLOGUE(func_name);                              \
+  swemuSetupDataPlane_SET_PROTOMESSAGE(regions);        \
+  SERIALIZE_AND_SEND_MSG(func_name)                     \
+  swemuSetupDataPlane_SET_PROTO_RESPONSE();
+
@@ -83,5 +83,7 @@
 #define xclRegWrite_n 51
 #define xclRegRead_n 52
 #define swemuDriverVersion_n 53
+#define swemuSetupDataPlane_n 54
+#define xclBatch_n 55
 
 #endif
@@ -231,6 +231,190 @@ public:
   /// @endcond
 };
 
+/*!
+ * @class bo_arena
+ *
+ * @brief Sub-allocating buffer arena
+ *
+ * @details
+ * A buffer arena reserves large buffer objects (slabs) in one memory
+ * group and hands out page aligned sub-buffers from them.  Allocating
+ * and releasing a buffer from the arena does not call the driver
+ * except when a new slab must be reserved.
+ *
+ * Slabs are carved into blocks of power of two size classes.  The
+ * free blocks are kept by the arena in a small number of locked
+ * shards, and each thread allocates from and releases to the shard
+ * selected by its thread id.  Threads contend only when they map to
+ * the same shard, or when their own shard is empty and blocks are
+ * taken from the other shards.  A block released by a thread that
+ * exits stays with the arena.  Requests larger than the biggest size
+ * class are allocated as regular buffer objects.
+ *
+ * A buffer returned by the arena is an ordinary sub-buffer and can be
+ * used as a kernel argument, synced, and mapped.  The buffer returns
+ * its block to the arena when the last reference is released.  The
+ * slabs are freed when the arena and all buffers allocated from it
+ * are released.
+ */
+class bo_arena_impl;
+class bo_arena : public detail::pimpl<bo_arena_impl>
+{
+public:
+  /**
+   * @struct stats - arena statistics
+   *
+   * @var slabs
+   *   Number of slabs reserved by the arena
+   * @var reserved
+   *   Total size in bytes of all slabs
+   * @var allocations
+   *   Number of buffers allocated from slabs
+   * @var outstanding
+   *   Number of buffers allocated from slabs and not yet released
+   * @var oversize
+   *   Number of buffers too large for the arena, allocated as
+   *   regular buffer objects
+   */
+  struct stats
+  {
+    size_t slabs;
+    size_t reserved;
+    size_t allocations;
+    size_t outstanding;
+    size_t oversize;
+  };
+
+  /**
+   * bo_arena() - Construct empty arena
+   */
+  bo_arena() = default;
+
+  /**
+   * bo_arena() - Constructor for arena of buffers in a memory group
+   *
+   * @param device
+   *  The device on which to allocate slabs
+   * @param flags
+   *  Buffer flags used for all slabs
+   * @param grp
+   *  Memory group of the slabs, typically kernel.group_id(argno)
+   * @param slab_size
+   *  Size of each slab in bytes, 0 for implementation default
+   */
+  XRT_API_EXPORT
+  bo_arena(const xrt::device& device, xrt::bo::flags flags, xrt::memory_group grp, size_t slab_size = 0);
+
+  /**
+   * bo_arena() - Constructor for arena of buffers in a hardware context
+   *
+   * @param hwctx
+   *  The hardware context in which slabs are allocated
+   * @param flags
+   *  Buffer flags used for all slabs
+   * @param grp
+   *  Memory group of the slabs, typically kernel.group_id(argno)
+   * @param slab_size
+   *  Size of each slab in bytes, 0 for implementation default
+   */
+  XRT_API_EXPORT
+  bo_arena(const xrt::hw_context& hwctx, xrt::bo::flags flags, xrt::memory_group grp, size_t slab_size = 0);
+
+  /**
+   * alloc() - Allocate a buffer from the arena
+   *
+   * @param sz
+   *  Size of buffer
+   * @return
+   *  Sub-buffer of an arena slab, or a regular buffer object if
+   *  the size exceeds the largest size class of the arena.
+   */
+  XRT_API_EXPORT
+  xrt::bo
+  alloc(size_t sz);
+
+  /**
+   * get_stats() - Get current arena statistics
+   */
+  XRT_API_EXPORT
+  stats
+  get_stats() const;
+};
+
+/*!
+ * @class userptr_cache
+ *
+ * @brief Registration cache for user pointer buffers
+ *
+ * @details
+ * Creating a buffer object from a user pointer pins the user memory
+ * with the driver, and destroying the buffer unpins it again.  When
+ * the cache is enabled (xrt.ini Runtime.userptr_cache_mb), the pinned
+ * registration outlives the buffer object and is reused by a later
+ * buffer created from the same pointer, size, device, flags, and
+ * memory group.  Unused registrations are unpinned least recently
+ * used first when their total size exceeds the configured limit,
+ * and all registrations of a device or hardware context are unpinned
+ * when the device is closed or the hardware context is destroyed.
+ *
+ * The driver cannot see when the application frees user memory, so
+ * with the cache enabled the application must invalidate the freed
+ * range before freeing it, otherwise a later allocation at the same
+ * address could reuse a stale registration.
+ */
+class userptr_cache
+{
+public:
+  /**
+   * @struct stats - cache statistics
+   *
+   * @var hits
+   *   Number of user pointer buffers that reused a registration
+   * @var misses
+   *   Number of user pointer buffers that pinned memory
+   * @var invalidations
+   *   Number of registrations removed by invalidate()
+   * @var evictions
+   *   Number of unused registrations unpinned to honor the size limit
+   * @var pinned_bytes
+   *   Total size of registrations, used and unused
+   * @var cached_bytes
+   *   Total size of unused registrations
+   */
+  struct stats
+  {
+    size_t hits;
+    size_t misses;
+    size_t invalidations;
+    size_t evictions;
+    size_t pinned_bytes;
+    size_t cached_bytes;
+  };
+
+  /**
+   * invalidate() - Remove registrations overlapping a user memory range
+   *
+   * @param userptr
+   *  Start of user memory range
+   * @param sz
+   *  Size of user memory range
+   *
+   * Unused registrations are unpinned immediately.  Registrations
+   * still used by buffer objects are no longer reused and are
+   * unpinned when the last buffer using them is destroyed.
+   */
+  XRT_API_EXPORT
+  static void
+  invalidate(const void* userptr, size_t sz);
+
+  /**
+   * get_stats() - Get current cache statistics
+   */
+  XRT_API_EXPORT
+  static stats
+  get_stats();
+};
+
 
 class kernel : public xrt::kernel
 {
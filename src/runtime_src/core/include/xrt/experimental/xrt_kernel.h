@@ -12,6 +12,7 @@
 # include "xrt/detail/pimpl.h"
 # include <chrono>
 # include <condition_variable>
+# include <cstddef>
 #endif
 
 #ifdef __cplusplus
@@ -243,6 +244,128 @@ public:
   reset();
 };
 
+/**
+ * class command_graph - Run objects with dependencies across contexts
+ *
+ * A command graph is a set of run objects, possibly from kernels in
+ * different hardware contexts, with dependencies between them.  The
+ * entire graph is submitted by one call to execute().  A run object
+ * starts when all run objects it depends on have completed.
+ *
+ * When all run objects are in hardware queues of the same device
+ * that support fences, the graph is submitted with a fence for each
+ * dependency, and the dependencies are enforced by the device.  The
+ * host is not involved until the graph has completed.
+ *
+ * Otherwise the dependencies are resolved on the host by a helper
+ * thread owned by the graph, which starts run objects as it is
+ * notified of the completion of their dependencies.  The application
+ * thread is still not woken up between the stages of the graph.
+ *
+ * It is undefined behavior to explicitly start a run object that is
+ * part of an executing graph, or to modify the graph while it is
+ * executing.
+ */
+class command_graph_impl;
+class command_graph : public detail::pimpl<command_graph_impl>
+{
+public:
+  /**
+   * node - Identifies a run object in the graph
+   */
+  using node = size_t;
+
+  /**
+   * command_graph() - Construct an empty graph
+   */
+  XRT_API_EXPORT
+  command_graph();
+
+  /**
+   * ~command_graph() - Destructor
+   *
+   * When the last reference to the graph is destroyed, the graph
+   * waits for an executing graph to complete, without checking run
+   * object states.
+   */
+  XRT_API_EXPORT
+  ~command_graph();
+
+  /**
+   * add() - Add a run object to the graph
+   *
+   * @param run
+   *  Run object to add, its arguments are used as set at the
+   *  time the graph is executed
+   * @return
+   *  Node identifying the run object in the graph
+   *
+   * Throws if the run object is already part of the graph.
+   */
+  XRT_API_EXPORT
+  node
+  add(const xrt::run& run);
+
+  /**
+   * add_dependency() - Make one node wait for another
+   *
+   * @param before
+   *  Node that must complete first
+   * @param after
+   *  Node that starts when before (and all its other dependencies)
+   *  have completed
+   *
+   * Throws if either node is not part of the graph or if the
+   * dependency would create a cycle.
+   */
+  XRT_API_EXPORT
+  void
+  add_dependency(node before, node after);
+
+  /**
+   * execute() - Submit the graph for execution
+   *
+   * Executing an empty graph is a no-op.
+   *
+   * Throws if the graph is already executing.
+   */
+  XRT_API_EXPORT
+  void
+  execute();
+
+  /**
+   * wait() - Wait for the graph to complete
+   *
+   * @param timeout
+   *  Timeout for wait.  A value of 0, implies block until all run
+   *  objects have completed.
+   * @return
+   *  std::cv_status::no_timeout if all run objects have completed,
+   *  std::cv_status::timeout if the timeout expired first.
+   *
+   * Throws ``xrt::run::command_error`` for the first run object that
+   * failed to start or to complete successfully.  After a failure no
+   * further run objects of the graph are started, but run objects
+   * already started are waited for.  When the device enforces the
+   * dependencies, run objects that depend on a run object that failed
+   * to complete are still executed by the device.
+   */
+  XRT_API_EXPORT
+  std::cv_status
+  wait(const std::chrono::milliseconds& timeout) const;
+
+  /**
+   * wait() - Wait for the graph to complete
+   *
+   * Convenience method that calls wait() with a timeout of 0.
+   */
+  void
+  wait() const
+  {
+    wait(std::chrono::milliseconds(0));
+  }
+};
+
 } // namespace xrt
 
 #endif // __cplusplus
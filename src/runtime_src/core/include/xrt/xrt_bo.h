@@ -11,6 +11,7 @@
 
 #ifdef __cplusplus
 # include <memory>
+# include <vector>
 #endif
 
 /**
@@ -746,6 +747,67 @@ public:
     copy(src, src.size());
   }
 
+  /**
+   * copy_async() - Start deep copy of BO content from another buffer
+   *
+   * @param src
+   *  Source BO to copy from
+   * @param sz
+   *  Size of data to copy
+   * @param src_offset
+   *  Offset into src buffer copy from
+   * @param dst_offset
+   *  Offset into this buffer to copy to
+   * @return
+   *  Handle to wait on for completion of the copy
+   *
+   * The copy is performed as by copy(), but in the background.
+   * Both buffers are kept alive until the copy completes.  Errors
+   * from the copy are thrown when waiting on the returned handle.
+   */
+  XCL_DRIVER_DLLESPEC
+  async_handle
+  copy_async(const bo& src, size_t sz, size_t src_offset=0, size_t dst_offset=0);
+
+  /**
+   * @struct sync_range - range of a buffer to sync in a batch
+   *
+   * See sync_batch()
+   */
+  struct sync_range;
+
+  /**
+   * sync_batch() - Synchronize ranges of multiple buffers
+   *
+   * @param ranges
+   *  Buffer ranges with direction to synchronize
+   *
+   * Synchronizes all ranges as if by calling sync() on each, but
+   * ranges that overlap or are adjacent within the same buffer (or
+   * sub-buffers of the same buffer) and direction are merged, and
+   * the remaining ranges are passed to the driver in as few calls as
+   * it supports.  Throws if any range is out of bounds.
+   */
+  XCL_DRIVER_DLLESPEC
+  static void
+  sync_batch(const std::vector<sync_range>& ranges);
+
+  /**
+   * sync_batch_async() - Start synchronization of multiple buffers
+   *
+   * @param ranges
+   *  Buffer ranges with direction to synchronize
+   * @return
+   *  Handle to wait on for completion of all ranges
+   *
+   * The synchronization is performed as by sync_batch(), but in the
+   * background.  Errors are thrown when waiting on the returned
+   * handle.  Throws if ranges is empty.
+   */
+  XCL_DRIVER_DLLESPEC
+  static async_handle
+  sync_batch_async(std::vector<sync_range> ranges);
+
   /**
    * ~bo() - Destructor for bo object
    */
@@ -773,6 +835,29 @@ private:
   std::shared_ptr<bo_impl> handle;
 };
 
+/*!
+ * @struct bo::sync_range
+ *
+ * @brief
+ * Range of a buffer to synchronize with bo::sync_batch()
+ *
+ * @var buffer
+ *   Buffer to synchronize
+ * @var dir
+ *   To device or from device
+ * @var size
+ *   Size of data to synchronize
+ * @var offset
+ *   Offset within the buffer
+ */
+struct bo::sync_range
+{
+  bo buffer;
+  xclBOSyncDirection dir;
+  size_t size;
+  size_t offset;
+};
+
 } // namespace xrt
 
 /// @cond
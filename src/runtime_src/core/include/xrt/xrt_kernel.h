@@ -17,6 +17,7 @@
 # include "xrt/experimental/xrt_exception.h"
 # include "xrt/experimental/xrt_fence.h"
 # include "xrt/experimental/xrt_hw_context.h"
+# include <array>
 # include <chrono>
 # include <condition_variable>
 # include <cstdint>
@@ -530,6 +531,23 @@ public:
     set_arg(index, std::forward<ArgType>(argvalue));
   }
 
+  /**
+   * set_args() - Set all kernel arguments for this run
+   *
+   * @param args
+   *  Kernel arguments in argument index order, starting at index 0
+   *
+   * Same as calling ``set_arg()`` for each argument in turn, but
+   * all arguments are set in one call into the runtime.
+   */
+  template<typename ...Args>
+  void
+  set_args(Args&&... args)
+  {
+    const std::array<arg_value, sizeof...(Args)> values {make_arg_value(std::forward<Args>(args))...};
+    set_args_at_index(values.data(), values.size());
+  }
+
   /**
    * udpdate_arg() - Asynchronous update of scalar kernel global argument
    *
@@ -582,7 +600,7 @@ public:
   void
   operator() (Args&&... args)
   {
-    set_arg(0, std::forward<Args>(args)...);
+    set_args(std::forward<Args>(args)...);
     start();
   }
 
@@ -610,12 +628,21 @@ public:
   void
   operator() (autostart&& count, Args&&... args)
   {
-    set_arg(0, std::forward<Args>(args)...);
+    set_args(std::forward<Args>(args)...);
     start(count);
   }
 
 public:
   /// @cond
+  // Argument value passed to set_args_at_index(), either a
+  // global buffer or a scalar value
+  struct arg_value
+  {
+    const xrt::bo* bo;
+    const void* value;
+    size_t bytes;
+  };
+
   const std::shared_ptr<run_impl>&
   get_handle() const
   {
@@ -672,12 +699,34 @@ private:
   void
   update_arg_at_index(int index, const xrt::bo&);
 
-  template<typename ArgType, typename ...Args>
+  XCL_DRIVER_DLLESPEC
   void
-  set_arg(int argno, ArgType&& arg, Args&&... args)
+  set_args_at_index(const arg_value* values, size_t count);
+
+  // Overloads match those of set_arg()
+  template <typename ArgType>
+  static arg_value
+  make_arg_value(ArgType&& arg)
+  {
+    return {nullptr, &arg, sizeof(arg)};
+  }
+
+  static arg_value
+  make_arg_value(xrt::bo& boh)
+  {
+    return {&boh, nullptr, 0};
+  }
+
+  static arg_value
+  make_arg_value(const xrt::bo& boh)
+  {
+    return {&boh, nullptr, 0};
+  }
+
+  static arg_value
+  make_arg_value(xrt::bo&& boh)
   {
-    set_arg(argno, std::forward<ArgType>(arg));
-    set_arg(++argno, std::forward<Args>(args)...);
+    return {&boh, nullptr, 0};
   }
 };
 
@@ -240,7 +240,9 @@ namespace xclemulation{
       {
         setKeepRunDir(getBoolValue(value,true));
       }
-      else if (name == "enable_prep_target" || name == "enable_debug" || name == "aie_sim_options") {
+      else if (name == "enable_prep_target" || name == "enable_debug" || name == "aie_sim_options"
+               || name == "sw_emu_shared_memory" || name == "rpc_pipeline_depth"
+               || name == "rpc_batch_size" || name == "rpc_latency_stats") {
         //Do nothing: Added to bypass the WARNING that is issued below stating "invalid xrt.ini option" 
       }
       else if(name == "sim_dir")
@@ -0,0 +1,300 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+#include "rpc_channel.h"
+#include "xcl_macros.h"
+
+#include "core/common/config_reader.h"
+#include "core/common/message.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <utility>
+
+namespace {
+
+// Bound on outstanding posted requests, keeps the unread responses
+// well within the socket buffer so that the device process never
+// blocks on writing a response while the shim blocks on writing a
+// request
+constexpr size_t max_depth = 256;
+
+// Posted requests larger than this are not batched
+constexpr size_t max_batch_entry = 4096;
+
+size_t
+byte_size(const google::protobuf::MessageLite& msg)
+{
+#if GOOGLE_PROTOBUF_VERSION < 3006001
+  return msg.ByteSize();
+#else
+  return msg.ByteSizeLong();
+#endif
+}
+
+} // namespace
+
+namespace xclemulation {
+
+rpc_channel::
+rpc_channel()
+  : m_depth(std::min<size_t>(xrt_core::config::get_emulation_rpc_pipeline_depth(), max_depth))
+  , m_batch_size(xrt_core::config::get_emulation_rpc_batch_size())
+{
+  // Size of response header as sent by the device process
+  response_packet_info ri;
+  ri.set_size(0);
+  m_response_header_size = byte_size(ri);
+}
+
+bool
+rpc_channel::
+send(unix_socket* sock, uint32_t api, const google::protobuf::MessageLite& msg)
+{
+  m_call.clear();
+  if (!msg.SerializeToString(&m_call))
+    return false;
+
+  call_packet_info ci;
+  ci.set_size(m_call.size());
+  ci.set_xcl_api(api);
+  m_header.resize(byte_size(ci));
+  if (!ci.SerializeToArray(m_header.data(), static_cast<int>(m_header.size())))
+    return false;
+
+  return sock->sk_write(m_header.data(), m_header.size()) == static_cast<ssize_t>(m_header.size())
+    && sock->sk_write(m_call.data(), m_call.size()) == static_cast<ssize_t>(m_call.size());
+}
+
+bool
+rpc_channel::
+receive(unix_socket* sock)
+{
+  m_header.resize(m_response_header_size);
+  if (sock->sk_read(m_header.data(), m_header.size()) != static_cast<ssize_t>(m_header.size()))
+    return false;
+
+  response_packet_info ri;
+  if (!ri.ParseFromArray(m_header.data(), static_cast<int>(m_header.size())))
+    return false;
+
+  m_payload.resize(ri.size());
+  return m_payload.empty()
+    || sock->sk_read(m_payload.data(), m_payload.size()) == static_cast<ssize_t>(m_payload.size());
+}
+
+rpc_channel::api_stats&
+rpc_channel::
+stats(uint32_t api, const google::protobuf::MessageLite& msg)
+{
+  auto& st = m_stats[api];
+  if (st.name.empty()) {
+    st.name = msg.GetTypeName();
+    if (auto pos = st.name.rfind("_call"); pos != std::string::npos)
+      st.name.erase(pos);
+  }
+  return st;
+}
+
+void
+rpc_channel::
+record(const request& req, bool ok, uint64_t api_stats::* counter)
+{
+  auto ns = static_cast<uint64_t>
+    (std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - req.start).count());
+  auto& st = m_stats[req.api];
+  ++(st.*counter);
+  st.total_ns += ns;
+  st.max_ns = std::max(st.max_ns, ns);
+  if (!ok)
+    ++st.failed;
+}
+
+// Check the response of a posted request.  A request that failed in
+// the device process is remembered for report_post_errors().  Returns
+// false if the response is malformed.
+bool
+rpc_channel::
+check_response(const request& req, const void* data, size_t size, uint64_t api_stats::* counter)
+{
+  auto status = req.check(data, size);
+  record(req, status == response_status::ok, counter);
+  if (status == response_status::failed && !m_post_errors++) {
+    m_first_error_seq = req.seq;
+    m_first_error_api = req.api;
+  }
+  return status != response_status::malformed;
+}
+
+void
+rpc_channel::
+report_post_errors()
+{
+  if (!m_post_errors)
+    return;
+
+  auto errors = std::exchange(m_post_errors, 0);
+  xrt_core::message::send(xrt_core::message::severity_level::error, "XRT",
+                          std::to_string(errors) + " posted emulation request(s) failed in the device process, first "
+                          + m_stats[m_first_error_api].name + " (request " + std::to_string(m_first_error_seq) + ")");
+}
+
+bool
+rpc_channel::
+call(unix_socket* sock, uint32_t api, const google::protobuf::MessageLite& msg,
+     google::protobuf::MessageLite& response)
+{
+  if (!drain())
+    return false;
+
+  stats(api, msg);
+  request req{m_seq++, api, nullptr, clock::now(), {}};
+  auto ok = send(sock, api, msg) && receive(sock)
+    && response.ParseFromArray(m_payload.data(), static_cast<int>(m_payload.size()));
+  record(req, ok, &api_stats::calls);
+  return ok;
+}
+
+bool
+rpc_channel::
+post_request(uint32_t api, const google::protobuf::MessageLite& msg,
+             response_checker check, std::vector<request> batch)
+{
+  // Make room for one more outstanding request
+  while (m_outstanding.size() >= m_depth)
+    if (!complete_oldest())
+      return false;
+
+  m_outstanding.push_back({m_seq++, api, check, clock::now(), std::move(batch)});
+  return send(m_sock, api, msg);
+}
+
+bool
+rpc_channel::
+complete_oldest()
+{
+  auto req = std::move(m_outstanding.front());
+  m_outstanding.pop_front();
+  if (!receive(m_sock))
+    return false;
+
+  if (req.batch.empty())
+    return check_response(req, m_payload.data(), m_payload.size(), &api_stats::posted);
+
+  // Responses of a batch are in the order of the batched requests
+  xclBatch_response response;
+  auto ok = response.ParseFromArray(m_payload.data(), static_cast<int>(m_payload.size()))
+    && static_cast<size_t>(response.responses_size()) == req.batch.size();
+  record(req, ok, &api_stats::posted);
+  for (size_t idx = 0; idx < req.batch.size(); ++idx) {
+    auto& entry = req.batch[idx];
+    if (ok && response.responses(idx).seq() == entry.seq) {
+      auto& data = response.responses(idx).response();
+      ok = check_response(entry, data.data(), data.size(), &api_stats::batched);
+      continue;
+    }
+    record(entry, false, &api_stats::batched);
+    ok = false;
+  }
+  return ok;
+}
+
+bool
+rpc_channel::
+flush_batch()
+{
+  if (m_batched.empty())
+    return true;
+
+  auto batched = std::move(m_batched);
+  m_batched.clear();
+  stats(xclBatch_n, m_batch);
+  auto ok = post_request(xclBatch_n, m_batch, nullptr, std::move(batched));
+  m_batch.Clear();
+  return ok;
+}
+
+bool
+rpc_channel::
+post(unix_socket* sock, uint32_t api, const google::protobuf::MessageLite& msg,
+     bool batchable, response_checker check)
+{
+  auto& st = stats(api, msg);
+
+  if (!m_depth) {
+    request req{m_seq++, api, check, clock::now(), {}};
+    if (!send(sock, api, msg) || !receive(sock)) {
+      record(req, false, &api_stats::calls);
+      return false;
+    }
+    return check_response(req, m_payload.data(), m_payload.size(), &api_stats::calls);
+  }
+
+  // Outstanding requests on another socket are completed first
+  if (m_sock != sock && !drain())
+    return false;
+  m_sock = sock;
+
+  if (batchable && m_batch_size && byte_size(msg) <= max_batch_entry) {
+    auto entry = m_batch.add_requests();
+    entry->set_seq(m_seq);
+    entry->set_xcl_api(api);
+    if (!msg.SerializeToString(entry->mutable_call())) {
+      ++st.failed;
+      return false;
+    }
+    m_batched.push_back({m_seq++, api, check, clock::now(), {}});
+    return m_batched.size() < m_batch_size || flush_batch();
+  }
+
+  return flush_batch() && post_request(api, msg, check, {});
+}
+
+bool
+rpc_channel::
+drain()
+{
+  if (!flush_batch())
+    return false;
+
+  while (!m_outstanding.empty())
+    if (!complete_oldest())
+      return false;
+
+  report_post_errors();
+  return true;
+}
+
+void
+rpc_channel::
+reset()
+{
+  m_outstanding.clear();
+  m_batched.clear();
+  m_batch.Clear();
+  m_sock = nullptr;
+  m_post_errors = 0;
+}
+
+void
+rpc_channel::
+print_stats(std::ostream& ostr) const
+{
+  ostr << "RPC latency statistics (us)\n"
+       << std::left << std::setw(40) << "request"
+       << std::right << std::setw(10) << "calls" << std::setw(10) << "posted"
+       << std::setw(10) << "batched" << std::setw(10) << "failed"
+       << std::setw(12) << "mean" << std::setw(12) << "max" << '\n';
+  for (const auto& [api, st] : m_stats) {
+    auto count = st.calls + st.posted + st.batched;
+    if (!count)
+      continue;
+    ostr << std::left << std::setw(40) << st.name
+         << std::right << std::setw(10) << st.calls << std::setw(10) << st.posted
+         << std::setw(10) << st.batched << std::setw(10) << st.failed
+         << std::fixed << std::setprecision(1)
+         << std::setw(12) << st.total_ns / 1000.0 / count
+         << std::setw(12) << st.max_ns / 1000.0 << '\n';
+  }
+}
+
+} // xclemulation
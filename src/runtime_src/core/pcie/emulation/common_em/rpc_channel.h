@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef _EM_RPC_CHANNEL_H_
+#define _EM_RPC_CHANNEL_H_
+
+#include "rpc_messages.pb.h"
+#include "unix_socket.h"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Shims with an rpc_channel member mRpc send all RPC calls through
+// it, see SERIALIZE_AND_SEND_MSG in xcl_api_macros.h
+#define XCL_EM_RPC_CHANNEL
+
+namespace xclemulation {
+
+// class rpc_channel - Request/response transport of an emulation shim
+//
+// A request is a call_packet_info header followed by the serialized
+// call message, and the device process sends one response per
+// request, in order.
+//
+// call() sends a request and waits for its response.  post() sends a
+// request whose response the caller does not need, without waiting
+// for the response.  Up to Emulation.rpc_pipeline_depth posted
+// requests are outstanding, their responses are read and checked
+// before the next call() is sent, so the device process observes all
+// requests in the order they were issued.  With a depth of 0, which
+// is the default, post() waits for the response like call().
+//
+// A posted request that the device process reports as failed is not
+// a transport failure, it is reported as an error message by the
+// next call() or drain(), which is where the shim synchronizes with
+// the device process.
+//
+// With Emulation.rpc_batch_size, consecutive small posted requests
+// that are marked batchable are sent as one xclBatch request once the
+// batch is full or before any other request.  This requires support
+// for xclBatch in the device process.
+//
+// Each request is identified by a sequence number, latency is
+// measured from issue to response per request type.
+//
+// The channel is not thread safe, the shim serializes RPC calls.
+class rpc_channel
+{
+public:
+  // Result of checking the response of a posted request
+  enum class response_status { ok, failed, malformed };
+
+  // Parse a response payload and check its success field
+  using response_checker = response_status (*)(const void* data, size_t size);
+
+  rpc_channel();
+
+  // Send request and wait for the response, false on transport
+  // failure or malformed response.  Reports posted requests that
+  // failed in the device process.
+  bool
+  call(unix_socket* sock, uint32_t api, const google::protobuf::MessageLite& msg,
+       google::protobuf::MessageLite& response);
+
+  // Send request without waiting for the response, false on
+  // transport failure or if a response read meanwhile is malformed
+  bool
+  post(unix_socket* sock, uint32_t api, const google::protobuf::MessageLite& msg,
+       bool batchable, response_checker check);
+
+  // Send pending batch and read all outstanding responses.  Reports
+  // posted requests that failed in the device process.
+  bool
+  drain();
+
+  // Forget outstanding requests, used when the socket is closed
+  void
+  reset();
+
+  // Print per request type latency statistics
+  void
+  print_stats(std::ostream& ostr) const;
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  struct request
+  {
+    uint64_t seq;
+    uint32_t api;
+    response_checker check;
+    clock::time_point start;
+    std::vector<request> batch;  // requests sent in an xclBatch request
+  };
+
+  struct api_stats
+  {
+    std::string name;
+    uint64_t calls = 0;
+    uint64_t posted = 0;
+    uint64_t batched = 0;
+    uint64_t failed = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+  };
+
+  size_t m_depth;
+  size_t m_batch_size;
+  size_t m_response_header_size;
+
+  uint64_t m_seq = 0;
+  unix_socket* m_sock = nullptr;     // socket of outstanding requests
+  std::deque<request> m_outstanding; // posted, response not read yet
+  std::vector<request> m_batched;    // requests in m_batch
+  xclBatch_call m_batch;
+
+  std::vector<char> m_header;
+  std::vector<char> m_payload;
+  std::string m_call;
+
+  std::map<uint32_t, api_stats> m_stats;
+
+  // Posted requests reported failed by the device process since the
+  // last report, and the first of them
+  uint64_t m_post_errors = 0;
+  uint64_t m_first_error_seq = 0;
+  uint32_t m_first_error_api = 0;
+
+  bool
+  send(unix_socket* sock, uint32_t api, const google::protobuf::MessageLite& msg);
+
+  bool
+  receive(unix_socket* sock);
+
+  bool
+  post_request(uint32_t api, const google::protobuf::MessageLite& msg,
+               response_checker check, std::vector<request> batch);
+
+  bool
+  complete_oldest();
+
+  bool
+  flush_batch();
+
+  api_stats&
+  stats(uint32_t api, const google::protobuf::MessageLite& msg);
+
+  void
+  record(const request& req, bool ok, uint64_t api_stats::* counter);
+
+  bool
+  check_response(const request& req, const void* data, size_t size, uint64_t api_stats::* counter);
+
+  void
+  report_post_errors();
+};
+
+} // xclemulation
+
+#endif
@@ -1298,7 +1298,7 @@ namespace xclhwemhal2 {
 
            const char *curr = (const char *)hostBuf;
            //Note: Adding PF and BAR ID valuesas 0, Once original values are avaiaable they get replaced
-           xclWriteAddrSpaceDeviceRam_RPC_CALL(xclWriteAddrSpaceDeviceRam ,space,offset,curr,size,0,0);
+           xclWriteAddrSpaceDeviceRam_RPC_POST(xclWriteAddrSpaceDeviceRam ,space,offset,curr,size,0,0);
            PRINTENDFUNC;
            return totalSize;
          }
@@ -1307,7 +1307,7 @@ namespace xclhwemhal2 {
            const char *curr = (const char *)hostBuf;
            std::map<uint64_t,std::pair<std::string,unsigned int>> offsetArgInfo;
            //Note: Adding PF and BAR ID valuesas 0, Once original values are avaiaable they get replaced
-           xclWriteAddrKernelCtrl_RPC_CALL(xclWriteAddrKernelCtrl ,space,offset,curr,size,offsetArgInfo,0,0);
+           xclWriteAddrKernelCtrl_RPC_POST(xclWriteAddrKernelCtrl ,space,offset,curr,size,offsetArgInfo,0,0);
            PRINTENDFUNC;
            return size;
          }
@@ -1345,7 +1345,7 @@ namespace xclhwemhal2 {
              logMessage(dMsg,1);
            }
            //Note: Adding PF and BAR ID valuesas 0, Once original values are avaiaable they get replaced
-           xclWriteAddrKernelCtrl_RPC_CALL(xclWriteAddrKernelCtrl,space,offset,hostBuf,size,offsetArgInfo,0,0);
+           xclWriteAddrKernelCtrl_RPC_POST(xclWriteAddrKernelCtrl,space,offset,hostBuf,size,offsetArgInfo,0,0);
            if(hostBuf32[0] & CONTROL_AP_START)
            {
              std::string dMsg ="INFO: [HW-EMU 04-1] Kernel " + kernelName +" is Started";
@@ -1524,7 +1524,7 @@ namespace xclhwemhal2 {
       // TODO: Windows build support
       // *_RPC_CALL uses unix_socket
       uint32_t space = getAddressSpace(topology);
-      xclCopyBufferHost2Device_RPC_CALL(xclCopyBufferHost2Device, handle, c_dest, c_src, c_size, seek, space);
+      xclCopyBufferHost2Device_RPC_POST(xclCopyBufferHost2Device, handle, c_dest, c_src, c_size, seek, space);
 #endif
       processed_bytes += c_size;
     }
@@ -2049,6 +2049,9 @@ namespace xclhwemhal2 {
     }
     //ProfilerStop();
 
+    if (xrt_core::config::get_emulation_rpc_latency_stats())
+      mRpc.print_stats(std::cout);
+    mRpc.reset();
     sock.reset();
 
     PRINTENDFUNC;
@@ -24,6 +24,7 @@
 #include "memorymanager.h"
 #include "mbscheduler_hwemu.h"
 #include "mem_model.h"
+#include "rpc_channel.h"
 #include "rpc_messages.pb.h"
 #include "xgq_hwemu.h"
 #include "xrt/detail/xclbin.h"
@@ -559,6 +560,7 @@ using addr_type = uint64_t;
 
       void* buf;
       size_t buf_size;
+      xclemulation::rpc_channel mRpc;
       std::ofstream mLogStream;
       std::ofstream mGlobalInMemStream;
       std::ofstream mGlobalOutMemStream;
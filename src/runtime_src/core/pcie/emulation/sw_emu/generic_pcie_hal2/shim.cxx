@@ -140,6 +140,84 @@ namespace xclswemuhal2
     }
   }
 
+  // Back the device memory banks with shared memory that the device
+  // process maps as well, so that buffer transfers are memcpy rather
+  // than chunked RPC calls.  The regions are created once and kept
+  // across device process launches, the device process is told about
+  // them after each xclbin load.  Transfers go through RPC if the
+  // device process does not accept the regions.
+  void SwEmuShim::setupDataPlane()
+  {
+    mDataPlaneActive = false;
+    if (!xrt_core::config::get_flag_sw_emu_shared_memory() || !sock)
+      return;
+
+    if (mDataPlane.empty())
+    {
+      for (auto mm : mDDRMemoryManager)
+      {
+        data_plane_region region;
+        region.base = mm->start();
+        region.size = mm->size();
+        auto name = "xrt_swemu_" + std::to_string(mDeviceIndex) + "_" + std::to_string(mDataPlane.size());
+        region.fd = memfd_create(name.c_str(), MFD_CLOEXEC);
+        if (region.fd != -1 && ftruncate(region.fd, region.size) == 0)
+        {
+          // Pages are allocated when first touched
+          auto addr = mmap(nullptr, region.size, PROT_READ | PROT_WRITE, MAP_SHARED, region.fd, 0);
+          if (addr != MAP_FAILED)
+            region.addr = static_cast<unsigned char *>(addr);
+        }
+
+        if (!region.addr)
+        {
+          std::cerr << "WARNING: [SW_EMU 24] Unable to create shared memory for device memory bank "
+                    << mDataPlane.size() << ": " << strerror(errno) << ", using RPC for buffer transfers" << std::endl;
+          if (region.fd != -1)
+            close(region.fd);
+          closeDataPlane();
+          return;
+        }
+
+        region.path = "/proc/" + std::to_string(getpid()) + "/fd/" + std::to_string(region.fd);
+        mDataPlane.push_back(std::move(region));
+      }
+    }
+
+    bool success = false;
+    swemuSetupDataPlane_RPC_CALL(swemuSetupDataPlane, mDataPlane);
+    mDataPlaneActive = success;
+
+    if (mLogStream.is_open())
+      mLogStream << __func__ << " regions " << mDataPlane.size() << " success " << success << std::endl;
+  }
+
+  void SwEmuShim::closeDataPlane()
+  {
+    mDataPlaneActive = false;
+    for (auto& region : mDataPlane)
+    {
+      munmap(region.addr, region.size);
+      close(region.fd);
+    }
+    mDataPlane.clear();
+  }
+
+  // Host address of device memory [addr, addr+size) if it is backed by
+  // shared memory accepted by the device process, nullptr otherwise
+  unsigned char *SwEmuShim::getDataPlaneAddr(uint64_t addr, size_t size)
+  {
+    if (!mDataPlaneActive)
+      return nullptr;
+
+    for (auto& region : mDataPlane)
+    {
+      if (addr >= region.base && addr - region.base + size <= region.size)
+        return region.addr + (addr - region.base);
+    }
+    return nullptr;
+  }
+
   //private
   bool SwEmuShim::isGood() const
   {
@@ -769,6 +847,8 @@ namespace xclswemuhal2
       if (!ack)
         return -1;
 
+      setupDataPlane();
+
     }
 
     if (isVersal)
@@ -961,7 +1041,7 @@ namespace xclswemuhal2
     }
 
     fflush(stdout);
-    xclWriteAddrKernelCtrl_RPC_CALL(xclWriteAddrKernelCtrl, space, offset, hostBuf, size, kernelArgsInfo, 0, 0);
+    xclWriteAddrKernelCtrl_RPC_POST(xclWriteAddrKernelCtrl, space, offset, hostBuf, size, kernelArgsInfo, 0, 0);
     PRINTENDFUNC;
     return size;
   }
@@ -1115,6 +1195,12 @@ namespace xclswemuhal2
     src = (unsigned char *)src + seek;
     dest += seek;
 
+    if (auto dptr = getDataPlaneAddr(dest, size))
+    {
+      std::memcpy(dptr, src, size);
+      return size;
+    }
+
     void *handle = this;
 
     unsigned int messageSize = get_messagesize();
@@ -1135,7 +1221,7 @@ namespace xclswemuhal2
       uint64_t c_dest = dest + processed_bytes;
 #ifndef _WINDOWS
       uint32_t space = 0;
-      xclCopyBufferHost2Device_RPC_CALL(xclCopyBufferHost2Device, handle, c_dest, c_src, c_size, seek, space);
+      xclCopyBufferHost2Device_RPC_POST(xclCopyBufferHost2Device, handle, c_dest, c_src, c_size, seek, space);
 #endif
       processed_bytes += c_size;
     }
@@ -1160,6 +1246,13 @@ namespace xclswemuhal2
       launchTempProcess();
 
     src += skip;
+
+    if (auto sptr = getDataPlaneAddr(src, size))
+    {
+      std::memcpy(dest, sptr, size);
+      return size;
+    }
+
     void *handle = this;
 
     unsigned int messageSize = get_messagesize();
@@ -1286,6 +1379,7 @@ namespace xclswemuhal2
     }
 
     mIsDeviceProcessStarted = false;
+    mDataPlaneActive = false;
     std::string socketName = sock->get_name();
     // device is active if socketName is non-empty
     if (!socketName.empty())
@@ -1388,8 +1482,12 @@ namespace xclswemuhal2
       while (-1 == waitpid(0, &status, 0));
 
     systemUtil::makeSystemCall(socketName, systemUtil::systemOperation::REMOVE);
+    if (xrt_core::config::get_emulation_rpc_latency_stats())
+      mRpc.print_stats(std::cout);
+    mRpc.reset();
     delete sock;
     sock = nullptr;
+    closeDataPlane();
     PRINTENDFUNC;
     if (mIsKdsSwEmu && mSWSch && mCore)
     {
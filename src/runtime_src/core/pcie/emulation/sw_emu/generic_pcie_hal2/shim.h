@@ -7,6 +7,7 @@
 #include "config.h"
 #include "em_defines.h"
 #include "memorymanager.h"
+#include "rpc_channel.h"
 #include "rpc_messages.pb.h"
 
 #include "core/include/xdp/common.h"
@@ -796,6 +797,22 @@ namespace xclswemuhal2
     void initMemoryManager(std::list<xclemulation::DDRBank> &DDRBankList);
     std::vector<xclemulation::MemoryManager *> mDDRMemoryManager;
 
+    // Shared memory backing of a device memory bank, mapped into this
+    // process and the device process (Emulation.sw_emu_shared_memory)
+    struct data_plane_region
+    {
+      std::string path;
+      uint64_t base = 0;
+      uint64_t size = 0;
+      int fd = -1;
+      unsigned char *addr = nullptr;
+    };
+    std::vector<data_plane_region> mDataPlane;
+    bool mDataPlaneActive = false;
+    void setupDataPlane();
+    void closeDataPlane();
+    unsigned char *getDataPlaneAddr(uint64_t addr, size_t size);
+
     void *ci_buf;
     call_packet_info ci_msg;
 
@@ -805,6 +822,7 @@ namespace xclswemuhal2
 
     void *buf;
     size_t buf_size;
+    xclemulation::rpc_channel mRpc;
     unsigned int binaryCounter;
     unix_socket *sock;
     unix_socket *aiesim_sock;
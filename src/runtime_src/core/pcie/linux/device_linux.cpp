@@ -1036,6 +1036,18 @@ struct spc_status
   }
 };
 
+// numa_node of the PCI device is -1 when the platform has no NUMA
+// information, which does not parse as an unsigned value
+struct numa_node
+{
+  using result_type = query::numa_node::result_type;
+
+  static result_type
+  get(const xrt_core::device* device, key_type)
+  {
+    return std::stoi(sysfs_fcn<std::string>::get(get_pcidev(device), "", "numa_node"));
+  }
+};
 
 /* Accelerator Deadlock Detector status
  * In PCIe Linux, access the sysfs file for Accelerator Deadlock Detector to retrieve the deadlock status
@@ -1447,6 +1459,7 @@ initialize_query_table()
   emplace_sysfs_get<query::heartbeat_stall>                    ("xmc", "xmc_heartbeat_stall");
   emplace_func0_request<query::xmc_qspi_status,                qspi_status>();
   emplace_func0_request<query::mac_addr_list,                  mac_addr_list>();
+  emplace_func0_request<query::numa_node,                      numa_node>();
 
   emplace_sysfs_get<query::firewall_detect_level>              ("firewall", "detected_level");
   emplace_sysfs_get<query::firewall_detect_level_name>         ("firewall", "detected_level_name");
@@ -38,6 +38,12 @@ private:
     xrt::shim_int::register_xclbin(get_device_handle(), xclbin);
   }
 
+  std::unique_ptr<fence_handle>
+  create_fence(xrt::fence::access_mode access) override
+  {
+    return xrt::shim_int::create_fence(get_device_handle(), access);
+  }
+
   std::unique_ptr<buffer_handle>
   alloc_bo(size_t size, uint64_t flags) override
   {
@@ -17,17 +17,29 @@
 #include "core/common/device.h"
 #include "core/common/message.h"
 #include "core/common/system.h"
-#include "core/common/task.h"
 #include "core/common/thread.h"
 #include "core/common/shim/buffer_handle.h"
 #include "core/common/shim/hwctx_handle.h"
+#include "core/common/shim/hwqueue_handle.h"
 
 #include "core/common/api/hw_context_int.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <mutex>
+#include <random>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace { // private implementation details
 
@@ -285,81 +297,405 @@ static std::vector<std::shared_ptr<pl::device>> s_devices;
 
 // Simulate asynchronous command completion.
 //
-// Command handles are added to a producer/consumer queue A worker
-// thread pretends to run the command and marks it complete only if
-// the command was enqueue some constant time before now.
+// The device model is configured through xrt.ini (Runtime.noop_*).
+// Each CU is an independent server that executes its commands in
+// order, with service times drawn from a configurable distribution
+// with mean noop_completion_delay_us.  The device accepts at most
+// noop_queue_depth commands at a time, additional commands are held
+// in a backlog in submission order.  A completed command is signaled
+// on the completion channel it was submitted through, which is either
+// the device wide channel used by exec_wait or the channel of a
+// hardware queue.  Without service time and queue depth, commands
+// complete immediately when submitted.
 namespace cmd {
 
-static unsigned int completion_delay_us = 0;
-static xrt_core::task::queue running_queue;
-static std::thread completer;
-static std::atomic<uint64_t> completion_count {0};
+using clock = std::chrono::steady_clock;
 
-struct cmd_type
+// Completion channel for commands submitted through same queue
+class channel
 {
-  xclBufferHandle handle;
-  unsigned long queue_time;
-  cmd_type(xclBufferHandle h)
-    : handle(h), queue_time(xrt_core::time_ns())
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  uint64_t m_count = 0;
+
+public:
+  virtual ~channel() = default;
+  channel() = default;
+  channel(const channel&) = delete;
+  channel& operator=(const channel&) = delete;
+
+  // Called without the device model lock held
+  virtual void
+  complete(ert_packet* pkt)
+  {
+    {
+      std::lock_guard lk(m_mutex);
+      pkt->state = ERT_CMD_STATE_COMPLETED;
+      ++m_count;
+    }
+    m_cv.notify_all();
+  }
+
+  // Wait for any completion since last call, 0 on timeout
+  int
+  wait(int msec)
+  {
+    std::unique_lock lk(m_mutex);
+    auto pred = [this] { return m_count > 0; };
+    if (msec > 0) {
+      if (!m_cv.wait_for(lk, std::chrono::milliseconds(msec), pred))
+        return 0;
+    }
+    else {
+      m_cv.wait(lk, pred);
+    }
+    m_count = 0;
+    return 1;
+  }
+
+  // Wait for completion of specific command, 0 on timeout
+  int
+  wait(const ert_packet* pkt, uint32_t timeout_ms)
+  {
+    std::unique_lock lk(m_mutex);
+    auto pred = [pkt] { return pkt->state >= ERT_CMD_STATE_COMPLETED; };
+    if (timeout_ms)
+      return m_cv.wait_for(lk, std::chrono::milliseconds(timeout_ms), pred) ? 1 : 0;
+
+    m_cv.wait(lk, pred);
+    return 1;
+  }
+};
+
+class device_model
+{
+  static constexpr size_t max_cus = 128;
+  static constexpr size_t cus_per_word = 32;
+  static constexpr size_t no_cu = max_cus;
+
+  struct command
+  {
+    ert_packet* pkt;
+    channel* chan;
+  };
+
+  struct cu
+  {
+    std::deque<command> queue; // admitted commands, head is running
+    clock::time_point done;    // completion time of head command
+  };
+
+  enum class distribution { constant, uniform, exponential };
+
+  std::chrono::nanoseconds m_service;
+  distribution m_distribution = distribution::constant;
+  size_t m_depth;
+
+  std::mutex m_mutex;
+  std::condition_variable m_work;
+  std::array<cu, max_cus> m_cus;
+  std::deque<command> m_backlog;
+  size_t m_inflight = 0;
+  bool m_stop = false;
+  std::mt19937_64 m_rng;
+  std::thread m_thread;
+
+  std::chrono::nanoseconds
+  sample()
+  {
+    if (!m_service.count())
+      return m_service;
+
+    auto mean = static_cast<double>(m_service.count());
+    switch (m_distribution) {
+    case distribution::uniform:
+      return std::chrono::nanoseconds(static_cast<int64_t>(std::uniform_real_distribution<double>(0, 2 * mean)(m_rng)));
+    case distribution::exponential:
+      return std::chrono::nanoseconds(static_cast<int64_t>(std::exponential_distribution<double>(1 / mean)(m_rng)));
+    default:
+      return m_service;
+    }
+  }
+
+  // Pick the CU with the shortest queue among the CUs in the
+  // command's CU masks, or no_cu if the command does not run on a CU
+  size_t
+  select_cu(ert_packet* pkt) const
+  {
+    switch (pkt->opcode) {
+    case ERT_START_CU:
+    case ERT_EXEC_WRITE:
+    case ERT_SK_START:
+    case ERT_START_FA:
+    case ERT_START_KEY_VAL:
+    case ERT_START_DPU:
+    case ERT_START_NPU:
+    case ERT_START_NPU_PREEMPT:
+    case ERT_START_NPU_PREEMPT_ELF:
+      break;
+    default:
+      return no_cu;
+    }
+
+    auto kcmd = reinterpret_cast<ert_start_kernel_cmd*>(pkt);
+    size_t selected = no_cu;
+    for (size_t word = 0; word <= kcmd->extra_cu_masks; ++word) {
+      auto mask = word ? kcmd->data[word - 1] : kcmd->cu_mask;
+      for (size_t bit = 0; mask; ++bit, mask >>= 1) {
+        if (!(mask & 1))
+          continue;
+        auto idx = word * cus_per_word + bit;
+        if (selected == no_cu || m_cus[idx].queue.size() < m_cus[selected].queue.size())
+          selected = idx;
+      }
+    }
+    return selected;
+  }
+
+  // Admit command to its CU, must be called with lock held.  A
+  // command that does not run on a CU is added to 'done' and must be
+  // completed once the lock is released.
+  void
+  admit(const command& cmd, clock::time_point now, std::vector<command>& done)
+  {
+    auto idx = select_cu(cmd.pkt);
+    if (idx == no_cu) {
+      done.push_back(cmd);
+      return;
+    }
+
+    auto& cu = m_cus[idx];
+    if (cu.queue.empty())
+      cu.done = now + sample();
+    cu.queue.push_back(cmd);
+    ++m_inflight;
+  }
+
+  // Complete commands, must be called without lock held because a
+  // channel may submit new commands upon completion
+  static void
+  complete(std::vector<command>& done)
+  {
+    for (const auto& cmd : done)
+      cmd.chan->complete(cmd.pkt);
+    done.clear();
+  }
+
+  void
+  run()
+  {
+    std::vector<command> done;
+    std::unique_lock lk(m_mutex);
+    while (!m_stop) {
+      auto next = clock::time_point::max();
+      for (const auto& cu : m_cus)
+        if (!cu.queue.empty())
+          next = std::min(next, cu.done);
+
+      if (next == clock::time_point::max()) {
+        m_work.wait(lk);
+        continue;
+      }
+
+      if (clock::now() < next) {
+        m_work.wait_until(lk, next);
+        continue;
+      }
+
+      // Retire all commands whose service time has elapsed.  The
+      // next command on a CU starts when the previous completed.
+      auto now = clock::now();
+      for (auto& cu : m_cus) {
+        while (!cu.queue.empty() && cu.done <= now) {
+          auto cmd = cu.queue.front();
+          cu.queue.pop_front();
+          --m_inflight;
+          done.push_back(cmd);
+          if (!cu.queue.empty())
+            cu.done += sample();
+        }
+      }
+
+      while (!m_backlog.empty() && m_inflight < m_depth) {
+        admit(m_backlog.front(), now, done);
+        m_backlog.pop_front();
+      }
+
+      if (!done.empty()) {
+        lk.unlock();
+        complete(done);
+        lk.lock();
+      }
+    }
+  }
+
+public:
+  device_model()
+    : m_service(std::chrono::microseconds(xrt_core::config::get_noop_completion_delay_us()))
+    , m_depth(xrt_core::config::get_noop_queue_depth())
+  {
+    auto dist = xrt_core::config::get_noop_service_time_distribution();
+    if (dist == "uniform")
+      m_distribution = distribution::uniform;
+    else if (dist == "exponential")
+      m_distribution = distribution::exponential;
+    else if (dist != "constant")
+      throw std::runtime_error("noop: unknown service time distribution: " + dist);
+
+    if (!m_depth)
+      m_depth = std::numeric_limits<size_t>::max();
+
+    if (m_service.count() || m_depth != std::numeric_limits<size_t>::max())
+      m_thread = xrt_core::thread([this] { run(); });
+  }
+
+  ~device_model()
+  {
+    if (!m_thread.joinable())
+      return;
+
+    {
+      std::lock_guard lk(m_mutex);
+      m_stop = true;
+    }
+    m_work.notify_all();
+    m_thread.join();
+  }
+
+  device_model(const device_model&) = delete;
+  device_model& operator=(const device_model&) = delete;
+
+  void
+  submit(ert_packet* pkt, channel* chan)
+  {
+    if (!m_thread.joinable()) {
+      chan->complete(pkt);
+      return;
+    }
+
+    std::vector<command> done;
+    {
+      std::lock_guard lk(m_mutex);
+      if (m_inflight < m_depth && m_backlog.empty())
+        admit({pkt, chan}, clock::now(), done);
+      else
+        m_backlog.push_back({pkt, chan});
+    }
+    m_work.notify_all();
+    complete(done);
+  }
+};
+
+// DMA engine per direction.  A transfer occupies the engine for
+// size/bandwidth and completes a fixed latency later, so concurrent
+// syncs in the same direction share the bandwidth.
+class dma_model
+{
+  std::chrono::nanoseconds m_latency;
+  uint64_t m_mbps;
+  std::mutex m_mutex;
+  std::array<clock::time_point, 2> m_busy;
+
+public:
+  dma_model()
+    : m_latency(std::chrono::microseconds(xrt_core::config::get_noop_dma_latency_us()))
+    , m_mbps(xrt_core::config::get_noop_dma_bandwidth_mbps())
   {}
+
+  void
+  transfer(xclBOSyncDirection dir, size_t size)
+  {
+    if (!m_latency.count() && !m_mbps)
+      return;
+
+    // bytes / (MB/s) = size * 1000 / mbps ns
+    auto xfer = std::chrono::nanoseconds(m_mbps ? size * 1000 / m_mbps : 0);
+    clock::time_point end;
+    {
+      std::lock_guard lk(m_mutex);
+      auto& busy = m_busy[dir == XCL_BO_SYNC_BO_FROM_DEVICE ? 1 : 0];
+      busy = std::max(busy, clock::now()) + xfer;
+      end = busy + m_latency;
+    }
+    std::this_thread::sleep_until(end);
+  }
+
+  // A batch is one submission per direction, so it pays the latency
+  // once while both engines run concurrently
+  void
+  transfer(size_t to_device, size_t from_device)
+  {
+    if (!m_latency.count() && !m_mbps)
+      return;
+
+    clock::time_point end;
+    {
+      std::lock_guard lk(m_mutex);
+      auto now = clock::now();
+      size_t sizes[] = {to_device, from_device};
+      for (int idx : {0, 1}) {
+        if (!sizes[idx])
+          continue;
+        auto xfer = std::chrono::nanoseconds(m_mbps ? sizes[idx] * 1000 / m_mbps : 0);
+        m_busy[idx] = std::max(m_busy[idx], now) + xfer;
+        end = std::max(end, m_busy[idx] + m_latency);
+      }
+    }
+    std::this_thread::sleep_until(end);
+  }
 };
 
-static void
-init()
+static device_model&
+get_device_model()
 {
-  if ( (completion_delay_us = xrt_core::config::get_noop_completion_delay_us()) )
-    completer = std::move(xrt_core::thread(xrt_core::task::worker, std::ref(running_queue)));
+  static device_model model;
+  return model;
 }
 
-static void
-stop()
+static dma_model&
+get_dma_model()
 {
-  if (completion_delay_us) {
-    running_queue.stop();
-    completer.join();
-  }
+  static dma_model dma;
+  return dma;
 }
 
+// Channel for commands submitted through exec_buf
+static channel device_channel;
+
 static void
-wait()
+submit(xclBufferHandle handle, channel* chan)
 {
-  while (!completion_count) ;
-  --completion_count;
+  auto pkt = reinterpret_cast<ert_packet*>(buffer::map(handle));
+  get_device_model().submit(pkt, chan);
 }
 
 static void
-mark_cmd_handle_complete(xclBufferHandle handle)
+add(xclBufferHandle handle)
 {
-  //XRT_PRINTF("handle(%d) is complete\n", handle);
-  auto hbuf = buffer::map(handle);
-  auto cmd = reinterpret_cast<ert_packet*>(hbuf);
-  cmd->state = ERT_CMD_STATE_COMPLETED;
-  ++completion_count;
+  submit(handle, &device_channel);
 }
 
-static void
-mark_cmd_complete(cmd_type ct)
+static int
+wait(int msec)
 {
-  while (xrt_core::time_ns() - ct.queue_time < completion_delay_us * 1000);
-  mark_cmd_handle_complete(ct.handle);
+  return device_channel.wait(msec);
 }
 
 static void
-add(xclBufferHandle handle)
+sync(xclBOSyncDirection dir, size_t size)
 {
-  if (completion_delay_us)
-    xrt_core::task::createF(running_queue, mark_cmd_complete, cmd_type(handle));
-  else
-    mark_cmd_handle_complete(handle);
+  get_dma_model().transfer(dir, size);
 }
 
-struct X
+static void
+sync(const std::vector<xrt_core::buffer_handle::sync_range>& ranges)
 {
-  X() { init(); }
-  ~X() { stop(); }
-};
-
-static X x;
+  size_t to_device = 0;
+  size_t from_device = 0;
+  for (const auto& range : ranges)
+    (range.dir == xrt_core::buffer_handle::direction::device2host ? from_device : to_device) += range.size;
+  get_dma_model().transfer(to_device, from_device);
+}
 
 } // cmd
 
@@ -437,6 +773,13 @@ struct shim
       m_shim->sync_bo(m_fd, static_cast<xclBOSyncDirection>(dir), size, offset);
     }
 
+    // All buffers are noop buffers, sync them as one transfer
+    void
+    sync_batch(const std::vector<sync_range>& ranges) override
+    {
+      cmd::sync(ranges);
+    }
+
     void
     copy(const buffer_handle*, size_t, size_t, size_t) override
     {
@@ -458,19 +801,345 @@ struct shim
     }
   }; // buffer
 
+  // Fence modeled as a timeline whose value counts the signals.  A
+  // fence and its copies share the timeline, but each has its own
+  // next state, which is the value signaled or waited for next
+  // through that copy.
+  class fence : public xrt_core::fence_handle
+  {
+  public:
+    class timeline
+    {
+      std::mutex m_mutex;
+      std::condition_variable m_cv;
+      uint64_t m_value = 0;
+      std::vector<std::pair<uint64_t, std::function<void()>>> m_waiters;
+
+    public:
+      void
+      signal(uint64_t value)
+      {
+        std::vector<std::function<void()>> ready;
+        {
+          std::lock_guard lk(m_mutex);
+          m_value = std::max(m_value, value);
+          auto itr = std::partition(m_waiters.begin(), m_waiters.end(),
+                                    [this](const auto& waiter) { return waiter.first > m_value; });
+          std::transform(std::make_move_iterator(itr), std::make_move_iterator(m_waiters.end()),
+                         std::back_inserter(ready), [](auto&& waiter) { return std::move(waiter.second); });
+          m_waiters.erase(itr, m_waiters.end());
+        }
+        m_cv.notify_all();
+
+        // Waiters are called without lock held
+        for (auto& fcn : ready)
+          fcn();
+      }
+
+      // Wait on host for value, 0 on timeout
+      int
+      wait(uint64_t value, uint32_t timeout_ms)
+      {
+        std::unique_lock lk(m_mutex);
+        auto pred = [this, value] { return m_value >= value; };
+        if (timeout_ms)
+          return m_cv.wait_for(lk, std::chrono::milliseconds(timeout_ms), pred) ? 1 : 0;
+
+        m_cv.wait(lk, pred);
+        return 1;
+      }
+
+      // Return false if value is reached, otherwise call fcn
+      // when the value is signaled and return true
+      bool
+      wait_async(uint64_t value, std::function<void()> fcn)
+      {
+        std::lock_guard lk(m_mutex);
+        if (m_value >= value)
+          return false;
+
+        m_waiters.emplace_back(value, std::move(fcn));
+        return true;
+      }
+    };
+
+  private:
+    std::shared_ptr<timeline> m_timeline;
+    mutable uint64_t m_next = 1;
+
+  public:
+    fence()
+      : m_timeline(std::make_shared<timeline>())
+    {}
+
+    // Return the timeline and the value of the next signal or wait,
+    // and advance to the state after it
+    std::pair<std::shared_ptr<timeline>, uint64_t>
+    advance() const
+    {
+      return {m_timeline, m_next++};
+    }
+
+    std::unique_ptr<xrt_core::fence_handle>
+    clone() const override
+    {
+      return std::make_unique<fence>(*this);
+    }
+
+    std::unique_ptr<xrt_core::shared_handle>
+    share() const override
+    {
+      throw xrt_core::error(std::errc::not_supported, "noop fence cannot be shared");
+    }
+
+    void
+    wait(uint32_t timeout_ms) const override
+    {
+      if (!m_timeline->wait(m_next, timeout_ms))
+        throw xrt_core::error(std::errc::timed_out, "noop fence wait timed out");
+      ++m_next;
+    }
+
+    void
+    signal() const override
+    {
+      m_timeline->signal(m_next++);
+    }
+
+    uint64_t
+    get_next_state() const override
+    {
+      return m_next;
+    }
+  }; // class shim::fence
+
+  // Hardware queue with its own completion channel, so that waiting
+  // for commands in one hardware context is not affected by commands
+  // completing in other hardware contexts.
+  //
+  // Commands submitted after a fence wait are held until the fence is
+  // signaled.  A fence signal is submitted to the device when the
+  // commands submitted before it have completed.  Commands between
+  // fence operations execute concurrently as they would without
+  // fences.
+  class hwqueue : public xrt_core::hwqueue_handle
+  {
+    using timeline = fence::timeline;
+
+    // Completion channel that reports completed commands to the queue
+    class queue_channel : public cmd::channel
+    {
+      hwqueue* m_queue;
+
+    public:
+      explicit queue_channel(hwqueue* queue)
+        : m_queue(queue)
+      {}
+
+      void
+      complete(ert_packet* pkt) override
+      {
+        cmd::channel::complete(pkt);
+        m_queue->completed(pkt);
+      }
+    };
+
+    // A command or a fence operation
+    struct operation
+    {
+      xrt_core::buffer_handle* cmd;     // command to submit, or
+      std::shared_ptr<timeline> fence;  // fence to wait on or signal
+      uint64_t value;
+      bool wait;
+    };
+
+    // Fence signaled when pending commands have completed
+    struct signal_point
+    {
+      std::shared_ptr<timeline> fence;
+      uint64_t value;
+      std::vector<const ert_packet*> pending;
+    };
+
+    // Work to do once the queue lock is released
+    struct actions
+    {
+      std::vector<xrt_core::buffer_handle*> submit;
+      std::vector<std::pair<std::shared_ptr<timeline>, uint64_t>> signal;
+    };
+
+    mutable queue_channel m_channel{this};
+    std::mutex m_mutex;
+    std::deque<operation> m_held;           // held behind a fence wait
+    std::vector<const ert_packet*> m_running;
+    std::vector<signal_point> m_signals;
+
+    static ert_packet*
+    get_packet(xrt_core::buffer_handle* cmd)
+    {
+      return reinterpret_cast<ert_packet*>(buffer::map(cmd->get_xcl_handle()));
+    }
+
+    static void
+    erase(std::vector<const ert_packet*>& pkts, const ert_packet* pkt)
+    {
+      auto itr = std::find(pkts.begin(), pkts.end(), pkt);
+      if (itr == pkts.end())
+        return;
+      *itr = pkts.back();
+      pkts.pop_back();
+    }
+
+    // Dispatch an operation, must be called with lock held.  Return
+    // false if the operation is a wait on a fence not yet signaled.
+    bool
+    dispatch(const operation& op, actions& todo)
+    {
+      if (op.cmd) {
+        m_running.push_back(get_packet(op.cmd));
+        todo.submit.push_back(op.cmd);
+        return true;
+      }
+
+      if (op.wait)
+        return !op.fence->wait_async(op.value, [this] { resume(); });
+
+      if (m_running.empty())
+        todo.signal.emplace_back(op.fence, op.value);
+      else
+        m_signals.push_back({op.fence, op.value, m_running});
+      return true;
+    }
+
+    // Commands are submitted and fences signaled without lock held,
+    // because either can complete synchronously and reenter the queue
+    void
+    perform(actions& todo)
+    {
+      for (auto cmd : todo.submit)
+        cmd::submit(cmd->get_xcl_handle(), &m_channel);
+      for (auto& [fence, value] : todo.signal)
+        fence->signal(value);
+    }
+
+    void
+    enqueue(operation op)
+    {
+      actions todo;
+      {
+        std::lock_guard lk(m_mutex);
+        if (!m_held.empty() || !dispatch(op, todo))
+          m_held.push_back(std::move(op));
+      }
+      perform(todo);
+    }
+
+    // The fence wait at the head of the held operations is signaled
+    void
+    resume()
+    {
+      actions todo;
+      {
+        std::lock_guard lk(m_mutex);
+        m_held.pop_front();
+        while (!m_held.empty() && dispatch(m_held.front(), todo))
+          m_held.pop_front();
+      }
+      perform(todo);
+    }
+
+    void
+    completed(const ert_packet* pkt)
+    {
+      actions todo;
+      {
+        std::lock_guard lk(m_mutex);
+        erase(m_running, pkt);
+        auto itr = m_signals.begin();
+        while (itr != m_signals.end()) {
+          erase(itr->pending, pkt);
+          if (!itr->pending.empty()) {
+            ++itr;
+            continue;
+          }
+          todo.signal.emplace_back(std::move(itr->fence), itr->value);
+          itr = m_signals.erase(itr);
+        }
+      }
+      perform(todo);
+    }
+
+    static const fence*
+    get_fence(const xrt_core::fence_handle* fhdl)
+    {
+      if (auto fnc = dynamic_cast<const fence*>(fhdl))
+        return fnc;
+
+      throw xrt_core::error(std::errc::invalid_argument, "noop hwqueue: not a noop fence");
+    }
+
+  public:
+    void
+    submit_command(xrt_core::buffer_handle* cmd) override
+    {
+      enqueue({cmd, nullptr, 0, false});
+    }
+
+    int
+    wait_command(xrt_core::buffer_handle* cmd, uint32_t timeout_ms) const override
+    {
+      return m_channel.wait(get_packet(cmd), timeout_ms);
+    }
+
+    void
+    submit_wait(const xrt_core::fence_handle* fhdl) override
+    {
+      auto [fence, value] = get_fence(fhdl)->advance();
+      enqueue({nullptr, std::move(fence), value, true});
+    }
+
+    void
+    submit_wait(const std::vector<xrt_core::fence_handle*>& fhdls) override
+    {
+      for (auto fhdl : fhdls)
+        submit_wait(fhdl);
+    }
+
+    void
+    submit_signal(const xrt_core::fence_handle* fhdl) override
+    {
+      auto [fence, value] = get_fence(fhdl)->advance();
+      enqueue({nullptr, std::move(fence), value, false});
+    }
+
+    // A chained command completes as one command, any length is fine
+    size_t
+    get_max_chain_size() const override
+    {
+      return std::numeric_limits<size_t>::max();
+    }
+
+    bool
+    has_fence_support() const override
+    {
+      return true;
+    }
+  }; // class shim::hwqueue
+
   class hwcontext : public xrt_core::hwctx_handle
   {
     shim* m_shim;
     xrt::uuid m_uuid;
     slot_id m_slotidx;
     bool m_null = false;
+    std::unique_ptr<hwqueue> m_hwqueue;
 
 public:
     hwcontext(shim* shim, slot_id slotidx, xrt::uuid uuid)
       : m_shim(shim)
       , m_uuid(std::move(uuid))
       , m_slotidx(slotidx)
-
+      , m_hwqueue(xrt_core::config::get_noop_hw_queue() ? std::make_unique<hwqueue>() : nullptr)
     {}
 
     ~hwcontext()
@@ -493,7 +1162,7 @@ public:
     xrt_core::hwqueue_handle*
     get_hw_queue() override
     {
-      return nullptr;
+      return m_hwqueue.get();
     }
 
     std::unique_ptr<xrt_core::buffer_handle>
@@ -582,8 +1251,9 @@ public:
   }
 
   int
-  sync_bo(buffer_handle_type, xclBOSyncDirection, size_t, size_t)
+  sync_bo(buffer_handle_type, xclBOSyncDirection dir, size_t size, size_t)
   {
+    cmd::sync(dir, size);
     return 0;
   }
 
@@ -616,8 +1286,7 @@ public:
   int
   exec_wait(int msec)
   {
-    cmd::wait();
-    return 1;
+    return cmd::wait(msec);
   }
 
   int
@@ -713,6 +1382,12 @@ public:
     m_pldev->register_xclbin(xclbin);
   }
 
+  std::unique_ptr<xrt_core::fence_handle>
+  create_fence()
+  {
+    return std::make_unique<fence>();
+  }
+
 
 }; // struct shim
 
@@ -788,6 +1463,13 @@ register_xclbin(xclDeviceHandle handle, const xrt::xclbin& xclbin)
   shim->register_xclbin(xclbin);
 }
 
+std::unique_ptr<xrt_core::fence_handle>
+create_fence(xclDeviceHandle handle, xrt::fence::access_mode)
+{
+  auto shim = get_shim_object(handle);
+  return shim->create_fence();
+}
+
 } // xrt::shim_int
 ////////////////////////////////////////////////////////////////
 
@@ -322,6 +322,7 @@ XSPI_Flasher::XSPI_Flasher(std::shared_ptr<xrt_core::device> dev)
         flash_base = FLASH_BASE;
 
     mFlashDev = nullptr;
+    mDifferential = std::getenv("FLASH_DIFFERENTIAL") != NULL;
 #ifdef __linux__
     if (std::getenv("FLASH_VIA_USER") == NULL) {
         int fd = mDev->open("flash", O_RDWR);
@@ -333,7 +334,17 @@ XSPI_Flasher::XSPI_Flasher(std::shared_ptr<xrt_core::device> dev)
 #endif
 }
 
+XSPI_Flasher::XSPI_Flasher(std::shared_ptr<XSPI_Regs> regs)
+    : mRegs(std::move(regs))
+    , mDifferential(std::getenv("FLASH_DIFFERENTIAL") != NULL)
+    , flash_base(0)
+{
+}
+
 static bool isDualQSPI(xrt_core::device *dev) {
+    // Simulated controllers have a single flash
+    if (!dev)
+        return false;
     auto deviceID = xrt_core::device_query<xrt_core::query::pcie_device>(dev);
     return (deviceID == 0xE987 || deviceID == 0x6987 || deviceID == 0xD030 ||
             deviceID == 0xF987);
@@ -574,7 +585,9 @@ int XSPI_Flasher::xclUpgradeFirmware1(std::istream& mcsStream1, std::istream& st
         throw xrt_core::error("Unable to prepare the flash chip");
 
     //Program MCS file
-    status = programXSpi(mcsStream1, bitstream_shift_addr);
+    status = mDifferential
+        ? programXSpiDiff(mcsStream1, bitstream_shift_addr)
+        : programXSpi(mcsStream1, bitstream_shift_addr);
     if(status)
         return status;
 
@@ -628,7 +641,9 @@ int XSPI_Flasher::xclUpgradeFirmware2(std::istream& mcsStream1, std::istream& mc
         return -EINVAL;
     }
     //Program first MCS file
-    status = programXSpi(mcsStream1, bitstream_shift_addr);
+    status = mDifferential
+        ? programXSpiDiff(mcsStream1, bitstream_shift_addr)
+        : programXSpi(mcsStream1, bitstream_shift_addr);
     if(status)
         return status;
 
@@ -644,7 +659,9 @@ int XSPI_Flasher::xclUpgradeFirmware2(std::istream& mcsStream1, std::istream& mc
         return -EINVAL;
     }
     //Program second MCS file
-    status = programXSpi(mcsStream2, bitstream_shift_addr);
+    status = mDifferential
+        ? programXSpiDiff(mcsStream2, bitstream_shift_addr)
+        : programXSpi(mcsStream2, bitstream_shift_addr);
     if(status)
         return status;
 
@@ -755,6 +772,8 @@ int XSPI_Flasher::parseMCS(std::istream& mcsStream) {
 
 unsigned int XSPI_Flasher::readReg(unsigned int RegOffset)
 {
+    if (mRegs)
+        return mRegs->read(RegOffset);
     unsigned int value = 0;
     mDev->read(flash_base + RegOffset, &value, 4);
     return value;
@@ -762,7 +781,10 @@ unsigned int XSPI_Flasher::readReg(unsigned int RegOffset)
 
 int XSPI_Flasher::writeReg(unsigned int RegOffset, unsigned int value)
 {
-    mDev->write(flash_base + RegOffset, &value, 4);
+    if (mRegs)
+        mRegs->write(RegOffset, value);
+    else
+        mDev->write(flash_base + RegOffset, &value, 4);
     return 0;
 }
 
@@ -1357,7 +1379,7 @@ bool XSPI_Flasher::finalTransfer(uint8_t *SendBufPtr, uint8_t *RecvBufPtr, int B
 }
 
 
-bool XSPI_Flasher::writePage(unsigned int Addr, uint8_t writeCmd)
+bool XSPI_Flasher::writePage(unsigned int Addr, uint8_t writeCmd, unsigned int byteCount)
 {
     if(!isFlashReady())
         return false;
@@ -1407,7 +1429,7 @@ bool XSPI_Flasher::writePage(unsigned int Addr, uint8_t writeCmd)
     }
 
     //The data to write is already filled up, so now just write the buffer.
-    if(!finalTransfer(WriteBuffer, ReadBuffer, WRITE_DATA_SIZE + READ_WRITE_EXTRA_BYTES))
+    if(!finalTransfer(WriteBuffer, ReadBuffer, byteCount + READ_WRITE_EXTRA_BYTES))
         return false;
 
     if(!waitTxEmpty())
@@ -1418,7 +1440,7 @@ bool XSPI_Flasher::writePage(unsigned int Addr, uint8_t writeCmd)
 
 }
 
-bool XSPI_Flasher::readPage(unsigned int Addr, uint8_t readCmd)
+bool XSPI_Flasher::readPage(unsigned int Addr, uint8_t readCmd, unsigned int byteCount)
 {
     if(!isFlashReady())
         return false;
@@ -1462,7 +1484,7 @@ bool XSPI_Flasher::readPage(unsigned int Addr, uint8_t readCmd)
         WriteBuffer[BYTE5] = (uint8_t) Addr;
     }
 
-    unsigned int ByteCount = READ_DATA_SIZE;
+    unsigned int ByteCount = byteCount;
 
     if (ReadCmd == COMMAND_DUAL_READ) {
         ByteCount += DUAL_READ_DUMMY_BYTES;
@@ -1743,6 +1765,144 @@ int XSPI_Flasher::programXSpi(std::istream& mcsStream, uint32_t bitstream_shift_
     return 0;
 }
 
+// Read size bytes of flash, in page sized random reads that return
+// the data right after the command and address bytes
+bool XSPI_Flasher::readData(unsigned int addr, unsigned char* data, unsigned int size)
+{
+    for (unsigned int offset = 0; offset < size; offset += PAGE_SIZE) {
+        unsigned int count = std::min<unsigned int>(PAGE_SIZE, size - offset);
+        if (!readPage(addr + offset, COMMAND_RANDOM_READ, count))
+            return false;
+        std::memcpy(data + offset, &ReadBuffer[READ_WRITE_EXTRA_BYTES], count);
+        clearBuffers();
+    }
+    return true;
+}
+
+// Program size bytes of flash, one page program command per flash page
+// rather than per WRITE_DATA_SIZE bytes
+bool XSPI_Flasher::programData(unsigned int addr, const unsigned char* data, unsigned int size)
+{
+    for (unsigned int offset = 0; offset < size;) {
+        unsigned int count = std::min<unsigned int>(PAGE_SIZE - ((addr + offset) % PAGE_SIZE), size - offset);
+        std::memcpy(&WriteBuffer[READ_WRITE_EXTRA_BYTES], data + offset, count);
+        if (!writePage(addr + offset, 0xff, count))
+            return false;
+        clearBuffers();
+        offset += count;
+    }
+    return true;
+}
+
+// Extract the data of an ELA record from the MCS stream
+int XSPI_Flasher::readRecord(std::istream& mcsStream, const ELARecord& record, std::vector<unsigned char>& data)
+{
+    data.clear();
+    data.reserve(record.mDataCount);
+    mcsStream.clear();
+    mcsStream.seekg(record.mDataPos, std::ios_base::beg);
+    while (data.size() < record.mDataCount) {
+        std::string line;
+        if (!std::getline(mcsStream, line))
+            return -EINVAL;
+        if (line.empty())
+            continue;
+        const unsigned int dataLen = std::stoi(line.substr(1, 2), 0 , 16);
+        const unsigned int recordType = std::stoi(line.substr(7, 2), 0 , 16);
+        if (recordType != 0x00)
+            continue;
+        for (unsigned int i = 0; i < dataLen; ++i)
+            data.push_back(static_cast<unsigned char>(std::stoi(line.substr(9 + i * 2, 2), 0, 16)));
+    }
+    data.resize(record.mDataCount);
+    return 0;
+}
+
+// Differential version of programXSpi.  Each 4KB subsector covered by
+// the image is read back and compared with the image, where bytes of
+// the subsector outside of the image are expected to be erased.
+// Identical subsectors are left alone, subsectors that only need bits
+// cleared are programmed without erase, others are erased and the
+// pages that are not blank in the image are programmed.  Written
+// subsectors are read back to verify them.
+int XSPI_Flasher::programXSpiDiff(std::istream& mcsStream, uint32_t bitstream_shift_addr)
+{
+    const unsigned int subsectorSize = 0x1000;
+    std::vector<unsigned char> image;
+    std::vector<unsigned char> target(subsectorSize);
+    std::vector<unsigned char> current(subsectorSize);
+    unsigned int total = 0, skipped = 0, erased = 0, pages = 0;
+
+    int beatCount = 0;
+    XBU::ProgressBar program_flash("Programming flash", static_cast<unsigned int>(recordList.size()), XBU::is_escape_codes_disabled(), std::cout);
+    for (ELARecordList::iterator i = recordList.begin(), e = recordList.end(); i != e; ++i) {
+        program_flash.update(++beatCount);
+
+        //Shift all write addresses below bitstream guard
+        i->mStartAddress += bitstream_shift_addr;
+        i->mEndAddress += bitstream_shift_addr;
+
+        if (readRecord(mcsStream, *i, image)) {
+            program_flash.finish(false, "Could not read the block from MCS");
+            return -EINVAL;
+        }
+
+        for (uint32_t sub = i->mStartAddress & ~(subsectorSize - 1); sub < i->mEndAddress; sub += subsectorSize) {
+            ++total;
+
+            // Expected content of the subsector
+            std::fill(target.begin(), target.end(), 0xff);
+            uint32_t begin = std::max(sub, i->mStartAddress);
+            uint32_t end = std::min(sub + subsectorSize, i->mEndAddress);
+            std::memcpy(&target[begin - sub], &image[begin - i->mStartAddress], end - begin);
+
+            if (!readData(sub, current.data(), subsectorSize)) {
+                program_flash.finish(false, "Unable to read flash");
+                return -ENXIO;
+            }
+
+            if (current == target) {
+                ++skipped;
+                continue;
+            }
+
+            // Programming can only clear bits
+            bool needErase = false;
+            for (unsigned int b = 0; b < subsectorSize && !needErase; ++b)
+                needErase = (current[b] & target[b]) != target[b];
+
+            if (needErase) {
+                if (!sectorErase(sub, COMMAND_4KB_SUBSECTOR_ERASE)) {
+                    program_flash.finish(false, "Failed to erase subsector!");
+                    return -EINVAL;
+                }
+                std::fill(current.begin(), current.end(), 0xff);
+                ++erased;
+            }
+
+            for (unsigned int p = 0; p < subsectorSize; p += PAGE_SIZE) {
+                if (std::equal(&current[p], &current[p] + PAGE_SIZE, &target[p]))
+                    continue;
+                if (!programData(sub + p, &target[p], PAGE_SIZE)) {
+                    program_flash.finish(false, "Could not program the block");
+                    return -EINVAL;
+                }
+                ++pages;
+            }
+
+            if (!readData(sub, current.data(), subsectorSize) || current != target) {
+                program_flash.finish(false, "Flash verification failed");
+                return -EIO;
+            }
+        }
+    }
+    program_flash.finish(true, "Flash programmed");
+
+    std::cout << boost::format("%-8s : %u of %u subsectors unchanged, %u erased, %u pages programmed\n")
+        % "INFO" % skipped % total % erased % pages;
+    return 0;
+}
+
 bool XSPI_Flasher::readRegister(uint8_t commandCode, unsigned int bytes) {
 
     if(!isFlashReady())
@@ -2139,11 +2299,46 @@ static int mcsStreamToBin(std::istream& mcsStream, unsigned int& currentAddr,
     return 0;
 }
 
+// Write the 4KB aligned blocks of buf that differ from the flash
+// content, returns the number of bytes skipped in skipped
+static int writeChanged(std::FILE *flashDev, int index, unsigned int addr,
+    const unsigned char *buf, size_t len, size_t& skipped)
+{
+    const size_t blksz = 0x1000;
+    std::vector<unsigned char> current(len);
+    int ret = readFromFlash(flashDev, index, addr, current.data(), len);
+    if (ret)
+        return ret;
+
+    size_t i = 0;
+    while (ret == 0 && i < len) {
+        size_t blk = std::min(blksz - ((addr + i) % blksz), len - i);
+        if (std::memcmp(current.data() + i, buf + i, blk) == 0) {
+            skipped += blk;
+            i += blk;
+            continue;
+        }
+
+        // Extend to the following differing blocks
+        size_t run = blk;
+        while (i + run < len) {
+            blk = std::min(blksz, len - i - run);
+            if (std::memcmp(current.data() + i + run, buf + i + run, blk) == 0)
+                break;
+            run += blk;
+        }
+        ret = writeToFlash(flashDev, index, addr + static_cast<unsigned int>(i), buf + i, run);
+        i += run;
+    }
+    return ret;
+}
+
 static int writeBitstream(std::FILE *flashDev, int index, unsigned int addr,
-    std::vector<unsigned char>& buf)
+    std::vector<unsigned char>& buf, bool differential)
 {
     int ret = 0;
     size_t len = 0;
+    size_t skipped = 0;
 
     // Write to flash page by page and print '.' for each write
     // as progress indicator
@@ -2152,14 +2347,19 @@ static int writeBitstream(std::FILE *flashDev, int index, unsigned int addr,
         len = std::min(len, buf.size() - i);
 
         std::cout << "." << std::flush;
-        ret = writeToFlash(flashDev, index, addr + static_cast<unsigned int>(i), buf.data() + static_cast<unsigned int>(i), len);
+        if (differential)
+            ret = writeChanged(flashDev, index, addr + static_cast<unsigned int>(i), buf.data() + i, len, skipped);
+        else
+            ret = writeToFlash(flashDev, index, addr + static_cast<unsigned int>(i), buf.data() + static_cast<unsigned int>(i), len);
     }
     std::cout << std::endl;
+    if (differential && ret == 0)
+        std::cout << "Skipped " << skipped << " of " << buf.size() << " bytes that are unchanged" << std::endl;
     return ret;
 }
 
 static int programXSpiDrv(xrt_core::device *dev, std::FILE *mFlashDev, std::istream& mcsStream,
-    int index, uint32_t addressShift)
+    int index, uint32_t addressShift, bool differential)
 {
     // Parse MCS data and write each contiguous chunk to flash.
     std::vector<unsigned char> buf;
@@ -2184,7 +2384,7 @@ static int programXSpiDrv(xrt_core::device *dev, std::FILE *mFlashDev, std::istr
         }
 
         std::cout << "Writing bitstream to flash " << index << ":" << std::endl;
-        ret = writeBitstream(mFlashDev, index, curAddr + addressShift, buf);
+        ret = writeBitstream(mFlashDev, index, curAddr + addressShift, buf, differential);
         if (ret)
             return ret;
         curAddr = nextAddr;
@@ -2205,7 +2405,7 @@ int XSPI_Flasher::upgradeFirmware1Drv(std::istream& mcsStream, std::istream& str
     uint32_t bsGuardAddr;
 
     if (mcsStreamIsGolden(mcsStream))
-        return programXSpiDrv(mDev.get(), mFlashDev, mcsStream, 0, 0);
+        return programXSpiDrv(mDev.get(), mFlashDev, mcsStream, 0, 0, mDifferential);
 
     ret = bitstreamGuardAddress(mDev.get(), bsGuardAddr);
     if (ret)
@@ -2228,7 +2428,7 @@ int XSPI_Flasher::upgradeFirmware1Drv(std::istream& mcsStream, std::istream& str
     }
 
     // Write MCS
-    ret = programXSpiDrv(mDev.get(), mFlashDev, mcsStream, 0, bitstreamGuardSize);
+    ret = programXSpiDrv(mDev.get(), mFlashDev, mcsStream, 0, bitstreamGuardSize, mDifferential);
     if (ret)
         return ret;
 
@@ -2243,10 +2443,10 @@ int XSPI_Flasher::upgradeFirmware2Drv(std::istream& mcsStream0,
     uint32_t bsGuardAddr = 0;
 
     if (mcsStreamIsGolden(mcsStream0)) {
-        ret = programXSpiDrv(mDev.get(), mFlashDev, mcsStream0, 0, 0);
+        ret = programXSpiDrv(mDev.get(), mFlashDev, mcsStream0, 0, 0, mDifferential);
         if (ret)
             return ret;
-        return programXSpiDrv(mDev.get(), mFlashDev, mcsStream1, 1, 0);
+        return programXSpiDrv(mDev.get(), mFlashDev, mcsStream1, 1, 0, mDifferential);
     }
 
     ret = bitstreamGuardAddress(mDev.get(), bsGuardAddr);
@@ -2270,10 +2470,10 @@ int XSPI_Flasher::upgradeFirmware2Drv(std::istream& mcsStream0,
     }
 
     // Write MCS
-    ret = programXSpiDrv(mDev.get(), mFlashDev, mcsStream0, 0, bitstreamGuardSize);
+    ret = programXSpiDrv(mDev.get(), mFlashDev, mcsStream0, 0, bitstreamGuardSize, mDifferential);
     if (ret)
         return ret;
-    ret = programXSpiDrv(mDev.get(), mFlashDev, mcsStream1, 1, bitstreamGuardSize);
+    ret = programXSpiDrv(mDev.get(), mFlashDev, mcsStream1, 1, bitstreamGuardSize, mDifferential);
     if (ret)
         return ret;
 
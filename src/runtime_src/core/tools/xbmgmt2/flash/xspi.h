@@ -19,9 +19,22 @@
 
 #include <list>
 #include <iostream>
+#include <memory>
+#include <vector>
 #include "core/common/system.h"
 #include "core/common/device.h"
 
+// Register access of the AXI Quad SPI controller.  The flasher uses
+// the device BAR by default, a simulated controller can be plugged in
+// to exercise the flasher without a card.
+class XSPI_Regs
+{
+ public:
+  virtual ~XSPI_Regs() {}
+  virtual unsigned int read(unsigned int offset) = 0;
+  virtual void write(unsigned int offset, unsigned int value) = 0;
+};
+
 class XSPI_Flasher
 {
   struct ELARecord
@@ -39,14 +52,21 @@ class XSPI_Flasher
 
  public:
   XSPI_Flasher(std::shared_ptr<xrt_core::device> dev);
+  XSPI_Flasher(std::shared_ptr<XSPI_Regs> regs);
   ~XSPI_Flasher();
+
+  // Read back the flash and only erase and program what differs
+  // from the image, enabled by default with FLASH_DIFFERENTIAL set
+  void setDifferential(bool differential) { mDifferential = differential; }
   int xclUpgradeFirmware1(std::istream& mcsStream1, std::istream& stripped);
   int xclUpgradeFirmware2(std::istream& mcsStream1, std::istream& mcsStream2, std::istream& stripped);
   int revertToMFG(void);
 
  private:
   std::shared_ptr<xrt_core::device> mDev;
+  std::shared_ptr<XSPI_Regs> mRegs;
   std::FILE *mFlashDev = nullptr;
+  bool mDifferential = false;
 
   int parseMCS(std::istream& mcsStream);
 
@@ -64,11 +84,15 @@ class XSPI_Flasher
   bool writeEnable();
   bool getFlashId();
   bool finalTransfer(uint8_t *sendBufPtr, uint8_t *recvBufPtr, int byteCount);
-  bool writePage(unsigned int addr, uint8_t writeCmd = 0xff);
-  bool readPage(unsigned int addr, uint8_t readCmd = 0xff);
+  bool writePage(unsigned int addr, uint8_t writeCmd = 0xff, unsigned int byteCount = 128);
+  bool readPage(unsigned int addr, uint8_t readCmd = 0xff, unsigned int byteCount = 128);
+  bool readData(unsigned int addr, unsigned char* data, unsigned int size);
+  bool programData(unsigned int addr, const unsigned char* data, unsigned int size);
   bool prepareXSpi(uint8_t slave_sel);
   int programRecord(std::istream& mcsStream, const ELARecord& record);
   int programXSpi(std::istream& mcsStream, uint32_t bitstream_shift_addr);
+  int readRecord(std::istream& mcsStream, const ELARecord& record, std::vector<unsigned char>& data);
+  int programXSpiDiff(std::istream& mcsStream, uint32_t bitstream_shift_addr);
   bool readRegister(uint8_t commandCode, unsigned int bytes);
   bool writeRegister(uint8_t commandCode, unsigned int value, unsigned int bytes);
   bool setSector(unsigned int address);
@@ -0,0 +1,282 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+
+#include "xspi_sim.h"
+
+#include <algorithm>
+
+namespace {
+
+// AXI Quad SPI registers and bits used by XSPI_Flasher
+constexpr unsigned int SRR_OFFSET = 0x40;
+constexpr unsigned int CR_OFFSET  = 0x60;
+constexpr unsigned int SR_OFFSET  = 0x64;
+constexpr unsigned int DTR_OFFSET = 0x68;
+constexpr unsigned int DRR_OFFSET = 0x6C;
+constexpr unsigned int SSR_OFFSET = 0x70;
+constexpr unsigned int TFO_OFFSET = 0x74;
+constexpr unsigned int RFO_OFFSET = 0x78;
+
+constexpr uint32_t CR_ENABLE        = 0x002;
+constexpr uint32_t CR_MASTER        = 0x004;
+constexpr uint32_t CR_TXFIFO_RESET  = 0x020;
+constexpr uint32_t CR_RXFIFO_RESET  = 0x040;
+constexpr uint32_t CR_TRANS_INHIBIT = 0x100;
+constexpr uint32_t CR_RESET_STATE   = 0x180;
+
+constexpr uint32_t SR_RX_EMPTY = 0x1;
+constexpr uint32_t SR_RX_FULL  = 0x2;
+constexpr uint32_t SR_TX_EMPTY = 0x4;
+constexpr uint32_t SR_TX_FULL  = 0x8;
+
+constexpr size_t FIFO_DEPTH = 256;
+constexpr size_t SECTOR_SIZE = 16 * 1024 * 1024;
+constexpr size_t PAGE_BYTES = 256;
+
+// Typical timing of a PCIe register access, a 50MHz single line SPI
+// clock and MT25Q erase and page program
+constexpr double REG_READ_S = 1.0e-6;
+constexpr double REG_WRITE_S = 0.25e-6;
+constexpr double SPI_BYTE_S = 0.16e-6;
+constexpr double ERASE_4K_S = 0.05;
+constexpr double ERASE_64K_S = 0.15;
+constexpr double PAGE_PROGRAM_S = 0.12e-3;
+
+}
+
+double XSPI_Simulator::Stats::estimatedSeconds() const
+{
+    return regReads * REG_READ_S + regWrites * REG_WRITE_S + spiBytes * SPI_BYTE_S + flashBusySeconds;
+}
+
+XSPI_Simulator::XSPI_Simulator(unsigned int sectors)
+    : mControl(CR_RESET_STATE)
+{
+    // Capacity field of the id code, as decoded by XSPI_Flasher
+    if (sectors <= 1)      { sectors = 1;  mCapacityCode = 0x18; }
+    else if (sectors <= 2) { sectors = 2;  mCapacityCode = 0x19; }
+    else if (sectors <= 4) { sectors = 4;  mCapacityCode = 0x20; }
+    else if (sectors <= 8) { sectors = 8;  mCapacityCode = 0x21; }
+    else                   { sectors = 16; mCapacityCode = 0x22; }
+    mFlash.assign(sectors * SECTOR_SIZE, 0xff);
+}
+
+unsigned int XSPI_Simulator::read(unsigned int offset)
+{
+    ++mStats.regReads;
+    switch (offset) {
+    case CR_OFFSET:
+        return mControl;
+    case SR_OFFSET:
+    {
+        uint32_t status = 0;
+        if (mRx.empty())
+            status |= SR_RX_EMPTY;
+        if (mRx.size() >= FIFO_DEPTH)
+            status |= SR_RX_FULL;
+        if (mTx.empty())
+            status |= SR_TX_EMPTY;
+        if (mTx.size() >= FIFO_DEPTH)
+            status |= SR_TX_FULL;
+        return status;
+    }
+    case DRR_OFFSET:
+    {
+        if (mRx.empty())
+            return 0;
+        uint8_t value = mRx.front();
+        mRx.pop_front();
+        return value;
+    }
+    case SSR_OFFSET:
+        return mSlaveSelect;
+    case TFO_OFFSET:
+        return mTx.empty() ? 0 : static_cast<unsigned int>(mTx.size() - 1);
+    case RFO_OFFSET:
+        return mRx.empty() ? 0 : static_cast<unsigned int>(mRx.size() - 1);
+    default:
+        return 0;
+    }
+}
+
+void XSPI_Simulator::write(unsigned int offset, unsigned int value)
+{
+    ++mStats.regWrites;
+    switch (offset) {
+    case SRR_OFFSET:
+        mTx.clear();
+        mRx.clear();
+        mControl = CR_RESET_STATE;
+        mSlaveSelect = ~0u;
+        mCommand.clear();
+        break;
+    case CR_OFFSET:
+        if (value & CR_TXFIFO_RESET)
+            mTx.clear();
+        if (value & CR_RXFIFO_RESET)
+            mRx.clear();
+        mControl = value & ~(CR_TXFIFO_RESET | CR_RXFIFO_RESET);
+        shift();
+        break;
+    case DTR_OFFSET:
+        if (mTx.size() < FIFO_DEPTH)
+            mTx.push_back(static_cast<uint8_t>(value));
+        shift();
+        break;
+    case SSR_OFFSET:
+    {
+        bool wasSelected = (mSlaveSelect & 0x1) == 0;
+        mSlaveSelect = value;
+        bool selected = (mSlaveSelect & 0x1) == 0;
+        if (wasSelected && !selected)
+            endCommand();
+        else if (!wasSelected && selected)
+            mCommand.clear();
+        shift();
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// Shift out the transmit FIFO if the transmitter is running
+void XSPI_Simulator::shift()
+{
+    if ((mControl & (CR_ENABLE | CR_MASTER)) != (CR_ENABLE | CR_MASTER))
+        return;
+    if ((mControl & CR_TRANS_INHIBIT) || (mSlaveSelect & 0x1))
+        return;
+
+    while (!mTx.empty()) {
+        uint8_t miso = transferByte(mTx.front());
+        mTx.pop_front();
+        if (mRx.size() < FIFO_DEPTH)
+            mRx.push_back(miso);
+    }
+}
+
+uint32_t XSPI_Simulator::commandAddress() const
+{
+    uint32_t addr = (static_cast<uint32_t>(mExtendedAddress) << 24) | (mCommand[1] << 16) | (mCommand[2] << 8) | mCommand[3];
+    return static_cast<uint32_t>(addr % mFlash.size());
+}
+
+// Byte shifted out by the flash for the byte shifted in
+uint8_t XSPI_Simulator::transferByte(uint8_t mosi)
+{
+    ++mStats.spiBytes;
+    mCommand.push_back(mosi);
+    size_t idx = mCommand.size() - 1;
+    if (idx == 0)
+        return 0xff;
+
+    // Bytes between the address and the data of read commands, the
+    // quad and dual reads use the dummy byte counts of XSPI_Flasher
+    size_t dummy = 0;
+    switch (mCommand[0]) {
+    case 0x9F: // id code
+    {
+        static const uint8_t id[] = { 0x20, 0xBA };
+        if (idx <= 2)
+            return id[idx - 1];
+        return idx == 3 ? mCapacityCode : 0x10;
+    }
+    case 0x05: // status
+        return mWriteEnabled ? 0x02 : 0x00;
+    case 0x70: // flag status, ready
+        return 0x80;
+    case 0xC8: // extended address register
+        return mExtendedAddress;
+    case 0x6B:
+        dummy = 4;
+        break;
+    case 0x3B:
+    case 0xBB:
+        dummy = 2;
+        break;
+    case 0x0B:
+        dummy = 1;
+        break;
+    case 0x03:
+        break;
+    default:
+        return 0xff;
+    }
+
+    if (idx < 4 + dummy)
+        return 0xff;
+    ++mStats.readBytes;
+    return mFlash[(commandAddress() + idx - 4 - dummy) % mFlash.size()];
+}
+
+void XSPI_Simulator::endCommand()
+{
+    if (mCommand.empty())
+        return;
+    ++mStats.commands;
+
+    uint8_t cmd = mCommand[0];
+    switch (cmd) {
+    case 0x06: // write enable
+        mWriteEnabled = true;
+        break;
+    case 0x04: // write disable
+        mWriteEnabled = false;
+        break;
+    case 0xC5: // extended address register write
+        if (mCommand.size() >= 2)
+            mExtendedAddress = mCommand[1] & 0xf;
+        mWriteEnabled = false;
+        break;
+    case 0x20: // 4KB subsector erase
+    case 0x52: // 32KB subsector erase
+    case 0xD8: // sector erase
+    {
+        if (!mWriteEnabled || mCommand.size() < 4)
+            break;
+        size_t size = (cmd == 0x20) ? 0x1000 : (cmd == 0x52) ? 0x8000 : 0x10000;
+        size_t start = commandAddress() & ~(size - 1);
+        std::fill(mFlash.begin() + start, mFlash.begin() + start + size, 0xff);
+        ++mStats.erases;
+        mStats.erasedBytes += size;
+        mStats.flashBusySeconds += (cmd == 0x20) ? ERASE_4K_S : ERASE_64K_S;
+        mWriteEnabled = false;
+        break;
+    }
+    case 0xC7: // bulk erase
+        if (!mWriteEnabled)
+            break;
+        std::fill(mFlash.begin(), mFlash.end(), 0xff);
+        ++mStats.erases;
+        mStats.erasedBytes += mFlash.size();
+        mStats.flashBusySeconds += ERASE_64K_S * (mFlash.size() / 0x10000);
+        mWriteEnabled = false;
+        break;
+    case 0x02: // page program
+    case 0x32: // quad page program
+    {
+        if (!mWriteEnabled || mCommand.size() <= 4)
+            break;
+        // Programming clears bits only and wraps within the page
+        size_t addr = commandAddress();
+        size_t page = addr & ~(PAGE_BYTES - 1);
+        for (size_t i = 4; i < mCommand.size(); ++i)
+            mFlash[page + (addr - page + i - 4) % PAGE_BYTES] &= mCommand[i];
+        ++mStats.programs;
+        mStats.programmedBytes += mCommand.size() - 4;
+        mStats.flashBusySeconds += PAGE_PROGRAM_S;
+        mWriteEnabled = false;
+        break;
+    }
+    case 0x01: // register writes
+    case 0xB1:
+    case 0x81:
+    case 0x61:
+        mWriteEnabled = false;
+        break;
+    default:
+        break;
+    }
+    mCommand.clear();
+}
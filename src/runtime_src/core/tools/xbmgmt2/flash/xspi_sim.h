@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+
+#ifndef _XSPI_SIM_H_
+#define _XSPI_SIM_H_
+
+#include "xspi.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Register level model of the AXI Quad SPI controller with a serial
+// NOR flash behind slave select 0, for testing and benchmarking
+// XSPI_Flasher without a card.
+//
+// Bytes written to the transmit FIFO are shifted to the flash when the
+// transmitter is enabled with the slave selected, and the bytes shifted
+// back are queued in the receive FIFO.  A flash command ends when the
+// slave is deselected.  Erase and program take effect immediately, the
+// time they take on a card is accounted in the statistics.
+class XSPI_Simulator : public XSPI_Regs
+{
+ public:
+    struct Stats
+    {
+        uint64_t regReads = 0;
+        uint64_t regWrites = 0;
+        uint64_t spiBytes = 0;
+        uint64_t commands = 0;
+        uint64_t erases = 0;          // any erase command
+        uint64_t erasedBytes = 0;
+        uint64_t programs = 0;        // page program commands
+        uint64_t programmedBytes = 0;
+        uint64_t readBytes = 0;
+        double flashBusySeconds = 0;  // typical erase and program times
+
+        // Estimated time on a card, typical register access latency,
+        // SPI clock and flash busy time
+        double estimatedSeconds() const;
+    };
+
+    // Flash of 16MB sectors, 1 to 16 of them
+    explicit XSPI_Simulator(unsigned int sectors = 4);
+
+    unsigned int read(unsigned int offset) override;
+    void write(unsigned int offset, unsigned int value) override;
+
+    std::vector<uint8_t>& flash() { return mFlash; }
+    const Stats& stats() const { return mStats; }
+    void resetStats() { mStats = Stats(); }
+
+ private:
+    void shift();
+    uint8_t transferByte(uint8_t mosi);
+    void endCommand();
+    uint32_t commandAddress() const;
+
+    std::vector<uint8_t> mFlash;
+    uint8_t mCapacityCode;
+
+    uint32_t mControl;
+    uint32_t mSlaveSelect = ~0u;
+    std::deque<uint8_t> mTx;
+    std::deque<uint8_t> mRx;
+
+    std::vector<uint8_t> mCommand;    // bytes of the current command
+    bool mWriteEnabled = false;
+    uint8_t mExtendedAddress = 0;
+
+    Stats mStats;
+};
+
+#endif
@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+
+// Compare full and differential QSPI flash programming on the
+// simulated AXI Quad SPI controller.
+//
+// An image is programmed to blank flash, then a fraction of its 4KB
+// subsectors is changed and the changed image is programmed again,
+// once with full programming and once with differential programming
+// starting from the same flash content.  Register accesses, flash
+// operations and the estimated time on a card are reported.
+//
+// % flash_sim [-s <image KB>] [-c <changed percent>] [-a <start address>]
+
+#include "../flash/xspi.h"
+#include "../flash/xspi_sim.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const uint32_t subsector_size = 0x1000;
+
+void
+usage()
+{
+  std::cout << "usage: flash_sim [options]\n\n"
+            << "  -s <KB>       image size in KB, default 4096\n"
+            << "  -c <percent>  percentage of 4KB subsectors changed, default 5\n"
+            << "  -a <address>  start address of the image, default 0x1000000\n"
+            << "  -h            this help\n";
+}
+
+void
+write_record(std::ostream& ostr, unsigned int type, unsigned int address, const uint8_t* data, size_t count)
+{
+  unsigned int sum = count + (address >> 8) + (address & 0xff) + type;
+  ostr << ':' << std::uppercase << std::hex << std::setfill('0')
+       << std::setw(2) << count << std::setw(4) << address << std::setw(2) << type;
+  for (size_t i = 0; i < count; ++i) {
+    ostr << std::setw(2) << static_cast<unsigned int>(data[i]);
+    sum += data[i];
+  }
+  ostr << std::setw(2) << ((0x100 - (sum & 0xff)) & 0xff) << std::dec << '\n';
+}
+
+// Intel hex as written for Xilinx MCS files, 16 data bytes per line
+// and one extended linear address record per 64KB
+std::string
+to_mcs(const std::vector<uint8_t>& image, uint32_t start)
+{
+  std::ostringstream ostr;
+  for (size_t offset = 0; offset < image.size(); offset += 16) {
+    uint32_t addr = static_cast<uint32_t>(start + offset);
+    if (offset == 0 || (addr & 0xffff) == 0) {
+      uint8_t ela[] = { static_cast<uint8_t>(addr >> 24), static_cast<uint8_t>(addr >> 16) };
+      write_record(ostr, 0x04, 0, ela, sizeof(ela));
+    }
+    size_t count = std::min<size_t>(16, image.size() - offset);
+    write_record(ostr, 0x00, addr & 0xffff, &image[offset], count);
+  }
+  write_record(ostr, 0x01, 0, nullptr, 0);
+  return ostr.str();
+}
+
+struct run_result
+{
+  XSPI_Simulator::Stats stats;
+  bool verified;
+};
+
+run_result
+program(XSPI_Simulator& flash, const std::string& mcs, const std::vector<uint8_t>& image,
+        uint32_t start, bool differential)
+{
+  auto sim = std::shared_ptr<XSPI_Simulator>(&flash, [](XSPI_Simulator*) {});
+  XSPI_Flasher flasher(sim);
+  flasher.setDifferential(differential);
+  flash.resetStats();
+
+  std::istringstream mcs_stream(mcs);
+  std::istringstream stripped;
+  if (flasher.xclUpgradeFirmware1(mcs_stream, stripped))
+    throw std::runtime_error("programming failed");
+
+  // The image is shifted by the bitstream guard when not at address 0
+  uint32_t base = start ? start + subsector_size : start;
+  auto& content = flash.flash();
+  bool verified = std::equal(image.begin(), image.end(), content.begin() + base);
+  return {flash.stats(), verified};
+}
+
+void
+report(const char* name, const run_result& result)
+{
+  const auto& st = result.stats;
+  std::cout << std::left << std::setw(14) << name << std::right
+            << std::setw(12) << st.regReads
+            << std::setw(12) << st.regWrites
+            << std::setw(8) << st.erases
+            << std::setw(10) << st.programs
+            << std::setw(12) << st.readBytes
+            << std::fixed << std::setprecision(2)
+            << std::setw(12) << st.estimatedSeconds()
+            << std::setw(10) << (result.verified ? "ok" : "FAILED") << '\n';
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  size_t size_kb = 4096;
+  unsigned int changed = 5;
+  uint32_t start = 0x01000000;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-h") {
+      usage();
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    if (arg == "-s")
+      size_kb = std::stoul(argv[++i]);
+    else if (arg == "-c")
+      changed = std::stoul(argv[++i]);
+    else if (arg == "-a")
+      start = std::stoul(argv[++i], nullptr, 0);
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  if (!start || start % subsector_size || !size_kb || changed > 100) {
+    std::cout << "start address must be a non zero multiple of 4KB, changed at most 100 percent\n";
+    return 1;
+  }
+
+  std::mt19937 rng(42);
+  std::vector<uint8_t> image(size_kb * 1024);
+  for (auto& byte : image)
+    byte = static_cast<uint8_t>(rng());
+
+  try {
+    // Initial image on blank flash
+    XSPI_Simulator flash;
+    auto initial = program(flash, to_mcs(image, start), image, start, false);
+
+    // Change a few bytes in the selected subsectors
+    std::vector<uint8_t> update = image;
+    size_t subsectors = (image.size() + subsector_size - 1) / subsector_size;
+    size_t count = 0;
+    for (size_t sub = 0; sub < subsectors; ++sub) {
+      if (rng() % 100 >= changed)
+        continue;
+      ++count;
+      size_t offset = sub * subsector_size + rng() % subsector_size;
+      update[std::min(offset, update.size() - 1)] ^= 0x5a;
+    }
+    auto mcs = to_mcs(update, start);
+
+    XSPI_Simulator full_flash = flash;
+    XSPI_Simulator diff_flash = flash;
+    auto full = program(full_flash, mcs, update, start, false);
+    auto diff = program(diff_flash, mcs, update, start, true);
+
+    std::cout << "\nImage " << size_kb << " KB at 0x" << std::hex << start << std::dec
+              << ", " << count << " of " << subsectors << " subsectors changed\n\n"
+              << std::left << std::setw(14) << "run" << std::right
+              << std::setw(12) << "reg reads" << std::setw(12) << "reg writes"
+              << std::setw(8) << "erases" << std::setw(10) << "programs"
+              << std::setw(12) << "read bytes" << std::setw(12) << "est. s"
+              << std::setw(10) << "content" << '\n';
+    report("initial", initial);
+    report("full", full);
+    report("differential", diff);
+
+    return (initial.verified && full.verified && diff.verified) ? 0 : 1;
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "ERROR: " << ex.what() << '\n';
+    return 1;
+  }
+}
@@ -33,6 +33,11 @@ OO_MemRead::OO_MemRead( const std::string &_longName, bool _isHidden )
     , m_sizeBytes("")
     , m_count(0)
     , m_outputFile("")
+    , m_chunkSize("")
+    , m_threads(0)
+    , m_resume("")
+    , m_checksum(false)
+    , m_sparse(false)
     , m_help(false)
 {
   m_optionsDescription.add_options()
@@ -41,6 +46,11 @@ OO_MemRead::OO_MemRead( const std::string &_longName, bool _isHidden )
     ("address", boost::program_options::value<decltype(m_baseAddress)>(&m_baseAddress)->required(), "Base address to start from")
     ("size", boost::program_options::value<decltype(m_sizeBytes)>(&m_sizeBytes)->required(), "Size (bytes) to read")
     ("count", boost::program_options::value<decltype(m_count)>(&m_count)->default_value(1), "Number of blocks to read")
+    ("chunk-size", boost::program_options::value<decltype(m_chunkSize)>(&m_chunkSize)->default_value("4M"), "Size (bytes) of each device access")
+    ("threads", boost::program_options::value<decltype(m_threads)>(&m_threads)->default_value(4), "Number of device accesses in flight")
+    ("resume", boost::program_options::value<decltype(m_resume)>(&m_resume), "Number of bytes already in the output file, continues an interrupted read")
+    ("checksum", boost::program_options::bool_switch(&m_checksum), "Report the CRC32 of the data read")
+    ("sparse", boost::program_options::bool_switch(&m_sparse), "Leave pages of zeros as holes in the output file")
     ("help", boost::program_options::bool_switch(&m_help), "Help to use this sub-command")
   ;
 
@@ -74,7 +84,7 @@ OO_MemRead::execute(const SubCmdOptions& _options) const
     device = XBU::get_device(boost::algorithm::to_lower_copy(m_device), true /*inUserDomain*/);
 
     //-- Output file
-    if (!m_outputFile.empty() && std::filesystem::exists(m_outputFile) && !XBU::getForce())
+    if (!m_outputFile.empty() && std::filesystem::exists(m_outputFile) && !XBU::getForce() && m_resume.empty())
       throw xrt_core::error((boost::format("Output file already exists: '%s'") % m_outputFile).str());
 
   } catch (const xrt_core::error&) {
@@ -104,6 +114,22 @@ OO_MemRead::execute(const SubCmdOptions& _options) const
     XBU::throw_cancel(boost::format("Value supplied to --size is invalid: %s") % e.what());
   }
 
+  if (size == 0)
+    XBU::throw_cancel("Value for --size must be greater than 0");
+
+  xrt_core::mem_stream_options options;
+  options.threads = m_threads;
+  options.checksum = m_checksum;
+  options.sparse = m_sparse;
+  try {
+    options.chunk_size = XBUtilities::string_to_base_units(m_chunkSize, XBUtilities::unit::bytes);
+    if (!m_resume.empty())
+      options.resume_offset = XBUtilities::string_to_base_units(m_resume, XBUtilities::unit::bytes);
+  }
+  catch (const xrt_core::error& e) {
+    XBU::throw_cancel(boost::format("Value supplied to --chunk-size or --resume is invalid: %s") % e.what());
+  }
+
   XBU::verbose(boost::str(boost::format("Device: %s") % xrt_core::query::pcie_bdf::to_string(xrt_core::device_query<xrt_core::query::pcie_bdf>(device))));
   XBU::verbose(boost::str(boost::format("Address: %s") % addr));
   XBU::verbose(boost::str(boost::format("Size: %llu") % size));
@@ -114,20 +140,12 @@ OO_MemRead::execute(const SubCmdOptions& _options) const
   //read mem
   XBU::xclbin_lock xclbin_lock(device.get());
 
-  // Open the output file and write the data as we receive it
-  std::ofstream out_file(m_outputFile, std::ofstream::out | std::ofstream::binary | std::ofstream::app);
-  for(decltype(m_count) running_count = 0; running_count < m_count; running_count++) {
-    XBU::verbose(boost::str(boost::format("[%d / %d] Reading from Address: %s, Size: %s bytes") % running_count % m_count % addr % size));
-    // Get the output from the device
-    std::vector<char> data = xrt_core::device_mem_read(device.get(), addr, size);
-    // Write output to the given file
-    out_file.write(data.data(), data.size());
-    if ((out_file.rdstate() & std::ifstream::failbit) != 0)
-      throw std::runtime_error("Error writing to output file");
-    // increment the starting address by the number of bytes read
-    addr += data.size();
-  }
-  out_file.close();
+  // The blocks are contiguous, read them as one range streamed to the file
+  auto result = xrt_core::device_mem_read(device.get(), addr, m_count * size, m_outputFile, options);
+  if (m_sparse)
+    XBU::verbose(boost::str(boost::format("Skipped zero bytes: %llu") % result.skipped));
+  if (m_checksum)
+    std::cout << boost::format("CRC32: 0x%08x") % result.crc32 << std::endl;
 
   std::cout << "Memory read succeeded" << std::endl;
 }
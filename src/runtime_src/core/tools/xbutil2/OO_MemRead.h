@@ -21,6 +21,11 @@ class OO_MemRead : public OptionOptions {
    std::string m_sizeBytes;
    int m_count;
    std::string m_outputFile;
+   std::string m_chunkSize;
+   unsigned int m_threads;
+   std::string m_resume;
+   bool m_checksum;
+   bool m_sparse;
    bool m_help;
 };
 
@@ -34,6 +34,11 @@ OO_MemWrite::OO_MemWrite( const std::string &_longName, bool _isHidden)
     , m_sizeBytes("")
     , m_count(0)
     , m_fill("")
+    , m_chunkSize("")
+    , m_threads(0)
+    , m_resume("")
+    , m_checksum(false)
+    , m_sparse(false)
     , m_help(false)
 
 {
@@ -44,6 +49,11 @@ OO_MemWrite::OO_MemWrite( const std::string &_longName, bool _isHidden)
     ("size", boost::program_options::value<decltype(m_sizeBytes)>(&m_sizeBytes), "Block size (bytes) to write")
     ("count", boost::program_options::value<decltype(m_count)>(&m_count)->default_value(1), "Number of blocks to write")
     ("fill,f", boost::program_options::value<decltype(m_fill)>(&m_fill), "The byte value to fill the memory with")
+    ("chunk-size", boost::program_options::value<decltype(m_chunkSize)>(&m_chunkSize)->default_value("4M"), "Size (bytes) of each device access when writing an input file")
+    ("threads", boost::program_options::value<decltype(m_threads)>(&m_threads)->default_value(4), "Number of device accesses in flight when writing an input file")
+    ("resume", boost::program_options::value<decltype(m_resume)>(&m_resume), "Number of leading bytes of the input file already written, continues an interrupted write")
+    ("checksum", boost::program_options::bool_switch(&m_checksum), "Report the CRC32 of the data written from the input file")
+    ("sparse", boost::program_options::bool_switch(&m_sparse), "Do not write pages of zeros from the input file, the memory must be zero already")
     ("help", boost::program_options::bool_switch(&m_help), "Help to use this sub-command")
   ;
 
@@ -151,20 +161,31 @@ OO_MemWrite::execute(const SubCmdOptions& _options) const
     XBU::verbose(boost::format("Input File: %s") % m_inputFile);
     XBU::verbose(boost::format("Bytes to write: %lld") % 5);
 
+    xrt_core::mem_stream_options options;
+    options.threads = m_threads;
+    options.checksum = m_checksum;
+    options.sparse = m_sparse;
+    try {
+      options.chunk_size = XBUtilities::string_to_base_units(m_chunkSize, XBUtilities::unit::bytes);
+      if (!m_resume.empty())
+        options.resume_offset = XBUtilities::string_to_base_units(m_resume, XBUtilities::unit::bytes);
+    }
+    catch (const xrt_core::error& e) {
+      XBU::throw_cancel(boost::format("Value supplied to --chunk-size or --resume is invalid: %s") % e.what());
+    }
+
     // Write to device memory
     XBU::xclbin_lock xclbin_lock(device.get());
 
-    for (decltype(count) running_count = 0; running_count < count; running_count++) {
-      XBU::verbose(boost::format("[%d / %llu] Writing to Address: %s, Size: %llu bytes") % running_count % count % addr % size);
-      std::vector<char> buffer(size);
-      // Populate the buffer with the data to write and get the number of bytes read
-      // gcount will only return a value >= 0
-      auto input_size = static_cast<uint64_t>(input_stream.read(buffer.data(), size).gcount());
-      xrt_core::device_mem_write(device.get(), addr, buffer);
-      if (input_size != size)
-        break; // partial read and break the loop
-      addr += size;
-    }
+    // Blocks are written up to and including the block with the end of
+    // the input file, the part of that block past the end is zero
+    input_stream.close();
+    auto file_blocks = (std::filesystem::file_size(m_inputFile) + size - 1) / size;
+    auto result = xrt_core::device_mem_write(device.get(), addr, std::min(count, file_blocks) * size, m_inputFile, options);
+    if (m_sparse)
+      XBU::verbose(boost::format("Skipped zero bytes: %llu") % result.skipped);
+    if (m_checksum)
+      std::cout << boost::format("CRC32: 0x%08x") % result.crc32 << std::endl;
     std::cout << "Memory write succeeded" << std::endl;
 
     return;
@@ -270,6 +270,13 @@ namespace xdp {
     return device_db->getPowerSamples();
   }
 
+  std::vector<counters::Sample>
+  VPDynamicDatabase::movePowerSamples(uint64_t deviceId)
+  {
+    auto device_db = getDeviceDB(deviceId);
+    return device_db->movePowerSamples();
+  }
+
   void VPDynamicDatabase::addAIESample(uint64_t deviceId, double timestamp,
           const std::vector<uint64_t>& values)
   {
@@ -130,6 +130,8 @@ namespace xdp {
     // the string table it will be added
     inline uint64_t addString(const std::string& value)
     { return stringTable.addString(value); }
+    inline std::string lookupString(uint64_t id)
+    { return stringTable.lookupString(id); }
 
     // A function that iterates on the dynamic events and returns
     // copies of the events based upon the filter passed in
@@ -171,6 +173,7 @@ namespace xdp {
     XDP_CORE_EXPORT void addPowerSample(uint64_t deviceId, double timestamp,
 				   const std::vector<uint64_t>& values) ;
     XDP_CORE_EXPORT std::vector<counters::Sample> getPowerSamples(uint64_t deviceId) ;
+    XDP_CORE_EXPORT std::vector<counters::Sample> movePowerSamples(uint64_t deviceId) ;
 
     XDP_CORE_EXPORT void addAIESample(uint64_t deviceId, double timestamp,
 				   const std::vector<uint64_t>& values);
@@ -89,6 +89,8 @@ namespace xdp {
 
     inline std::vector<counters::Sample> getPowerSamples()
     { return pl_db.getPowerSamples(); }
+    inline std::vector<counters::Sample> movePowerSamples()
+    { return pl_db.movePowerSamples(); }
 
     // ****************************************************************
     // Functions to access the AIE portion of the device.  These are all
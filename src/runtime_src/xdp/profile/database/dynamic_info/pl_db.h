@@ -94,6 +94,8 @@ namespace xdp {
     { powerSamples.addSample({timestamp, values});  }
     inline std::vector<counters::Sample> getPowerSamples()
     { return powerSamples.getSamples(); }
+    inline std::vector<counters::Sample> movePowerSamples()
+    { return powerSamples.moveSamples(); }
 
     inline void setDeadlockInfo(const std::string& info)
     { deadlockInfo = info; }
@@ -24,8 +24,10 @@ namespace xdp {
   {
     std::lock_guard<std::mutex> lock(dataLock);
 
-    if (table.find(value) == table.end())
+    if (table.find(value) == table.end()) {
       table[value] = currentId++;
+      reverseTable.push_back(value);
+    }
 
     return table[value];
   }
@@ -38,4 +40,13 @@ namespace xdp {
       fout << s.second << "," << s.first.c_str() << "\n";
   }
 
+  std::string StringTable::lookupString(uint64_t id)
+  {
+    std::lock_guard<std::mutex> lock(dataLock);
+
+    if (id == 0 || id > reverseTable.size())
+      return "";
+    return reverseTable[id - 1];
+  }
+
 } // end namespace xdp
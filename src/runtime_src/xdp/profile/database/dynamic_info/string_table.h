@@ -22,6 +22,7 @@
 #include <map>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "xdp/config.h"
 
@@ -31,6 +32,7 @@ namespace xdp {
   {
   private:
     std::map<std::string, uint64_t> table;
+    std::vector<std::string> reverseTable; // Indexed by id - 1
     uint64_t currentId = 1; // Start at 1 so we can use 0 as a special value
 
     std::mutex dataLock; // Protects "table" map and currentId
@@ -40,6 +42,7 @@ namespace xdp {
 
     XDP_CORE_EXPORT uint64_t addString(const std::string& value);
     XDP_CORE_EXPORT void dumpTable(std::ofstream& fout);
+    XDP_CORE_EXPORT std::string lookupString(uint64_t id);
   };
 
 } // end namespace xdp
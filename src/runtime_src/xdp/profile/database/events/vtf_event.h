@@ -102,6 +102,7 @@ namespace xdp {
     inline uint64_t     getEventId()            { return id ; }
     inline void         setEventId(uint64_t i)  { id = i ; }
     inline VTFEventType getEventType()          { return type; }
+    inline uint64_t     getStartId()            { return start_id ; }
 
     // Functions that can be used as filters
     virtual bool isUserEvent()       { return false ; }
@@ -159,6 +160,7 @@ namespace xdp {
     XDP_CORE_EXPORT ~APICall() ;
 
     virtual bool isHostEvent() { return true ; } 
+    inline uint64_t getFunctionName() { return functionName ; }
   } ;
  
 }
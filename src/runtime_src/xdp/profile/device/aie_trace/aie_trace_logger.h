@@ -30,6 +30,9 @@ public:
   virtual ~AIETraceLogger() {}
 
   virtual void addAIETraceData(uint64_t strmIndex, void* buffer, uint64_t bufferSz, bool copy) = 0;
+
+  // Wait until all data added so far is stored
+  virtual void flush() {}
 };
 
 }
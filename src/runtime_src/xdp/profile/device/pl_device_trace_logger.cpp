@@ -748,7 +748,7 @@ namespace xdp {
     // Note: This needs to be done only in beginning chunk of data
     static bool found = false;
     if (!found) {
-      for (uint64_t i = 0; i < numPackets - 8; ++i) {
+      for (uint64_t i = 0; i + 8 < numPackets; ++i) {
         for (uint64_t j = i; j < i + 8; ++j) {
           uint64_t packet = (static_cast<uint64_t*>(data))[j];
           if (!isClockTraining(packet))
@@ -81,6 +81,9 @@ Please increase trace_buffer_size and trace_buffer_offload_interval together or
 #define AIE_MIN_SIZE_CIRCULAR_BUF 0x800000
 #define AIE_TRACE_REUSE_MAX_STREAMS 4
 #define AIE_TRACE_REUSE_MAX_OFFLOAD_INT_US 100
+// Host buffers of the streaming AIE trace logger
+#define AIE_TRACE_STREAM_NUM_BUFFERS 16
+#define AIE_TRACE_STREAM_BUFFER_SIZE 0x100000
 
 #define AIE_TRACE_UNAVAILABLE "Neither PLIO nor GMIO trace infrastucture is found in the given design. So, AIE event trace will not be available."
 #define AIE_TRACE_BUF_ALLOC_FAIL              "Allocation of buffer for AIE trace failed. AIE trace will not be available."
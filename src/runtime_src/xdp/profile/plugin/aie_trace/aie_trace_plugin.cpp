@@ -27,6 +27,7 @@
 #include "xdp/profile/device/utility.h"
 #include "xdp/profile/plugin/vp_base/info.h"
 #include "xdp/profile/writer/aie_trace/aie_trace_config_writer.h"
+#include "xdp/profile/writer/aie_trace/aie_trace_stream_logger.h"
 #include "xdp/profile/writer/aie_trace/aie_trace_timestamps_writer.h"
 #include "xdp/profile/writer/aie_trace/aie_trace_writer.h"
 
@@ -202,10 +203,12 @@ void AieTracePluginUnified::updateAIEDevice(void *handle) {
   }
 
   // Add writer for every stream
+  bool streamToFile = xrt_core::config::get_aie_trace_settings_stream_to_file();
+  std::vector<AIETraceWriter *> streamWriters;
   for (uint64_t n = 0; n < AIEData.metadata->getNumStreams(); ++n) {
     std::string fileName = "aie_trace_" + std::to_string(deviceID) + "_" +
                            std::to_string(n) + ".txt";
-    VPWriter *writer = new AIETraceWriter(
+    auto writer = new AIETraceWriter(
       fileName.c_str(),
       deviceID,
       n,  // stream id
@@ -215,6 +218,7 @@ void AieTracePluginUnified::updateAIEDevice(void *handle) {
       ""  // tool version
     );
     writers.push_back(writer);
+    streamWriters.push_back(writer);
     db->getStaticInfo().addOpenedFile(writer->getcurrentFileName(),
                                       "AIE_EVENT_TRACE");
 
@@ -227,7 +231,8 @@ void AieTracePluginUnified::updateAIEDevice(void *handle) {
   uint64_t aieTraceBufSize = GetTS2MMBufSize(true /*isAIETrace*/);
   bool isPLIO = (db->getStaticInfo()).getNumTracePLIO(deviceID) ? true : false;
 
-  if (AIEData.metadata->getContinuousTrace())
+  // Streamed trace is written by the logger, not by the write thread
+  if (AIEData.metadata->getContinuousTrace() && !streamToFile)
     XDPPlugin::startWriteThread(AIEData.metadata->getFileDumpIntS(),
                                 "AIE_EVENT_TRACE", false);
 
@@ -255,7 +260,12 @@ void AieTracePluginUnified::updateAIEDevice(void *handle) {
   aieTraceBufSize = AIEData.implementation->checkTraceBufSize(aieTraceBufSize);
 
   // Create AIE Trace Offloader
-  AIEData.logger = std::make_unique<AIETraceDataLogger>(deviceID);
+  if (streamToFile)
+    AIEData.logger = std::make_unique<AIETraceStreamLogger>(
+        deviceID, std::move(streamWriters), AIE_TRACE_STREAM_NUM_BUFFERS,
+        AIE_TRACE_STREAM_BUFFER_SIZE);
+  else
+    AIEData.logger = std::make_unique<AIETraceDataLogger>(deviceID);
 
   if (xrt_core::config::get_verbosity() >=
       static_cast<uint32_t>(severity_level::debug)) {
@@ -364,7 +374,8 @@ void AieTracePluginUnified::pollAIETimers(uint64_t index, void *handle) {
 }
 
 void AieTracePluginUnified::flushOffloader(
-    const std::unique_ptr<AIETraceOffload> &offloader, bool warn) {
+    const std::unique_ptr<AIETraceOffload> &offloader,
+    const std::unique_ptr<AIETraceLogger> &logger, bool warn) {
   if (offloader->continuousTrace()) {
     offloader->stopOffload();
 
@@ -374,6 +385,7 @@ void AieTracePluginUnified::flushOffloader(
     offloader->readTrace(true);
     offloader->endReadTrace();
   }
+  logger->flush();
 
   if (warn && offloader->isTraceBufferFull())
     xrt_core::message::send(severity_level::warning, "XRT",
@@ -396,7 +408,7 @@ void AieTracePluginUnified::flushAIEDevice(void *handle) {
 
   // Flush AIE then datamovers
   AIEData.implementation->flushTraceModules();
-  flushOffloader(AIEData.offloader, false);
+  flushOffloader(AIEData.offloader, AIEData.logger, false);
 }
 
 void AieTracePluginUnified::finishFlushAIEDevice(void *handle) {
@@ -425,7 +437,7 @@ void AieTracePluginUnified::finishFlushAIEDevice(void *handle) {
 
   // Flush AIE then datamovers
   AIEData.implementation->flushTraceModules();
-  flushOffloader(AIEData.offloader, true);
+  flushOffloader(AIEData.offloader, AIEData.logger, true);
   XDPPlugin::endWrite();
 
   handleToAIEData.erase(itr);
@@ -444,7 +456,7 @@ void AieTracePluginUnified::writeAll(bool openNewFiles) {
 
     if (AIEData.valid) {
       AIEData.implementation->flushTraceModules();
-      flushOffloader(AIEData.offloader, true);
+      flushOffloader(AIEData.offloader, AIEData.logger, true);
     }
   }
 
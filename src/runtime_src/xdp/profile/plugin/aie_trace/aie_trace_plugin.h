@@ -47,6 +47,7 @@ private:
   uint64_t getDeviceIDFromHandle(void *handle);
   void pollAIETimers(uint64_t index, void *handle);
   void flushOffloader(const std::unique_ptr<AIETraceOffload> &offloader,
+                      const std::unique_ptr<AIETraceLogger> &logger,
                       bool warn);
   void endPoll();
 
@@ -56,8 +57,9 @@ private:
     uint64_t deviceID;
     bool valid;
 
-    std::unique_ptr<AIETraceOffload> offloader;
+    // Logger is declared first so that it outlives the offloader
     std::unique_ptr<AIETraceLogger> logger;
+    std::unique_ptr<AIETraceOffload> offloader;
     std::unique_ptr<AieTraceImpl> implementation;
     std::shared_ptr<AieTraceMetadata> metadata;
     std::atomic<bool> threadCtrlBool;
@@ -28,6 +28,7 @@
 #include "xdp/profile/plugin/vp_base/utility.h"
 #include "xdp/profile/plugin/vp_base/info.h"
 #include "xdp/profile/writer/device_trace/device_trace_writer.h"
+#include "xdp/profile/writer/vp_base/chrome_trace_writer.h"
 #include "xdp/profile/device/pl_device_trace_logger.h"
 #include "xdp/profile/device/tracedefs.h"
 
@@ -133,6 +134,19 @@ namespace xdp {
     std::string xrtVersion   = xdp::getXRTVersion() ;
     std::string toolVersion  = xdp::getToolVersion() ;
 
+    if (xrt_core::config::get_trace_file_format() == "json") {
+      std::string filename =
+        "device_trace_" + std::to_string(deviceId) + ".json" ;
+      VPWriter* writer = new ChromeTraceWriter(filename.c_str(), deviceId) ;
+      writers.push_back(writer) ;
+      trace_file_type = "CHROME_TRACE" ;
+      (db->getStaticInfo()).addOpenedFile(writer->getcurrentFileName(), trace_file_type) ;
+
+      if (continuous_trace)
+        XDPPlugin::startWriteThread(XDPPlugin::get_trace_file_dump_int_s(), trace_file_type);
+      return ;
+    }
+
     std::string filename = 
       "device_trace_" + std::to_string(deviceId) + ".csv" ;
 
@@ -143,10 +157,10 @@ namespace xdp {
                                              xrtVersion,
                                              toolVersion);
     writers.push_back(writer);
-    (db->getStaticInfo()).addOpenedFile(writer->getcurrentFileName(), "VP_TRACE") ;
+    (db->getStaticInfo()).addOpenedFile(writer->getcurrentFileName(), trace_file_type) ;
 
     if (continuous_trace)
-      XDPPlugin::startWriteThread(XDPPlugin::get_trace_file_dump_int_s(), "VP_TRACE");
+      XDPPlugin::startWriteThread(XDPPlugin::get_trace_file_dump_int_s(), trace_file_type);
   }
 
   void PLDeviceOffloadPlugin::configureDataflow(uint64_t deviceId,
@@ -448,7 +462,7 @@ namespace xdp {
       break ;
     case VPDatabase::DUMP_TRACE:
       {
-        XDPPlugin::trySafeWrite("VP_TRACE", true);
+        XDPPlugin::trySafeWrite(trace_file_type, true);
       }
       break ;
     default:
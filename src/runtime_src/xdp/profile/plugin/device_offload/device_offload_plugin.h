@@ -51,6 +51,10 @@ namespace xdp {
     unsigned int trace_buffer_offload_interval_ms ;
     bool m_enable_circular_buffer = false;
 
+    // Type under which trace files are registered, which depends on
+    //  the trace file format of the writers
+    std::string trace_file_type = "VP_TRACE";
+
   protected:
     // Each device offload plugin is responsible for offloading
     //  information from all devices.  This holds all the objects
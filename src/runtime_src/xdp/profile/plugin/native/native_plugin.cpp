@@ -17,9 +17,12 @@
 
 #define XDP_PLUGIN_SOURCE
 
+#include "core/common/config_reader.h"
+
 #include "xdp/profile/plugin/native/native_plugin.h"
 #include "xdp/profile/writer/native/native_writer.h"
 #include "xdp/profile/plugin/vp_base/info.h"
+#include "xdp/profile/writer/vp_base/chrome_trace_writer.h"
 
 namespace xdp {
 
@@ -32,6 +35,17 @@ namespace xdp {
     db->registerPlugin(this) ;
     db->registerInfo(info::native) ;
 
+    if (xrt_core::config::get_trace_file_format() == "json") {
+      // The JSON trace is appended to while the application runs
+      VPWriter* writer = new ChromeTraceWriter("native_trace.json") ;
+      writers.push_back(writer) ;
+      (db->getStaticInfo()).addOpenedFile(writer->getcurrentFileName(), "CHROME_TRACE") ;
+
+      streaming = true ;
+      XDPPlugin::startWriteThread(XDPPlugin::get_trace_file_dump_int_s(), "CHROME_TRACE") ;
+      return ;
+    }
+
     VPWriter* writer = new NativeTraceWriter("native_trace.csv") ;
     writers.push_back(writer) ;
 
@@ -47,8 +61,13 @@ namespace xdp {
 
       // We were destroyed before the database, so write the writers
       //  and unregister ourselves from the database
-      for (auto w : writers) {
-        w->write(false) ;
+      if (streaming) {
+        XDPPlugin::endWrite() ;
+      }
+      else {
+        for (auto w : writers) {
+          w->write(false) ;
+        }
       }
       db->unregisterPlugin(this) ;
     }
@@ -25,6 +25,7 @@ namespace xdp {
   {
   private:
     static bool live;
+    bool streaming = false;
   public:
     NativeProfilingPlugin() ;
     ~NativeProfilingPlugin() ;
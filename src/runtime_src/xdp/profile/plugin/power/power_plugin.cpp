@@ -17,6 +17,8 @@
 
 #define XDP_PLUGIN_SOURCE
 
+#include <algorithm>
+#include <chrono>
 #include <map>
 #include <string>
 
@@ -33,15 +35,84 @@
 #include "xdp/profile/plugin/vp_base/info.h"
 #include "xdp/profile/device/utility.h"
 
+namespace {
+
+  using sensorReader = uint64_t (*)(const std::shared_ptr<xrt_core::device>&) ;
+
+  template <typename QueryRequestType>
+  uint64_t readSensor(const std::shared_ptr<xrt_core::device>& device)
+  {
+    return xrt_core::device_query<QueryRequestType>(device) ;
+  }
+
+  // One entry per column of the power profile output
+  const std::array<sensorReader, xdp::numPowerSensors> sensorReaders = {
+    &readSensor<xrt_core::query::v12v_aux_milliamps>,
+    &readSensor<xrt_core::query::v12v_aux_millivolts>,
+    &readSensor<xrt_core::query::v12v_pex_milliamps>,
+    &readSensor<xrt_core::query::v12v_pex_millivolts>,
+    &readSensor<xrt_core::query::int_vcc_milliamps>,
+    &readSensor<xrt_core::query::int_vcc_millivolts>,
+    &readSensor<xrt_core::query::v3v3_pex_milliamps>,
+    &readSensor<xrt_core::query::v3v3_pex_millivolts>,
+    &readSensor<xrt_core::query::cage_temp_0>,
+    &readSensor<xrt_core::query::cage_temp_1>,
+    &readSensor<xrt_core::query::cage_temp_2>,
+    &readSensor<xrt_core::query::cage_temp_3>,
+    &readSensor<xrt_core::query::dimm_temp_0>,
+    &readSensor<xrt_core::query::dimm_temp_1>,
+    &readSensor<xrt_core::query::dimm_temp_2>,
+    &readSensor<xrt_core::query::dimm_temp_3>,
+    &readSensor<xrt_core::query::fan_trigger_critical_temp>,
+    &readSensor<xrt_core::query::temp_fpga>,
+    &readSensor<xrt_core::query::hbm_temp>,
+    &readSensor<xrt_core::query::temp_card_top_front>,
+    &readSensor<xrt_core::query::temp_card_top_rear>,
+    &readSensor<xrt_core::query::temp_card_bottom_front>,
+    &readSensor<xrt_core::query::int_vcc_temp>,
+    &readSensor<xrt_core::query::fan_speed_rpm>
+  } ;
+
+} // end anonymous namespace
+
 namespace xdp {
 
+  PowerSampleBuffer::PowerSampleBuffer(std::size_t capacity)
+  {
+    capacity = std::max<std::size_t>(capacity, 1) ;
+    timestamps.resize(capacity) ;
+    values.resize(capacity) ;
+  }
+
+  void PowerSampleBuffer::addReading(double timestamp,
+                                     const PowerSensorValues& reading)
+  {
+    // The owner flushes a full buffer before adding more readings
+    if (full())
+      return ;
+
+    timestamps[count] = timestamp ;
+    values[count] = reading ;
+    ++count ;
+  }
+
+  void PowerSampleBuffer::flush(VPDatabase* db, uint64_t deviceIndex)
+  {
+    for (std::size_t i = 0 ; i < count ; ++i) {
+      std::vector<uint64_t> sample(values[i].begin(), values[i].end()) ;
+      (db->getDynamicInfo()).addPowerSample(deviceIndex, timestamps[i], sample) ;
+    }
+    count = 0 ;
+  }
+
   PowerProfilingPlugin::PowerProfilingPlugin() :
     XDPPlugin(), keepPolling(true), pollingInterval(20)
   {
     db->registerPlugin(this) ;
     db->registerInfo(info::power) ;
 
-    pollingInterval = xrt_core::config::get_power_profile_interval_ms() ;
+    pollingInterval = std::max(1u, xrt_core::config::get_power_profile_interval_ms()) ;
+    auto maxSamples = xrt_core::config::get_power_profile_max_samples() ;
 
     // There can be multiple boards with the same shell loaded as well as
     //  different boards.  We number them all individually.
@@ -52,6 +123,7 @@ namespace xdp {
    while (index < numDevices) {
      try {
        xrtDevices.push_back(std::make_unique<xrt::device>(index));
+       sensors.emplace_back(maxSamples);
        auto ownedHandle = xrtDevices[index]->get_handle()->get_device_handle();
 
         // Determine the name of the device
@@ -89,101 +161,106 @@ namespace xdp {
   PowerProfilingPlugin::~PowerProfilingPlugin()
   {
     // Stop the polling thread
-    keepPolling = false ;
+    {
+      std::lock_guard<std::mutex> lock(pollLock) ;
+      keepPolling = false ;
+    }
+    pollCondition.notify_all() ;
     pollingThread.join() ;
 
     if (VPDatabase::alive())
     {
-      for (auto w : writers)
-      {
-        w->write(false) ;
-      }
-
+      writeSamples(false) ;
       db->unregisterPlugin(this) ;
     }
   }
 
+  // Move the buffered samples of all devices into the database and
+  //  have the writers append them to the output files
+  void PowerProfilingPlugin::writeSamples(bool openNewFiles)
+  {
+    std::lock_guard<std::mutex> lock(writeLock) ;
+    for (uint64_t index = 0 ; index < sensors.size() ; ++index)
+      sensors[index].samples.flush(db, index) ;
+
+    for (auto w : writers)
+      w->write(openNewFiles) ;
+  }
+
+  void PowerProfilingPlugin::writeAll(bool openNewFiles)
+  {
+    writeSamples(openNewFiles) ;
+  }
+
+  void PowerProfilingPlugin::readSensors(const std::shared_ptr<xrt_core::device>& device,
+                                         DeviceSensors& state,
+                                         PowerSensorValues& reading)
+  {
+    // Read every sensor of the device in a single pass.  Sensors that
+    //  report no_such_key are not implemented and are left at zero so
+    //  the remaining columns stay aligned.
+    for (std::size_t s = 0 ; s < numPowerSensors ; ++s) {
+      if (!state.supported.test(s))
+        continue ;
+      try {
+        reading[s] = sensorReaders[s](device) ;
+      }
+      catch (const xrt_core::query::no_such_key&) {
+        //query is not implemented
+        state.supported.reset(s) ;
+      }
+      catch (const std::exception&) {
+        // error retrieving information
+        if (!state.warned) {
+          std::string msg = "Error while retrieving data from power files. Using default value.";
+          xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", msg);
+          state.warned = true ;
+        }
+      }
+    }
+  }
+
   void PowerProfilingPlugin::pollPower()
   {
+    auto interval = std::chrono::milliseconds(pollingInterval) ;
+    auto deadline = std::chrono::steady_clock::now() ;
+    PowerSensorValues reading ;
+
     while(keepPolling)
     {
       // Get timestamp in milliseconds
       double timestamp = xrt_core::time_ns() / 1.0e6 ;
-      uint64_t index = 0 ;
 
-      for(auto& xrtDevice : xrtDevices)
+      bool full = false ;
+      for (uint64_t index = 0 ; index < xrtDevices.size() ; ++index)
       {
-        std::vector<uint64_t> values ;
-        std::shared_ptr<xrt_core::device> coreDevice = xrtDevice->get_handle();
-        
-        if (!coreDevice) {
-          ++index;
+        std::shared_ptr<xrt_core::device> coreDevice = xrtDevices[index]->get_handle();
+        if (!coreDevice)
           continue;
-        }
 
-        try{
-          uint64_t data = 0;
-          data = xrt_core::device_query<xrt_core::query::v12v_aux_milliamps>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::v12v_aux_millivolts>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::v12v_pex_milliamps>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::v12v_pex_millivolts>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::int_vcc_milliamps>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::int_vcc_millivolts>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::v3v3_pex_milliamps>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::v3v3_pex_millivolts>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::cage_temp_0>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::cage_temp_1>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::cage_temp_2>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::cage_temp_3>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::dimm_temp_0>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::dimm_temp_1>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::dimm_temp_2>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::dimm_temp_3>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::fan_trigger_critical_temp>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::temp_fpga>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::hbm_temp>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::temp_card_top_front>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::temp_card_top_rear>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::temp_card_bottom_front>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::int_vcc_temp>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::fan_speed_rpm>(coreDevice); 
-          values.push_back(data);
-        }
-        catch (const xrt_core::query::no_such_key&) {
-          //query is not implemented
-        }
-        catch (const std::exception&) {
-          // error retrieving information
-          std::string msg = "Error while retrieving data from power files. Using default value.";
-          xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", msg);
-        }
-        (db->getDynamicInfo()).addPowerSample(index, timestamp, values) ;
-        ++index ;
+        reading.fill(0) ;
+        readSensors(coreDevice, sensors[index], reading) ;
+
+        std::lock_guard<std::mutex> lock(writeLock) ;
+        sensors[index].samples.addReading(timestamp, reading) ;
+        full = full || sensors[index].samples.full() ;
       }
-      std::this_thread::sleep_for(std::chrono::milliseconds(pollingInterval)) ;
+
+      // Hand the samples to the writers before the next pass, rather
+      //  than waiting for the end of the run
+      if (full)
+        writeSamples(false) ;
+
+      // Sleep until an absolute deadline so the time spent reading the
+      //  sensors does not add to the interval.  If a pass overran one or
+      //  more intervals, skip them rather than sampling back to back.
+      auto now = std::chrono::steady_clock::now() ;
+      do {
+        deadline += interval ;
+      } while (deadline <= now) ;
+
+      std::unique_lock<std::mutex> lock(pollLock) ;
+      pollCondition.wait_until(lock, deadline, [this] { return !keepPolling ; }) ;
     }
   }
 
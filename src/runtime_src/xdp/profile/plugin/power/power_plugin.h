@@ -18,33 +18,93 @@
 #ifndef POWER_PROFILING_DOT_H
 #define POWER_PROFILING_DOT_H
 
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <thread>
 
 #include "xdp/profile/plugin/vp_base/vp_base_plugin.h"
 
+namespace xrt_core {
+  class device;
+}
+
 namespace xdp {
 
+  // Number of power and thermal sensors read from each device per sample.
+  //  The order matches the columns written by the PowerProfilingWriter.
+  constexpr std::size_t numPowerSensors = 24 ;
+  using PowerSensorValues = std::array<uint64_t, numPowerSensors> ;
+
+  // Fixed capacity storage of power samples for a single device.  All
+  //  memory is allocated up front.  The plugin moves the samples to the
+  //  writer whenever the buffer fills up and on every write request, so
+  //  memory use does not grow with the length of the run.
+  class PowerSampleBuffer
+  {
+  private:
+    std::vector<double> timestamps ;
+    std::vector<PowerSensorValues> values ;
+    std::size_t count = 0 ;
+  public:
+    explicit PowerSampleBuffer(std::size_t capacity) ;
+
+    void addReading(double timestamp, const PowerSensorValues& reading) ;
+    inline std::size_t size() const { return count ; }
+    inline bool full() const { return count == values.size() ; }
+
+    // Move the stored samples into the database for the writer
+    void flush(VPDatabase* db, uint64_t deviceIndex) ;
+  } ;
+
   class PowerProfilingPlugin : public XDPPlugin
   {
   private:
     // These are the files that will be opened and read
     static const char* powerFiles[] ;
 
+    // Per device sensor state.  Sensors that are not implemented on
+    //  a device are discovered on the first sample and skipped after.
+    struct DeviceSensors
+    {
+      std::bitset<numPowerSensors> supported ;
+      bool warned = false ;
+      PowerSampleBuffer samples ;
+
+      explicit DeviceSensors(std::size_t capacity)
+        : samples(capacity)
+      { supported.set() ; }
+    } ;
+
   private:
     std::vector<std::unique_ptr<xrt::device>> xrtDevices;
+    std::vector<DeviceSensors> sensors ;
+
+    // Serializes moving samples from the buffers through the writers
+    //  between the polling thread and write requests
+    std::mutex writeLock ;
+    void writeSamples(bool openNewFiles) ;
 
     // Power profiling requires its own thread
-    bool keepPolling ;
+    std::atomic<bool> keepPolling ;
+    std::mutex pollLock ;
+    std::condition_variable pollCondition ;
     std::thread pollingThread ;
     unsigned int pollingInterval ;
     void pollPower() ;
+    void readSensors(const std::shared_ptr<xrt_core::device>& device,
+                     DeviceSensors& state, PowerSensorValues& reading) ;
   public:
     PowerProfilingPlugin() ;
     ~PowerProfilingPlugin() ;
 
     void addDevice(void* handle) ;
+    virtual void writeAll(bool openNewFiles) override ;
   } ;
 
 } // end namespace xdp
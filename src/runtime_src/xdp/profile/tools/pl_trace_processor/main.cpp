@@ -14,31 +14,178 @@
  * under the License.
  */
 
-#include <fstream>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "xdp/profile/database/database.h"
 #include "xdp/profile/device/pl_device_trace_logger.h"
+#include "xdp/profile/plugin/vp_base/utility.h"
 #include "xdp/profile/writer/device_trace/device_trace_writer.h"
 
+// The raw trace file is memory mapped and split into fixed size chunks.
+// A single PLDeviceTraceLogger decodes the chunks in file order, since
+// it matches start and end packets and keeps all per-monitor state
+// (open CU executions, stalls, outstanding transactions, clock
+// training) across calls.  The kernel reads ahead of the decoder: the
+// mapping is advised as sequential and the next chunk is requested
+// before the current one is decoded.  Decoded events are periodically
+// flushed to disk and released from the database, and pages already
+// decoded are dropped, so memory use is bounded by the chunk size
+// rather than the size of the trace.
+namespace {
+
+constexpr uint64_t packet_size = sizeof(uint64_t);
+constexpr uint64_t default_chunk_mb = 64;
+constexpr uint64_t default_flush_chunks = 16;
+
+struct chunk
+{
+  uint64_t offset = 0;     // byte offset in file
+  uint64_t size = 0;       // bytes, always a multiple of packet_size
+};
+
+// Read-only mapping of the whole trace file.  Pages are read ahead
+// as requested and released again once decoded.
+class mapped_file
+{
+  int fd = -1;
+  void* addr = MAP_FAILED;
+  uint64_t length = 0;
+
+public:
+  explicit
+  mapped_file(const std::string& path)
+  {
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+      return;
+
+    length = static_cast<uint64_t>(st.st_size);
+    addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED)
+      madvise(addr, length, MADV_SEQUENTIAL);
+  }
+
+  ~mapped_file()
+  {
+    if (addr != MAP_FAILED)
+      munmap(addr, length);
+    if (fd >= 0)
+      close(fd);
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  bool
+  valid() const
+  {
+    return addr != MAP_FAILED;
+  }
+
+  uint64_t
+  size() const
+  {
+    return length;
+  }
+
+  const uint64_t*
+  packets(uint64_t offset) const
+  {
+    return reinterpret_cast<const uint64_t*>(static_cast<const char*>(addr) + offset);
+  }
+
+  // Offsets are page aligned by construction of the chunks
+  void
+  prefetch(uint64_t offset, uint64_t size) const
+  {
+    madvise(static_cast<char*>(addr) + offset, size, MADV_WILLNEED);
+  }
+
+  void
+  release(uint64_t offset, uint64_t size) const
+  {
+    madvise(static_cast<char*>(addr) + offset, size, MADV_DONTNEED);
+  }
+};
+
+// Split the file at packet boundaries.  Chunk sizes are multiples of
+// the page size so that decoded chunks can be released individually.
+// A trailing partial packet is ignored, as with the previous reader.
+std::vector<chunk>
+make_chunks(uint64_t file_size, uint64_t chunk_size)
+{
+  std::vector<chunk> chunks;
+  uint64_t usable = file_size - (file_size % packet_size);
+  for (uint64_t offset = 0; offset < usable; offset += chunk_size) {
+    chunk c;
+    c.offset = offset;
+    c.size = std::min(chunk_size, usable - offset);
+    chunks.push_back(c);
+  }
+  return chunks;
+}
+
+void
+usage(const char* exe)
+{
+  std::cout << "Usage: " << exe
+            << " <Raw Trace File> <Xclbin> [chunk size MB] [chunks per output file]\n";
+}
+
+} // namespace
+
 int main(int argc, char* argv[])
 {
-  if (argc != 3) {
-    std::cout << "Usage: " << argv[0] << " <Raw Trace File> <Xclbin>\n";
+  if (argc < 3 || argc > 5) {
+    usage(argv[0]);
     return 0;
   }
 
   std::string traceFile  = argv[1];
   std::string xclbinFile = argv[2];
 
-  std::ifstream fin(traceFile, std::ios::binary|std::ios::in);
-  if (!fin) {
+  uint64_t chunkMB = default_chunk_mb;
+  uint64_t flushChunks = default_flush_chunks;
+  try {
+    if (argc > 3)
+      chunkMB = std::stoull(argv[3]);
+    if (argc > 4)
+      flushChunks = std::stoull(argv[4]);
+  }
+  catch (const std::exception&) {
+    usage(argv[0]);
+    return 0;
+  }
+  if (chunkMB == 0) {
+    usage(argv[0]);
+    return 0;
+  }
+
+  mapped_file trace(traceFile);
+  if (!trace.valid()) {
     std::cerr << "Cannot open raw trace file " << traceFile << std::endl;
     return 0;
   }
 
+  // Chunks must be page aligned so they can be released after decoding
+  auto pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  uint64_t chunkSize = chunkMB * 1024 * 1024;
+  chunkSize = std::max(pageSize, chunkSize - (chunkSize % pageSize));
+  auto chunks = make_chunks(trace.size(), chunkSize);
+
   // Create a database to store and interpret the events
   xdp::VPDatabase* db = xdp::VPDatabase::Instance();
 
@@ -47,27 +194,45 @@ int main(int argc, char* argv[])
 
   db->getStaticInfo().updateDevice(deviceId, xclbinFile);
 
-  std::vector<uint64_t> traceData;
+  xdp::PLDeviceTraceLogger logger(deviceId);
+  xdp::DeviceTraceWriter writer("output.csv", deviceId, "1.1", xdp::getCurrentDateTime(), xdp::getXRTVersion(), xdp::getToolVersion());
 
-  uint64_t packet = 0;
-  char* ch = reinterpret_cast<char*>(&packet);
+  auto startTime = std::chrono::steady_clock::now();
+  uint64_t filesWritten = 0;
 
-  while(fin.read(ch, 8)) {
-    traceData.push_back(packet);
-  }
-  fin.close();
+  for (uint64_t i = 0; i < chunks.size(); ++i) {
+    const auto& c = chunks[i];
 
-  // Add all of the events to the database
-  xdp::PLDeviceTraceLogger logger(deviceId);
-  uint64_t numBytes = sizeof(uint64_t)*traceData.size();
-  logger.processTraceData(traceData.data(), numBytes);
+    // Read the next chunk while this one is decoded
+    if (i + 1 < chunks.size())
+      trace.prefetch(chunks[i + 1].offset, chunks[i + 1].size);
 
-  // Create a writer and have it write.
-  xdp::DeviceTraceWriter writer("output.csv", deviceId, "1.1", xdp::getCurrentDateTime(), xdp::getXRTVersion(), xdp::getToolVersion());
+    // The logger does not modify the data even though the interface
+    // is not const qualified
+    logger.processTraceData(const_cast<uint64_t*>(trace.packets(c.offset)), c.size);
+    trace.release(c.offset, c.size);
+
+    // Move decoded events out of the database and into the next
+    // output file.  Events still waiting for their end packet stay
+    // in the logger and are completed by a later chunk.
+    bool last = (i + 1 == chunks.size());
+    if (!last && flushChunks && ((i + 1) % flushChunks == 0) && writer.write(true))
+      ++filesWritten;
+  }
+
+  logger.endProcessTraceData();
   writer.write(false);
+  ++filesWritten;
 
-  fin.close();
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  double mb = static_cast<double>(trace.size()) / (1024.0 * 1024.0);
+  uint64_t numPackets = trace.size() / packet_size;
+
+  std::cout << "Processed " << numPackets << " packets (" << mb << " MB) in "
+            << chunks.size() << " chunks\n"
+            << "  output files: " << filesWritten << "\n"
+            << "  elapsed: " << elapsed << " s, throughput: "
+            << (elapsed > 0 ? mb / elapsed : 0.0) << " MB/s\n";
 
   return 0;
 }
-
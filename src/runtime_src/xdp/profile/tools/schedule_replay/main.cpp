@@ -0,0 +1,675 @@
+/**
+ * Copyright (C) 2026 Advanced Micro Devices, Inc. - All rights reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Offline what-if analysis of the host side schedule of a captured
+// run.  The input is the trace of the run written by XDP in Chrome
+// trace format (Debug.trace_file_format=json), that is the native
+// API trace (native_trace.json, Debug.native_xrt_trace=true) and the
+// device trace (device_trace_<n>.json, Debug.device_trace), including
+// any rotated files.  The files are parsed in parallel.  An activity
+// that spans a rotation is ended in the old file and begun again in
+// the new file by events marked as continued, which are skipped so
+// that the original begin and end are paired.
+//
+// Every CU execution in the device trace is a command.  A command is
+// matched in order to the xrt::run::start call that issued it, and
+// the xrt::run::wait calls of the host determine which earlier
+// command the host waited for before issuing it.  From this the tool
+// reconstructs the command dependency graph, the CU occupancy, and
+// the cost of the host between commands: time spent in the start
+// call, time between calls, and latency from the start call to the
+// command starting on its CU.
+//
+// The host is then replayed by a discrete event simulation under
+// alternative schedules, each of which changes one thing:
+//
+//   depth=<n>    keep up to n commands in flight, waits for more
+//                recent commands are deferred
+//   threads=<n>  issue commands from n host threads round robin
+//   runlist=<n>  submit n consecutive commands as one runlist
+//   cu=earliest  dispatch to the earliest free CU of the same kernel
+//   combined     all of the above with the largest values
+//
+// The schedules are simulated concurrently and ranked by estimated
+// speedup over the replay of the observed schedule, followed by a
+// ranked list of bottlenecks.  The estimates assume that service
+// times on the device don't change with the schedule.
+namespace {
+
+constexpr size_t no_index = std::numeric_limits<size_t>::max();
+
+// One line of a Chrome trace file written by XDP
+struct trace_event
+{
+  std::string name;
+  std::string cat;
+  char ph = 0;
+  uint64_t id = 0;
+  double ts = 0;      // us
+  uint64_t pid = 0;
+  uint64_t tid = 0;
+};
+
+struct interval
+{
+  std::string name;
+  uint64_t pid = 0;
+  uint64_t tid = 0;
+  double begin = 0;
+  double end = 0;
+};
+
+// XDP writes one event per line, so the fields are extracted from
+// each line rather than parsing the file as a whole
+bool
+get_field(const std::string& line, const char* key, std::string& value)
+{
+  auto pattern = std::string("\"") + key + "\":";
+  auto pos = line.find(pattern);
+  if (pos == std::string::npos)
+    return false;
+
+  pos += pattern.size();
+  value.clear();
+  if (pos < line.size() && line[pos] == '"') {
+    for (++pos; pos < line.size() && line[pos] != '"'; ++pos) {
+      if (line[pos] == '\\' && pos + 1 < line.size())
+        ++pos;
+      value += line[pos];
+    }
+    return true;
+  }
+
+  auto end = line.find_first_of(",}", pos);
+  value = line.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+  return true;
+}
+
+std::vector<trace_event>
+parse_file(const std::string& path)
+{
+  std::ifstream ifs(path);
+  if (!ifs)
+    throw std::runtime_error("Cannot open trace file " + path);
+
+  std::vector<trace_event> events;
+  std::string line;
+  std::string value;
+  while (std::getline(ifs, line)) {
+    if (!get_field(line, "ph", value) || value.size() != 1)
+      continue;
+
+    trace_event e;
+    e.ph = value[0];
+    if (e.ph != 'b' && e.ph != 'e')
+      continue;
+
+    // Added by the writer at a file rotation
+    if (get_field(line, "continued", value))
+      continue;
+
+    get_field(line, "name", e.name);
+    get_field(line, "cat", e.cat);
+    if (get_field(line, "id", value))
+      e.id = std::stoull(value);
+    if (get_field(line, "ts", value))
+      e.ts = std::stod(value);
+    if (get_field(line, "pid", value))
+      e.pid = std::stoull(value);
+    if (get_field(line, "tid", value))
+      e.tid = std::stoull(value);
+    events.push_back(std::move(e));
+  }
+  return events;
+}
+
+// Begin and end of an activity share the id.  Events must be in
+// timestamp order.  Activities that were not closed in the captured
+// files are dropped.
+std::map<std::string, std::vector<interval>>
+pair_events(const std::vector<trace_event>& events)
+{
+  using key_type = std::tuple<uint64_t, uint64_t, uint64_t>;
+  std::map<key_type, const trace_event*> open;
+  std::map<std::string, std::vector<interval>> intervals;
+
+  for (const auto& e : events) {
+    key_type key{e.pid, e.tid, e.id};
+    if (e.ph == 'b') {
+      open[key] = &e;
+      continue;
+    }
+
+    auto itr = open.find(key);
+    if (itr == open.end())
+      continue;
+
+    auto begin = itr->second;
+    open.erase(itr);
+    intervals[begin->cat].push_back({begin->name, e.pid, e.tid, begin->ts, e.ts});
+  }
+
+  for (auto& [cat, list] : intervals)
+    std::sort(list.begin(), list.end(), [](const auto& a, const auto& b) { return a.begin < b.begin; });
+
+  return intervals;
+}
+
+struct compute_unit
+{
+  std::string name;
+  std::string kernel;   // CUs of the same kernel are interchangeable
+  double busy = 0;
+  size_t executions = 0;
+};
+
+// A command as observed in the captured run
+struct command
+{
+  size_t cu = 0;
+  double service = 0;        // execution time on CU
+  double issue = 0;          // begin of start call, or execution begin if unmatched
+  double issue_cost = 0;     // duration of start call
+  double dispatch = 0;       // start call end to CU start, excluding CU busy time
+  double gap = 0;            // host time between previous host call and start call
+  size_t dep = no_index;     // command the host waited for before issuing
+  double wake = 0;           // command completion to return from wait
+  double begin = 0;
+  double end = 0;
+};
+
+struct model
+{
+  std::vector<compute_unit> cus;
+  std::vector<command> commands;  // in issue order
+  double observed_begin = 0;
+  double observed_end = 0;
+  size_t unmatched = 0;
+  size_t max_inflight = 0;
+  double total_wait = 0;
+};
+
+std::string
+kernel_of(const std::string& cu)
+{
+  // CU names are <kernel>_<n> unless renamed in the link step
+  auto pos = cu.rfind('_');
+  if (pos == std::string::npos || pos + 1 == cu.size()
+      || cu.find_first_not_of("0123456789", pos + 1) != std::string::npos)
+    return cu;
+  return cu.substr(0, pos);
+}
+
+model
+build_model(const std::map<std::string, std::vector<interval>>& intervals)
+{
+  model m;
+
+  auto find = [&intervals](const char* cat) {
+    static const std::vector<interval> none;
+    auto itr = intervals.find(cat);
+    return itr == intervals.end() ? none : itr->second;
+  };
+
+  auto executions = find("CU");
+  if (executions.empty())
+    throw std::runtime_error("No CU executions in device trace");
+
+  std::vector<interval> starts;
+  std::vector<interval> waits;
+  for (const auto& api : find("API")) {
+    if (api.name == "xrt::run::start")
+      starts.push_back(api);
+    else if (api.name == "xrt::run::wait")
+      waits.push_back(api);
+  }
+
+  // CUs are identified by device (pid) and CU index (tid)
+  std::map<std::pair<uint64_t, uint64_t>, size_t> cu_index;
+  for (const auto& e : executions) {
+    auto [itr, inserted] = cu_index.emplace(std::make_pair(e.pid, e.tid), m.cus.size());
+    if (inserted)
+      m.cus.push_back({e.name, std::to_string(e.pid) + ":" + kernel_of(e.name)});
+  }
+
+  // Match executions to start calls in order.  An execution without
+  // a start call before it (for example part of a runlist) is treated
+  // as issued when it started.
+  size_t next_start = 0;
+  for (const auto& e : executions) {
+    command cmd;
+    cmd.cu = cu_index[{e.pid, e.tid}];
+    cmd.begin = e.begin;
+    cmd.end = e.end;
+    cmd.service = e.end - e.begin;
+    if (next_start < starts.size() && starts[next_start].begin <= e.begin) {
+      cmd.issue = starts[next_start].begin;
+      cmd.issue_cost = starts[next_start].end - starts[next_start].begin;
+      ++next_start;
+    }
+    else {
+      cmd.issue = e.begin;
+      ++m.unmatched;
+    }
+    m.commands.push_back(cmd);
+
+    auto& cu = m.cus[cmd.cu];
+    cu.busy += cmd.service;
+    ++cu.executions;
+  }
+
+  std::stable_sort(m.commands.begin(), m.commands.end(),
+                   [](const auto& a, const auto& b) { return a.issue < b.issue; });
+
+  m.observed_begin = m.commands.front().issue;
+  for (const auto& cmd : m.commands)
+    m.observed_end = std::max(m.observed_end, cmd.end);
+
+  // A wait returns after the latest command completion before it
+  // returned.  That command is the dependency of every command issued
+  // after the wait until the next wait.
+  std::vector<std::pair<double, size_t>> by_end;
+  for (size_t idx = 0; idx < m.commands.size(); ++idx)
+    by_end.emplace_back(m.commands[idx].end, idx);
+  std::sort(by_end.begin(), by_end.end());
+
+  size_t next_wait = 0;
+  size_t dep = no_index;
+  double wake = 0;
+  double host = m.observed_begin;
+  std::vector<double> cu_free(m.cus.size(), 0);
+  for (size_t idx = 0; idx < m.commands.size(); ++idx) {
+    auto& cmd = m.commands[idx];
+    for (; next_wait < waits.size() && waits[next_wait].end <= cmd.issue; ++next_wait) {
+      const auto& w = waits[next_wait];
+      m.total_wait += w.end - w.begin;
+      auto itr = std::upper_bound(by_end.begin(), by_end.end(), std::make_pair(w.end, no_index));
+      while (itr != by_end.begin()) {
+        --itr;
+        if (itr->second < idx) {
+          dep = itr->second;
+          wake = w.end - itr->first;
+          break;
+        }
+      }
+      host = std::max(host, w.end);
+    }
+
+    cmd.dep = dep;
+    cmd.wake = cmd.dep == no_index ? 0 : wake;
+    cmd.gap = std::max(0.0, cmd.issue - host);
+    host = cmd.issue + cmd.issue_cost;
+
+    auto ready = std::max(host, cu_free[cmd.cu]);
+    cmd.dispatch = std::max(0.0, cmd.begin - ready);
+    cu_free[cmd.cu] = std::max(cu_free[cmd.cu], cmd.end);
+  }
+
+  // Commands in flight at any time, from issue to completion
+  std::vector<std::pair<double, int>> edges;
+  for (const auto& cmd : m.commands) {
+    edges.emplace_back(cmd.issue, 1);
+    edges.emplace_back(cmd.end, -1);
+  }
+  std::sort(edges.begin(), edges.end());
+  int inflight = 0;
+  for (const auto& [ts, delta] : edges) {
+    inflight += delta;
+    m.max_inflight = std::max(m.max_inflight, static_cast<size_t>(std::max(inflight, 0)));
+  }
+
+  return m;
+}
+
+struct schedule
+{
+  std::string name;
+  size_t depth = 0;        // 0 keeps the observed waits
+  unsigned int threads = 1;
+  size_t batch = 1;
+  bool earliest_cu = false;
+};
+
+struct outcome
+{
+  schedule sched;
+  double makespan = 0;
+  double host_busy = 0;    // issue cost plus host time between calls
+  double host_blocked = 0; // host waiting for commands
+};
+
+// Replay the model under a schedule.  Each host thread issues its
+// commands in order: block on the dependency if any, spend the host
+// time between calls, then the cost of the start call, after which
+// the command is dispatched to its CU.  With batching the start cost
+// and dispatch latency is paid once per batch.
+outcome
+simulate(const model& m, const schedule& s)
+{
+  outcome out;
+  out.sched = s;
+
+  const auto& cmds = m.commands;
+  std::vector<double> done(cmds.size(), 0);
+  std::vector<double> cu_free(m.cus.size(), m.observed_begin);
+  std::vector<double> host(std::max(1u, s.threads), m.observed_begin);
+
+  // CUs of each kernel, for dispatch to the earliest free CU
+  std::map<std::string, std::vector<size_t>> kernel_cus;
+  for (size_t idx = 0; idx < m.cus.size(); ++idx)
+    kernel_cus[m.cus[idx].kernel].push_back(idx);
+
+  auto dispatch = [&](size_t idx, double ready) {
+    const auto& cmd = cmds[idx];
+    auto cu = cmd.cu;
+    if (s.earliest_cu) {
+      for (auto candidate : kernel_cus[m.cus[cmd.cu].kernel])
+        if (cu_free[candidate] < cu_free[cu])
+          cu = candidate;
+    }
+    auto start = std::max(ready, cu_free[cu]);
+    done[idx] = start + cmd.service;
+    cu_free[cu] = done[idx];
+  };
+
+  size_t idx = 0;
+  size_t batch_idx = 0;
+  while (idx < cmds.size()) {
+    auto& clock = host[batch_idx++ % host.size()];
+
+    // A batch ends early at a command that depends on a command in
+    // the same batch
+    size_t end = idx;
+    while (end < cmds.size() && end - idx < s.batch && (end == idx || cmds[end].dep < idx || cmds[end].dep == no_index))
+      ++end;
+
+    for (auto cur = idx; cur < end; ++cur) {
+      const auto& cmd = cmds[cur];
+      auto dep = cmd.dep;
+      if (s.depth && dep != no_index && cur >= s.depth)
+        dep = std::min(dep, cur - s.depth);
+      else if (s.depth && dep != no_index)
+        dep = no_index;
+
+      if (dep != no_index && done[dep] + cmd.wake > clock) {
+        out.host_blocked += done[dep] + cmd.wake - clock;
+        clock = done[dep] + cmd.wake;
+      }
+      clock += cmd.gap;
+      out.host_busy += cmd.gap;
+      if (cur == idx || s.batch == 1) {
+        clock += cmd.issue_cost;
+        out.host_busy += cmd.issue_cost;
+      }
+    }
+
+    for (auto cur = idx; cur < end; ++cur)
+      dispatch(cur, clock + cmds[s.batch == 1 ? cur : idx].dispatch);
+
+    idx = end;
+  }
+
+  auto last = *std::max_element(done.begin(), done.end());
+  out.makespan = last - m.observed_begin;
+  return out;
+}
+
+std::vector<schedule>
+make_schedules(const std::vector<size_t>& depths, const std::vector<unsigned int>& threads,
+               const std::vector<size_t>& batches)
+{
+  std::vector<schedule> schedules;
+  schedules.push_back({"observed"});
+  for (auto d : depths) {
+    schedule s{"depth=" + std::to_string(d)};
+    s.depth = d;
+    schedules.push_back(s);
+  }
+  for (auto t : threads) {
+    schedule s{"threads=" + std::to_string(t)};
+    s.threads = t;
+    schedules.push_back(s);
+  }
+  for (auto b : batches) {
+    schedule s{"runlist=" + std::to_string(b)};
+    s.batch = b;
+    schedules.push_back(s);
+  }
+  schedule s{"cu=earliest"};
+  s.earliest_cu = true;
+  schedules.push_back(s);
+
+  // All changes together, since one bottleneck can hide another
+  schedule all{"combined"};
+  all.depth = depths.empty() ? 0 : *std::max_element(depths.begin(), depths.end());
+  all.threads = threads.empty() ? 1 : *std::max_element(threads.begin(), threads.end());
+  all.batch = batches.empty() ? 1 : *std::max_element(batches.begin(), batches.end());
+  all.earliest_cu = true;
+  schedules.push_back(all);
+  return schedules;
+}
+
+template <typename T>
+std::vector<T>
+parse_list(const std::string& arg)
+{
+  std::vector<T> values;
+  std::stringstream ss(arg);
+  std::string item;
+  while (std::getline(ss, item, ','))
+    if (auto value = static_cast<T>(std::stoul(item)))
+      values.push_back(value);
+  return values;
+}
+
+void
+report(const model& m, const std::vector<outcome>& outcomes)
+{
+  auto observed = m.observed_end - m.observed_begin;
+  const auto& base = outcomes.front();
+  auto percent = [](double part, double whole) { return whole > 0 ? 100.0 * part / whole : 0.0; };
+
+  std::cout << std::fixed << std::setprecision(1)
+            << "Commands: " << m.commands.size() << " on " << m.cus.size() << " CUs, "
+            << m.unmatched << " without a matching xrt::run::start\n"
+            << "Observed makespan: " << observed << " us, replayed: " << base.makespan << " us ("
+            << percent(base.makespan - observed, observed) << "% model error)\n"
+            << "Max commands in flight: " << m.max_inflight << "\n\n";
+
+  std::cout << "CU occupancy\n";
+  double max_busy = 0;
+  for (const auto& cu : m.cus) {
+    auto util = percent(cu.busy, observed);
+    max_busy = std::max(max_busy, cu.busy);
+    std::cout << "  " << std::left << std::setw(24) << cu.name << std::right
+              << std::setw(8) << cu.executions << " runs "
+              << std::setw(12) << cu.busy << " us busy "
+              << std::setw(6) << util << "%\n";
+  }
+
+  double issue = 0;
+  double gap = 0;
+  double dispatch = 0;
+  for (const auto& cmd : m.commands) {
+    issue += cmd.issue_cost;
+    gap += cmd.gap;
+    dispatch += cmd.dispatch;
+  }
+  auto n = static_cast<double>(m.commands.size());
+  std::cout << "\nHost\n"
+            << "  start calls: " << issue << " us (" << issue / n << " us per command)\n"
+            << "  between calls: " << gap << " us\n"
+            << "  in wait calls: " << m.total_wait << " us\n"
+            << "  dispatch latency: " << dispatch / n << " us per command\n\n";
+
+  std::vector<const outcome*> ranked;
+  for (const auto& o : outcomes)
+    ranked.push_back(&o);
+  std::sort(ranked.begin(), ranked.end(), [](auto a, auto b) { return a->makespan < b->makespan; });
+
+  std::cout << "What-if schedules (ranked)\n";
+  for (auto o : ranked) {
+    auto speedup = o->makespan > 0 ? base.makespan / o->makespan : 0.0;
+    std::cout << "  " << std::left << std::setw(14) << o->sched.name << std::right
+              << std::setw(12) << o->makespan << " us "
+              << std::setprecision(2) << std::setw(6) << speedup << "x"
+              << std::setprecision(1) << "  host busy " << o->host_busy
+              << " us, blocked " << o->host_blocked << " us (all threads)\n";
+  }
+
+  // Bottlenecks are ranked by the best gain of the schedules that
+  // address them
+  std::map<std::string, double> best;
+  auto category = [](const schedule& s) -> std::string {
+    if (s.name == "combined")
+      return "";
+    if (s.depth)
+      return "host waits for completions (increase queue depth)";
+    if (s.threads > 1)
+      return "single threaded command issue (issue from more threads)";
+    if (s.batch > 1)
+      return "per command submission overhead (use runlists)";
+    if (s.earliest_cu)
+      return "CU assignment imbalance (dispatch to any free CU)";
+    return "";
+  };
+  for (const auto& o : outcomes) {
+    auto name = category(o.sched);
+    if (name.empty())
+      continue;
+    best[name] = std::max(best[name], percent(base.makespan - o.makespan, base.makespan));
+  }
+
+  std::vector<std::pair<std::string, double>> bottlenecks(best.begin(), best.end());
+  std::sort(bottlenecks.begin(), bottlenecks.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+
+  std::cout << "\nBottlenecks (estimated makespan reduction)\n";
+  int rank = 0;
+  for (const auto& [name, gain] : bottlenecks)
+    std::cout << "  " << ++rank << ". " << std::setw(5) << gain << "%  " << name << "\n";
+
+  // No schedule can finish before the busiest CU has executed its
+  // commands with the CU assignment as observed
+  std::cout << "  Any host schedule change gains at most "
+            << std::max(0.0, percent(base.makespan - max_busy, base.makespan))
+            << "% with the observed CU assignment\n";
+}
+
+void
+usage(const char* exe)
+{
+  std::cout << "Usage: " << exe
+            << " [-d depths] [-t threads] [-b runlist sizes] <trace.json>...\n"
+            << "  -d <n,...>  queue depths to simulate (default 2,4,8,16)\n"
+            << "  -t <n,...>  host thread counts to simulate (default 2,4)\n"
+            << "  -b <n,...>  runlist sizes to simulate (default 8,32)\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  std::vector<size_t> depths {2, 4, 8, 16};
+  std::vector<unsigned int> threads {2, 4};
+  std::vector<size_t> batches {8, 32};
+  std::vector<std::string> files;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      if ((arg == "-d" || arg == "-t" || arg == "-b") && i + 1 < argc) {
+        std::string val = argv[++i];
+        if (arg == "-d")
+          depths = parse_list<size_t>(val);
+        else if (arg == "-t")
+          threads = parse_list<unsigned int>(val);
+        else
+          batches = parse_list<size_t>(val);
+      }
+      else if (!arg.empty() && arg[0] == '-') {
+        usage(argv[0]);
+        return 1;
+      }
+      else {
+        files.push_back(arg);
+      }
+    }
+  }
+  catch (const std::exception&) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (files.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  try {
+    // Parse every trace stream on its own thread
+    std::vector<std::future<std::vector<trace_event>>> parsed;
+    for (const auto& file : files)
+      parsed.push_back(std::async(std::launch::async, parse_file, file));
+
+    std::vector<trace_event> events;
+    for (auto& f : parsed) {
+      auto list = f.get();
+      std::move(list.begin(), list.end(), std::back_inserter(events));
+    }
+
+    // Files can be given in any order, e.g. rotated files by a shell
+    // glob, so order the events by timestamp with a begin ahead of an
+    // end at the same time
+    std::stable_sort(events.begin(), events.end(), [](const auto& a, const auto& b) {
+      return std::tie(a.ts, a.ph) < std::tie(b.ts, b.ph);
+    });
+
+    auto m = build_model(pair_events(events));
+
+    // Simulate the schedules concurrently
+    std::vector<std::future<outcome>> simulated;
+    for (const auto& s : make_schedules(depths, threads, batches))
+      simulated.push_back(std::async(std::launch::async, simulate, std::cref(m), s));
+
+    std::vector<outcome> outcomes;
+    for (auto& f : simulated)
+      outcomes.push_back(f.get());
+
+    report(m, outcomes);
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "schedule_replay: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "core/common/config_reader.h"
+#include "core/common/message.h"
+
+#include "xdp/profile/writer/aie_trace/aie_trace_stream_logger.h"
+#include "xdp/profile/writer/aie_trace/aie_trace_writer.h"
+
+namespace xdp {
+
+  AIETraceStreamLogger::AIETraceStreamLogger(uint64_t devId,
+                                             std::vector<AIETraceWriter*> trWriters,
+                                             uint64_t numBlocks, uint64_t blkSize)
+    : deviceId(devId),
+      // Blocks hold whole trace words
+      blockSize(std::max<uint64_t>(blkSize & ~uint64_t(3), 4)),
+      writers(std::move(trWriters)),
+      pool(std::max<uint64_t>(numBlocks, 1))
+  {
+    for (auto& block : pool) {
+      block.data = std::make_unique<char[]>(blockSize);
+      freeBlocks.push_back(&block);
+    }
+    writerThread = std::thread(&AIETraceStreamLogger::writeBlocks, this);
+  }
+
+  AIETraceStreamLogger::~AIETraceStreamLogger()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      stop = true;
+    }
+    cvFull.notify_one();
+    writerThread.join();
+
+    if (xrt_core::config::get_verbosity() >=
+        static_cast<uint32_t>(xrt_core::message::severity_level::debug)) {
+      std::stringstream msg;
+      msg << "Streamed " << bytesWritten << " bytes of AIE trace for device "
+          << deviceId << " using " << pool.size() << " buffers of "
+          << blockSize << " bytes, waited for a free buffer " << stalls
+          << " times.";
+      xrt_core::message::send(xrt_core::message::severity_level::debug, "XRT", msg.str());
+    }
+  }
+
+  void AIETraceStreamLogger::addAIETraceData(uint64_t strmIndex, void* buffer,
+                                             uint64_t bufferSz, bool /*copy*/)
+  {
+    // The data is always copied, the offloader may reuse the buffer
+    // as soon as this returns
+    if (strmIndex >= writers.size() || writers[strmIndex] == nullptr)
+      return;
+
+    auto src = static_cast<const char*>(buffer);
+    while (bufferSz > 0) {
+      Block* block = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (freeBlocks.empty()) {
+          ++stalls;
+          cvFree.wait(lock, [this] { return !freeBlocks.empty(); });
+        }
+        block = freeBlocks.back();
+        freeBlocks.pop_back();
+        ++busyBlocks;
+      }
+
+      block->strmIndex = strmIndex;
+      block->size = std::min(bufferSz, blockSize);
+      std::memcpy(block->data.get(), src, block->size);
+      src += block->size;
+      bufferSz -= block->size;
+
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+        fullBlocks.push_back(block);
+      }
+      cvFull.notify_one();
+    }
+  }
+
+  void AIETraceStreamLogger::flush()
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    cvFree.wait(lock, [this] { return busyBlocks == 0; });
+  }
+
+  void AIETraceStreamLogger::writeBlocks()
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+      cvFull.wait(lock, [this] { return stop || !fullBlocks.empty(); });
+      // Everything queued before stop is written
+      if (fullBlocks.empty())
+        return;
+
+      auto block = fullBlocks.front();
+      fullBlocks.pop_front();
+      lock.unlock();
+
+      writers[block->strmIndex]->writeData(block->data.get(), block->size);
+
+      lock.lock();
+      bytesWritten += block->size;
+      freeBlocks.push_back(block);
+      --busyBlocks;
+      cvFree.notify_all();
+    }
+  }
+
+}
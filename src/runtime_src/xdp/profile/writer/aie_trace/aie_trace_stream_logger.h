@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+
+#ifndef AIE_TRACE_STREAM_LOGGER_H
+#define AIE_TRACE_STREAM_LOGGER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "xdp/profile/device/aie_trace/aie_trace_logger.h"
+
+namespace xdp {
+
+  class AIETraceWriter;
+
+  // Streams offloaded AIE trace to the per stream trace files while
+  // the application runs, instead of keeping all of it in the database
+  // until the end of the run.
+  //
+  // Trace data is copied into blocks of a fixed pool and written to
+  // the files by a background thread, so memory use is bounded by the
+  // pool regardless of the amount of trace.  When all blocks are
+  // waiting to be written, addAIETraceData blocks until one is free.
+  class AIETraceStreamLogger : public AIETraceLogger
+  {
+  private:
+    struct Block {
+      uint64_t strmIndex = 0;
+      uint64_t size = 0;
+      std::unique_ptr<char[]> data;
+    };
+
+    uint64_t deviceId;
+    uint64_t blockSize;
+    std::vector<AIETraceWriter*> writers;
+
+    std::vector<Block> pool;
+    std::vector<Block*> freeBlocks;
+    std::deque<Block*> fullBlocks;
+    uint64_t busyBlocks = 0;   // taken from the pool, not yet returned
+    uint64_t stalls = 0;       // times addAIETraceData waited for a block
+    uint64_t bytesWritten = 0;
+    bool stop = false;
+
+    std::mutex mtx;
+    std::condition_variable cvFree;
+    std::condition_variable cvFull;
+    std::thread writerThread;
+
+    void writeBlocks();
+
+  public:
+    AIETraceStreamLogger(uint64_t devId, std::vector<AIETraceWriter*> trWriters,
+                         uint64_t numBlocks, uint64_t blkSize);
+    virtual ~AIETraceStreamLogger();
+
+    virtual void addAIETraceData(uint64_t strmIndex, void* buffer, uint64_t bufferSz, bool copy) override;
+    virtual void flush() override;
+  };
+
+}
+
+#endif
@@ -100,19 +100,7 @@ namespace xdp {
       if (nullptr == buf)
         continue;
 
-      // We write 4 bytes at a time
-      // Max chunk size should be multiple of 4
-      // If last chunk is not multiple of 4 then in worst case, 
-      // 3 bytes of data will not be written. But this is not possible, as we always write full packet.
-      uint64_t bufferSz = (traceData->bufferSz[j] / 4);
-
-      uint32_t* dataBuffer = static_cast<uint32_t*>(buf);
-      for (uint64_t i = 0; i < bufferSz; i++)
-      {
-        fout << "0x" << std::hex << dataBuffer[i] << std::endl;
-        fout << std::flush;
-      }
-
+      writeData(buf, traceData->bufferSz[j]);
 
       // Free the memory immediately if we own it
       if (traceData->owner)
@@ -121,6 +109,20 @@ namespace xdp {
     delete traceData;
   }
 
+  void AIETraceWriter::writeData(const void* buffer, uint64_t bufferSz)
+  {
+    // We write 4 bytes at a time
+    // Max chunk size should be multiple of 4
+    // If last chunk is not multiple of 4 then in worst case, 
+    // 3 bytes of data will not be written. But this is not possible, as we always write full packet.
+    uint64_t numWords = (bufferSz / 4);
+
+    auto dataBuffer = static_cast<const uint32_t*>(buffer);
+    for (uint64_t i = 0; i < numWords; i++)
+      fout << "0x" << std::hex << dataBuffer[i] << '\n';
+    fout << std::flush;
+  }
+
   void AIETraceWriter::writeDependencies()
   {
   }
@@ -57,6 +57,10 @@ namespace xdp {
     ~AIETraceWriter();
 
     virtual bool write(bool openNewFile);
+
+    // Append raw trace words to the file, used by both the database
+    // based write and the streaming logger
+    void writeData(const void* buffer, uint64_t bufferSz);
   };
 
 }
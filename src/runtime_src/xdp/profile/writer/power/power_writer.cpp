@@ -33,9 +33,8 @@ namespace xdp {
   {    
   }
 
-  bool PowerProfilingWriter::write(bool openNewFile)
+  void PowerProfilingWriter::writeHeader()
   {
-    // Write header
     fout << "Target device: " << deviceName << "\n";
     fout << "timestamp"    << ","
          << "12v_aux_curr" << ","
@@ -62,10 +61,19 @@ namespace xdp {
          << "se98_temp2"   << ","
          << "vccint_temp"  << ","
          << "fan_rpm\n";
+  }
+
+  // Samples are moved out of the database as they are written, so
+  //  each write appends the samples collected since the previous one
+  bool PowerProfilingWriter::write(bool /*openNewFile*/)
+  {
+    if (!headerWritten) {
+      writeHeader();
+      headerWritten = true;
+    }
 
-    // Write all of the data elements
     std::vector<counters::Sample> samples =
-      (db->getDynamicInfo()).getPowerSamples(deviceIndex);
+      (db->getDynamicInfo()).movePowerSamples(deviceIndex);
 
     for (auto& sample : samples) {
       fout << sample.timestamp << ",";
@@ -28,6 +28,9 @@ namespace xdp {
   private:
     std::string deviceName ;
     uint64_t deviceIndex ;
+    bool headerWritten = false ;
+
+    void writeHeader() ;
   public:
     PowerProfilingWriter(const char* filename, const char* d, uint64_t index) ;
     ~PowerProfilingWriter() ;
@@ -0,0 +1,319 @@
+/**
+ * Copyright (C) 2026 Advanced Micro Devices, Inc. - All rights reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define XDP_CORE_SOURCE
+
+#include <algorithm>
+#include <iomanip>
+#include <vector>
+
+#include "core/common/config_reader.h"
+#include "xdp/profile/database/database.h"
+#include "xdp/profile/database/events/device_events.h"
+#include "xdp/profile/database/events/vtf_event.h"
+#include "xdp/profile/database/static_info/pl_constructs.h"
+#include "xdp/profile/writer/vp_base/chrome_trace_writer.h"
+
+namespace {
+
+  // Process IDs in the output.  The host is process 0 and every
+  //  device is listed as its own process after that.
+  constexpr uint64_t hostPid = 0 ;
+
+  // Thread (row) IDs in the output
+  constexpr uint64_t apiTid         = 0 ;
+  constexpr uint64_t readTid        = 1 ;
+  constexpr uint64_t writeTid       = 2 ;
+  constexpr uint64_t memoryTidBase  = 1000 ;
+  constexpr uint64_t streamTidBase  = 2000 ;
+  constexpr uint64_t hostXferTid    = 3000 ;
+
+  const char* deviceEventName(xdp::VTFEventType type)
+  {
+    switch (type) {
+    case xdp::KERNEL:                     return "KERNEL" ;
+    case xdp::KERNEL_STALL:               return "STALL" ;
+    case xdp::KERNEL_STALL_EXT_MEM:       return "STALL_EXT_MEM" ;
+    case xdp::KERNEL_STALL_DATAFLOW:      return "STALL_DATAFLOW" ;
+    case xdp::KERNEL_STALL_PIPE:          return "STALL_PIPE" ;
+    case xdp::KERNEL_READ:                return "READ" ;
+    case xdp::KERNEL_WRITE:               return "WRITE" ;
+    case xdp::KERNEL_STREAM_READ:         return "STREAM_READ" ;
+    case xdp::KERNEL_STREAM_READ_STALL:   return "STREAM_READ_STALL" ;
+    case xdp::KERNEL_STREAM_READ_STARVE:  return "STREAM_READ_STARVE" ;
+    case xdp::KERNEL_STREAM_WRITE:        return "STREAM_WRITE" ;
+    case xdp::KERNEL_STREAM_WRITE_STALL:  return "STREAM_WRITE_STALL" ;
+    case xdp::KERNEL_STREAM_WRITE_STARVE: return "STREAM_WRITE_STARVE" ;
+    case xdp::HOST_READ:                  return "HOST_READ" ;
+    case xdp::HOST_WRITE:                 return "HOST_WRITE" ;
+    default:                              return "UNKNOWN" ;
+    }
+  }
+
+  // Names come from kernels and API functions, but escape anything
+  //  that would break the JSON string
+  std::string escape(const std::string& value)
+  {
+    std::string result ;
+    result.reserve(value.size()) ;
+    for (auto c : value) {
+      if (c == '"' || c == '\\') {
+        result += '\\' ;
+        result += c ;
+      }
+      else if (static_cast<unsigned char>(c) < 0x20)
+        result += ' ' ;
+      else
+        result += c ;
+    }
+    return result ;
+  }
+
+} // end anonymous namespace
+
+namespace xdp {
+
+  ChromeTraceWriter::ChromeTraceWriter(const char* filename) :
+    VPWriter(filename), host(true), deviceId(0)
+  {
+    maxFileSize =
+      static_cast<uint64_t>(xrt_core::config::get_trace_file_max_size_mb()) * 1024 * 1024 ;
+  }
+
+  ChromeTraceWriter::ChromeTraceWriter(const char* filename, uint64_t devId) :
+    VPWriter(filename), host(false), deviceId(devId)
+  {
+    maxFileSize =
+      static_cast<uint64_t>(xrt_core::config::get_trace_file_max_size_mb()) * 1024 * 1024 ;
+  }
+
+  ChromeTraceWriter::~ChromeTraceWriter()
+  {
+    closeArray() ;
+  }
+
+  void ChromeTraceWriter::openArray()
+  {
+    if (arrayOpen)
+      return ;
+    fout << "[\n" ;
+    arrayOpen = true ;
+    firstEvent = true ;
+    writeMetadata() ;
+
+    // Begin again the activities that were open when the previous file
+    //  was closed, so their end events have a match in this file
+    for (const auto& entry : openBegins) {
+      const auto& b = entry.second ;
+      writeAsync(b.name, b.category, 'b', entry.first.second, b.timestampUs,
+                 b.pid, b.tid, true) ;
+    }
+  }
+
+  void ChromeTraceWriter::closeArray()
+  {
+    if (!arrayOpen)
+      return ;
+    fout << "\n]\n" ;
+    fout.flush() ;
+    arrayOpen = false ;
+  }
+
+  void ChromeTraceWriter::writeMetadata()
+  {
+    // Every file is self contained, so repeat the process and thread
+    //  names at the start of each one
+    auto meta = [this](const char* kind, uint64_t pid, uint64_t tid,
+                       const std::string& name) {
+      fout << (firstEvent ? "" : ",\n")
+           << "{\"name\":\"" << kind << "\",\"ph\":\"M\",\"pid\":" << pid
+           << ",\"tid\":" << tid << ",\"args\":{\"name\":\""
+           << escape(name) << "\"}}" ;
+      firstEvent = false ;
+    } ;
+
+    if (host) {
+      meta("process_name", hostPid, apiTid, "Native XRT API Host Trace") ;
+      meta("thread_name", hostPid, apiTid, "Native XRT API Calls") ;
+      meta("thread_name", hostPid, readTid, "Reads") ;
+      meta("thread_name", hostPid, writeTid, "Writes") ;
+      return ;
+    }
+
+    uint64_t pid = deviceId + 1 ;
+    meta("process_name", pid, 0,
+         (db->getStaticInfo()).getDeviceName(deviceId)) ;
+    meta("thread_name", pid, hostXferTid, "Host Transfers") ;
+  }
+
+  void ChromeTraceWriter::writeAsync(const std::string& name,
+                                     const char* category,
+                                     char phase,
+                                     uint64_t id,
+                                     double timestampUs,
+                                     uint64_t pid,
+                                     uint64_t tid,
+                                     bool continued)
+  {
+    std::ios_base::fmtflags flags = fout.flags() ;
+    fout << (firstEvent ? "" : ",\n")
+         << "{\"name\":\"" << escape(name) << "\",\"cat\":\"" << category
+         << "\",\"ph\":\"" << phase << "\",\"id\":" << id
+         << ",\"ts\":" << std::fixed << std::setprecision(3) << timestampUs
+         << ",\"pid\":" << pid << ",\"tid\":" << tid ;
+    if (continued)
+      fout << ",\"args\":{\"continued\":1}" ;
+    fout << "}" ;
+    fout.flags(flags) ;
+    firstEvent = false ;
+  }
+
+  void ChromeTraceWriter::writeAsyncEvent(const std::string& name,
+                                          const char* category,
+                                          VTFEvent* e,
+                                          double timestampUs,
+                                          uint64_t pid,
+                                          uint64_t tid)
+  {
+    // Start and end of the same activity are connected through the ID
+    //  of the start event.  Async events are used because activities on
+    //  the same row (such as overlapping CU executions) need not nest.
+    bool isEnd = e->getStartId() != 0 ;
+    uint64_t id = isEnd ? e->getStartId() : e->getEventId() ;
+
+    if (isEnd)
+      openBegins.erase({category, id}) ;
+    else
+      openBegins[{category, id}] = {name, category, timestampUs, pid, tid} ;
+
+    writeAsync(name, category, isEnd ? 'e' : 'b', id, timestampUs, pid, tid) ;
+    lastTimestampUs = std::max(lastTimestampUs, timestampUs) ;
+  }
+
+  // End the open activities in the current file before it is closed.
+  //  They stay open and are begun again in the next file.  Both the end
+  //  and the repeated begin are marked as continued.
+  void ChromeTraceWriter::endOpenBegins()
+  {
+    for (const auto& entry : openBegins) {
+      const auto& b = entry.second ;
+      writeAsync(b.name, b.category, 'e', entry.first.second,
+                 std::max(b.timestampUs, lastTimestampUs), b.pid, b.tid,
+                 true) ;
+    }
+  }
+
+  void ChromeTraceWriter::writeHostEvents()
+  {
+    std::vector<VTFEvent*> APIEvents =
+      (db->getDynamicInfo()).moveUnsortedHostEvents(
+        [](VTFEvent* e)
+        {
+          return e->isNativeHostEvent();
+        } ) ;
+
+    std::sort(APIEvents.begin(), APIEvents.end(),
+              [](VTFEvent* x, VTFEvent* y)
+                {
+                  return x->getTimestamp() < y->getTimestamp() ;
+                }) ;
+
+    for (auto e : APIEvents) {
+      auto api = dynamic_cast<APICall*>(e) ;
+      std::string name = api ?
+        (db->getDynamicInfo()).lookupString(api->getFunctionName()) : "" ;
+
+      // Host timestamps are kept in nanoseconds
+      double ts = e->getTimestamp() / 1.0e3 ;
+      writeAsyncEvent(name, "API", e, ts, hostPid, apiTid) ;
+      if (e->isNativeRead())
+        writeAsyncEvent("READ", "TRANSFER", e, ts, hostPid, readTid) ;
+      else if (e->isNativeWrite())
+        writeAsyncEvent("WRITE", "TRANSFER", e, ts, hostPid, writeTid) ;
+    }
+
+    for (auto e : APIEvents)
+      delete e ;
+  }
+
+  void ChromeTraceWriter::writeDeviceEvents()
+  {
+    auto deviceEvents = (db->getDynamicInfo()).moveDeviceEvents(deviceId) ;
+    uint64_t pid = deviceId + 1 ;
+
+    for (auto& e : deviceEvents) {
+      auto deviceEvent = dynamic_cast<VTFDeviceEvent*>(e.get()) ;
+      if (!deviceEvent)
+        continue ;
+
+      auto type = deviceEvent->getEventType() ;
+      if (type == XCLBIN_END)
+        continue ;
+
+      // Device timestamps are kept in milliseconds
+      double ts = deviceEvent->getTimestamp() * 1.0e3 ;
+      int32_t cuId = deviceEvent->getCUId() ;
+
+      if (type == KERNEL) {
+        auto cu = (db->getStaticInfo()).getCU(deviceId, cuId) ;
+        std::string name = cu ? cu->getName() : deviceEventName(type) ;
+        writeAsyncEvent(name, "CU", deviceEvent, ts, pid, cuId) ;
+      }
+      else if (type >= KERNEL_STALL && type <= KERNEL_STALL_PIPE) {
+        writeAsyncEvent(deviceEventName(type), "STALL", deviceEvent, ts, pid, cuId) ;
+      }
+      else if (type == KERNEL_READ || type == KERNEL_WRITE) {
+        writeAsyncEvent(deviceEventName(type), "MEMORY", deviceEvent, ts, pid,
+                        memoryTidBase + deviceEvent->getMonitorId()) ;
+      }
+      else if (type >= KERNEL_STREAM_READ && type <= KERNEL_STREAM_WRITE_STARVE) {
+        writeAsyncEvent(deviceEventName(type), "STREAM", deviceEvent, ts, pid,
+                        streamTidBase + deviceEvent->getMonitorId()) ;
+      }
+      else {
+        writeAsyncEvent(deviceEventName(type), "TRANSFER", deviceEvent, ts,
+                        pid, hostXferTid) ;
+      }
+    }
+  }
+
+  bool ChromeTraceWriter::write(bool openNewFile)
+  {
+    openArray() ;
+
+    if (host)
+      writeHostEvents() ;
+    else
+      writeDeviceEvents() ;
+
+    fout.flush() ;
+
+    // The final write keeps the array open; it is closed when the
+    //  writer is destroyed so later stragglers still end up in the file.
+    if (!openNewFile || maxFileSize == 0)
+      return false ;
+
+    auto pos = fout.tellp() ;
+    if (pos < 0 || static_cast<uint64_t>(pos) < maxFileSize)
+      return false ;
+
+    endOpenBegins() ;
+    closeArray() ;
+    switchFiles() ;
+    return true ;
+  }
+
+} // end namespace xdp
@@ -0,0 +1,99 @@
+/**
+ * Copyright (C) 2026 Advanced Micro Devices, Inc. - All rights reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CHROME_TRACE_WRITER_DOT_H
+#define CHROME_TRACE_WRITER_DOT_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "xdp/profile/writer/vp_base/vp_writer.h"
+#include "xdp/config.h"
+
+namespace xdp {
+
+  // Forward declarations
+  class VTFEvent ;
+
+  // A trace writer that emits events in the Chrome trace-event JSON
+  //  array format, which is loadable by chrome://tracing and Perfetto.
+  //  Unlike the VP trace writers, each call to write appends only the
+  //  events that arrived since the previous call, so the file grows
+  //  incrementally during execution.  The closing bracket of the array
+  //  is optional in this format, so a file is readable even if the
+  //  application terminates before the writer is destroyed.  Once the
+  //  current file exceeds the configured size, the next file is opened.
+  //  Activities still open at that point are ended at the last timestamp
+  //  of the old file and begun again at the start of the new file, so
+  //  every file has matching begin/end pairs.  These added events are
+  //  marked with "args":{"continued":1} so that tools reading all files
+  //  can skip them and pair the original begin and end.
+  class ChromeTraceWriter : public VPWriter
+  {
+  private:
+    ChromeTraceWriter() = delete ;
+
+    // An async begin event whose end has not been written yet
+    struct AsyncBegin
+    {
+      std::string name ;
+      const char* category ;
+      double timestampUs ;
+      uint64_t pid ;
+      uint64_t tid ;
+    } ;
+
+    // Either the native host API events or the events of one device
+    bool host ;
+    uint64_t deviceId ;
+
+    uint64_t maxFileSize ;
+    bool arrayOpen = false ;
+    bool firstEvent = true ;
+
+    // Keyed by category and ID, which together identify an async pair
+    std::map<std::pair<std::string, uint64_t>, AsyncBegin> openBegins ;
+    double lastTimestampUs = 0 ;
+
+    void openArray() ;
+    void closeArray() ;
+    void endOpenBegins() ;
+    void writeMetadata() ;
+    void writeAsync(const std::string& name, const char* category,
+                    char phase, uint64_t id, double timestampUs,
+                    uint64_t pid, uint64_t tid, bool continued = false) ;
+    void writeAsyncEvent(const std::string& name, const char* category,
+                         VTFEvent* e, double timestampUs,
+                         uint64_t pid, uint64_t tid) ;
+    void writeHostEvents() ;
+    void writeDeviceEvents() ;
+
+  public:
+    // Trace of the native XRT API calls made by the host
+    XDP_CORE_EXPORT explicit ChromeTraceWriter(const char* filename) ;
+    // Trace of the PL events offloaded from one device
+    XDP_CORE_EXPORT ChromeTraceWriter(const char* filename, uint64_t devId) ;
+    XDP_CORE_EXPORT ~ChromeTraceWriter() ;
+
+    // Returns true if a new file was opened
+    XDP_CORE_EXPORT virtual bool write(bool openNewFile) ;
+  } ;
+
+} // end namespace xdp
+
+#endif
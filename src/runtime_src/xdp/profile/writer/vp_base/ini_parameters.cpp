@@ -44,6 +44,9 @@ namespace xdp {
     addParameter("power_profile_interval_ms",
                  xrt_core::config::get_power_profile_interval_ms(),
                  "Interval for reading power data (in ms)");
+    addParameter("power_profile_max_samples",
+                 xrt_core::config::get_power_profile_max_samples(),
+                 "Maximum power samples kept per device before downsampling");
     addParameter("stall_trace", xrt_core::config::get_stall_trace(),
                  "Enables hardware generation of stalls in compute units");
     addParameter("trace_buffer_size",
@@ -59,6 +62,12 @@ namespace xdp {
     addParameter("trace_file_dump_interval_s",
                  xrt_core::config::get_trace_file_dump_interval_s(),
                  "Interval for dumping files to host (in s)");              
+    addParameter("trace_file_format",
+                 xrt_core::config::get_trace_file_format(),
+                 "Format of native and device trace files (csv or json)");
+    addParameter("trace_file_max_size_mb",
+                 xrt_core::config::get_trace_file_max_size_mb(),
+                 "Size at which json trace files are rotated (in MB)");
     addParameter("lop_trace", xrt_core::config::get_lop_trace(),
                  "Generation of lower overhead OpenCL trace. Should not be used with other OpenCL options.");
     addParameter("debug_mode", xrt_core::config::get_launch_waveform(),
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+# Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+
+# Compare two xrt_host_bench JSON result files.  Entries are matched
+# by benchmark name, thread count, and size.  The script exits with a
+# non-zero status if the mean or p99 latency of any entry regressed by
+# more than the threshold.
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return data.get("label", ""), {
+        (r["name"], r["threads"], r["size"]): r for r in data["results"]
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare xrt_host_bench results")
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="allowed regression in percent (default 10)")
+    args = parser.parse_args()
+
+    base_label, base = load(args.baseline)
+    curr_label, curr = load(args.current)
+    print("baseline: %s  current: %s" % (base_label or args.baseline, curr_label or args.current))
+    print("%-24s %7s %9s %12s %12s %8s %8s" %
+          ("name", "threads", "size", "base mean", "curr mean", "mean %", "p99 %"))
+
+    regressions = 0
+    for key in sorted(base.keys() & curr.keys()):
+        b, c = base[key], curr[key]
+        mean = 100.0 * (c["mean_ns"] - b["mean_ns"]) / b["mean_ns"] if b["mean_ns"] else 0.0
+        p99 = 100.0 * (c["p99_ns"] - b["p99_ns"]) / b["p99_ns"] if b["p99_ns"] else 0.0
+        flag = ""
+        if mean > args.threshold or p99 > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print("%-24s %7d %9d %12.1f %12.1f %+7.1f%% %+7.1f%%%s" %
+              (key[0], key[1], key[2], b["mean_ns"], c["mean_ns"], mean, p99, flag))
+
+    for key in sorted(base.keys() - curr.keys()):
+        print("missing in current: %s threads=%d size=%d" % key)
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
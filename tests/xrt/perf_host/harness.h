@@ -0,0 +1,418 @@
+/**
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+ */
+#ifndef PERF_HOST_HARNESS_H_
+#define PERF_HOST_HARNESS_H_
+
+// Harness shared by the host runtime benchmarks and tests.  A program
+// is a table of named cases, each requiring a device, a kernel from
+// an xclbin (-k), or a kernel from an ELF module (-e) in addition.
+// Cases whose requirement is not met by the command line options are
+// skipped, and -b selects cases by name prefix.
+//
+// Benchmark cases time their body with measure(), which collects the
+// results for write_json().
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_hw_context.h"
+#include "xrt/xrt_kernel.h"
+#include "xrt/experimental/xrt_elf.h"
+#include "xrt/experimental/xrt_ext.h"
+#include "xrt/experimental/xrt_kernel.h"
+#include "xrt/experimental/xrt_module.h"
+#include "xrt/experimental/xrt_xclbin.h"
+
+namespace harness {
+
+using clock_type = std::chrono::steady_clock;
+
+struct options
+{
+  std::string xclbin;
+  std::string kernel = "hello";
+  std::string elf;
+  std::string label;
+  std::string output;
+  std::vector<std::string> select;
+  std::vector<unsigned int> threads {1, 2, 4, 8};
+  std::vector<size_t> sizes {4096, 65536, 1048576};
+  unsigned int iterations = 2000;
+  unsigned int runlist_size = 32;
+  unsigned int callback_us = 100;
+  bool list = false;
+};
+
+// What a case needs to run
+enum class needs { device, kernel, module };
+
+struct context
+{
+  options opt;
+  xrt::device device;
+  xrt::hw_context hwctx;
+  xrt::kernel kernel;         // -k, opt.kernel from the xclbin
+  xrt::kernel module_kernel;  // -e, opt.kernel from the ELF module
+
+  bool
+  supports(needs n) const
+  {
+    switch (n) {
+    case needs::device:
+      return true;
+    case needs::kernel:
+      return kernel.get_handle() != nullptr;
+    case needs::module:
+      return module_kernel.get_handle() != nullptr;
+    }
+    return false;
+  }
+};
+
+struct test_case
+{
+  std::string name;
+  needs need;
+  std::string description;
+  std::function<void(const context&)> run;
+};
+
+struct result
+{
+  std::string name;
+  unsigned int threads;
+  size_t size;
+  size_t iterations;
+  double mean_ns;
+  double p50_ns;
+  double p99_ns;
+  double max_ns;
+  double cpu_ns;
+  double ops_per_sec;
+};
+
+inline std::vector<result> results;
+
+inline void
+usage(const std::string& program)
+{
+  std::cout
+    << "Usage: " << program << " [options]\n"
+    << "  -k <xclbin>     enable kernel cases\n"
+    << "  -n <kernel>     kernel name (default hello)\n"
+    << "  -e <elf>        enable module cases\n"
+    << "  -b <list>       comma separated case name prefixes to run (default all)\n"
+    << "  -t <list>       comma separated thread counts (default 1,2,4,8)\n"
+    << "  -s <list>       comma separated buffer sizes (default 4096,65536,1048576)\n"
+    << "  -i <count>      iterations per thread (default 2000)\n"
+    << "  -r <count>      runs per runlist (default 32)\n"
+    << "  -c <us>         duration of slow completion callbacks (default 100)\n"
+    << "  -l <label>      label stored with the results, e.g. build id\n"
+    << "  -o <file>       JSON output file (default stdout)\n"
+    << "  -L              list the cases and exit\n";
+}
+
+inline std::vector<std::string>
+split(const std::string& str)
+{
+  std::vector<std::string> items;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ','))
+    items.push_back(item);
+  return items;
+}
+
+template <typename T>
+std::vector<T>
+parse_list(const std::string& str)
+{
+  std::vector<T> values;
+  for (const auto& item : split(str))
+    values.push_back(static_cast<T>(std::stoull(item)));
+  return values;
+}
+
+// Returns false on invalid command line
+inline bool
+parse_options(int argc, char* argv[], options& opt)
+{
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-L") {
+      opt.list = true;
+      continue;
+    }
+    if (i + 1 >= argc)
+      return false;
+    std::string val = argv[++i];
+    if (arg == "-k")
+      opt.xclbin = val;
+    else if (arg == "-n")
+      opt.kernel = val;
+    else if (arg == "-e")
+      opt.elf = val;
+    else if (arg == "-b")
+      opt.select = split(val);
+    else if (arg == "-t")
+      opt.threads = parse_list<unsigned int>(val);
+    else if (arg == "-s")
+      opt.sizes = parse_list<size_t>(val);
+    else if (arg == "-i")
+      opt.iterations = std::stoul(val);
+    else if (arg == "-r")
+      opt.runlist_size = std::stoul(val);
+    else if (arg == "-c")
+      opt.callback_us = std::stoul(val);
+    else if (arg == "-l")
+      opt.label = val;
+    else if (arg == "-o")
+      opt.output = val;
+    else
+      return false;
+  }
+
+  return !opt.threads.empty() && !opt.sizes.empty() && opt.iterations;
+}
+
+inline bool
+selected(const options& opt, const std::string& name)
+{
+  if (opt.select.empty())
+    return true;
+  return std::any_of(opt.select.begin(), opt.select.end(), [&name](const auto& prefix) {
+    return name.compare(0, prefix.size(), prefix) == 0;
+  });
+}
+
+inline void
+list_cases(const std::vector<test_case>& cases)
+{
+  static const char* need_str[] = {"", "-k", "-e"};
+  for (const auto& tc : cases)
+    std::cout << std::left << std::setw(26) << tc.name
+              << std::setw(4) << need_str[static_cast<int>(tc.need)]
+              << tc.description << "\n";
+}
+
+// Open device 0 and, if specified, the xclbin and ELF kernels
+inline void
+open(context& ctx)
+{
+  ctx.device = xrt::device{0};
+  if (ctx.opt.xclbin.empty())
+    return;
+
+  xrt::xclbin xclbin{ctx.opt.xclbin};
+  ctx.device.register_xclbin(xclbin);
+  ctx.hwctx = xrt::hw_context{ctx.device, xclbin.get_uuid()};
+  ctx.kernel = xrt::kernel{ctx.hwctx, ctx.opt.kernel};
+  if (!ctx.opt.elf.empty())
+    ctx.module_kernel = xrt::ext::kernel{ctx.hwctx, xrt::module{xrt::elf{ctx.opt.elf}}, ctx.opt.kernel};
+}
+
+// Run the selected cases that the context supports, in table order.
+// Returns the number of cases run.
+inline size_t
+run_cases(const context& ctx, const std::vector<test_case>& cases)
+{
+  size_t count = 0;
+  for (const auto& tc : cases) {
+    if (!selected(ctx.opt, tc.name) || !ctx.supports(tc.need))
+      continue;
+    tc.run(ctx);
+    ++count;
+  }
+  return count;
+}
+
+// Completion callbacks of one run.  The callback increments active
+// while it runs and delivered when it returns, the caller increments
+// started for every start of the run.
+struct callback_state
+{
+  std::atomic<unsigned int> started {0};
+  std::atomic<unsigned int> delivered {0};
+  std::atomic<unsigned int> active {0};
+  std::atomic<bool> overlapped {false};
+};
+
+// Wait for callbacks still being delivered after the runs completed,
+// then verify that each callback was called exactly once per run
+// execution and never concurrently for the same run.
+inline void
+check_callbacks(const std::vector<std::shared_ptr<callback_state>>& callbacks)
+{
+  auto deadline = clock_type::now() + std::chrono::seconds(10);
+  for (const auto& state : callbacks) {
+    while (state->delivered < state->started && clock_type::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (state->delivered != state->started)
+      throw std::runtime_error("completion callbacks delivered: " + std::to_string(state->delivered)
+                               + " of " + std::to_string(state->started));
+    if (state->overlapped)
+      throw std::runtime_error("completion callbacks of a run were called concurrently");
+  }
+}
+
+// Run body on each of 'threads' threads for 'iterations' iterations.
+// Setup is called once per thread before timing starts and returns
+// the per iteration body for that thread.  Every iteration is timed
+// individually so that tail latency is captured, and process cpu time
+// is sampled around the timed section.
+using body_type = std::function<void(unsigned int)>;
+using setup_type = std::function<body_type(unsigned int)>;
+
+inline result&
+measure(const std::string& name, unsigned int threads, size_t size,
+        unsigned int iterations, const setup_type& setup)
+{
+  std::vector<std::vector<double>> samples(threads);
+  std::vector<body_type> bodies;
+  for (unsigned int t = 0; t < threads; ++t)
+    bodies.push_back(setup(t));
+
+  std::vector<std::thread> workers;
+  auto cpu_start = std::clock();
+  auto start = clock_type::now();
+  for (unsigned int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      auto& lat = samples[t];
+      lat.reserve(iterations);
+      for (unsigned int i = 0; i < iterations; ++i) {
+        auto begin = clock_type::now();
+        bodies[t](i);
+        lat.push_back(std::chrono::duration<double, std::nano>(clock_type::now() - begin).count());
+      }
+    });
+  }
+  for (auto& w : workers)
+    w.join();
+  auto elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+  auto cpu = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+  std::vector<double> all;
+  for (auto& lat : samples)
+    all.insert(all.end(), lat.begin(), lat.end());
+  std::sort(all.begin(), all.end());
+
+  double sum = 0;
+  for (auto ns : all)
+    sum += ns;
+
+  auto percentile = [&all](double p) {
+    auto idx = static_cast<size_t>(p * static_cast<double>(all.size() - 1));
+    return all[idx];
+  };
+
+  result r;
+  r.name = name;
+  r.threads = threads;
+  r.size = size;
+  r.iterations = all.size();
+  r.mean_ns = sum / static_cast<double>(all.size());
+  r.p50_ns = percentile(0.50);
+  r.p99_ns = percentile(0.99);
+  r.max_ns = all.back();
+  r.cpu_ns = cpu * 1e9 / static_cast<double>(all.size());
+  r.ops_per_sec = elapsed > 0 ? static_cast<double>(all.size()) / elapsed : 0;
+  results.push_back(r);
+
+  std::cerr << std::left << std::setw(24) << name
+            << " threads: " << std::setw(3) << threads
+            << " size: " << std::setw(8) << size
+            << " mean ns: " << std::fixed << std::setprecision(1) << r.mean_ns
+            << " p99 ns: " << r.p99_ns
+            << " cpu ns: " << r.cpu_ns << std::endl;
+  return results.back();
+}
+
+// Aggregate bandwidth of a benchmark that transfers size bytes per
+// iteration
+inline void
+print_bandwidth(const result& r)
+{
+  std::cerr << std::left << std::setw(24) << r.name
+            << " threads: " << std::setw(3) << r.threads
+            << " size: " << std::setw(8) << r.size
+            << " MB/s: " << std::fixed << std::setprecision(1)
+            << r.ops_per_sec * static_cast<double>(r.size) / 1e6 << std::endl;
+}
+
+// Benchmark case measured for every thread count, and for every size
+// if per_size is set, otherwise for the first size only.  Setup is
+// called with the context and size and returns the per thread setup.
+inline test_case
+benchmark(std::string name, needs need, std::string description, bool per_size, bool bandwidth,
+          std::function<setup_type(const context&, size_t)> setup)
+{
+  auto run = [name, per_size, bandwidth, setup](const context& ctx) {
+    auto sizes = per_size ? ctx.opt.sizes : std::vector<size_t>{ctx.opt.sizes.front()};
+    for (auto size : sizes) {
+      for (auto threads : ctx.opt.threads) {
+        auto& r = measure(name, threads, size, ctx.opt.iterations, setup(ctx, size));
+        if (bandwidth)
+          print_bandwidth(r);
+      }
+    }
+  };
+  return {std::move(name), need, std::move(description), std::move(run)};
+}
+
+inline void
+write_json(std::ostream& os, const std::string& program, const options& opt)
+{
+  auto escape = [](const std::string& str) {
+    std::string out;
+    for (auto c : str) {
+      if (c == '"' || c == '\\')
+        out += '\\';
+      out += c;
+    }
+    return out;
+  };
+
+  auto mode = std::getenv("XCL_EMULATION_MODE");
+  os << "{\n"
+     << "  \"benchmark\": \"" << escape(program) << "\",\n"
+     << "  \"label\": \"" << escape(opt.label) << "\",\n"
+     << "  \"emulation_mode\": \"" << escape(mode ? mode : "") << "\",\n"
+     << "  \"results\": [\n";
+  os << std::fixed << std::setprecision(1);
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto& r = results[i];
+    os << "    {\"name\": \"" << r.name << "\""
+       << ", \"threads\": " << r.threads
+       << ", \"size\": " << r.size
+       << ", \"iterations\": " << r.iterations
+       << ", \"mean_ns\": " << r.mean_ns
+       << ", \"p50_ns\": " << r.p50_ns
+       << ", \"p99_ns\": " << r.p99_ns
+       << ", \"max_ns\": " << r.max_ns
+       << ", \"cpu_ns\": " << r.cpu_ns
+       << ", \"ops_per_sec\": " << r.ops_per_sec
+       << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  os << "  ]\n}\n";
+}
+
+} // namespace harness
+
+#endif
@@ -0,0 +1,444 @@
+/**
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+ */
+
+// Host runtime microbenchmarks for the launch, sync, and allocation
+// paths of xrt_coreutil.  Intended to be run with
+// XCL_EMULATION_MODE=noop so that the numbers reflect the cost of the
+// host runtime, optionally shaped by the noop device model configured
+// in xrt.ini.
+//
+// Buffer benchmarks need no xclbin.  Kernel benchmarks run when an
+// xclbin is specified, and module patching benchmarks run when an
+// ELF is specified in addition.  Argument 0 of the kernel must be a
+// global memory argument.  Use -L to list the benchmarks.
+//
+// Results are written as JSON, one entry per benchmark, thread count,
+// and size.  Use compare.py to compare results between builds.
+
+#include "harness.h"
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+namespace {
+
+using harness::context;
+using harness::needs;
+
+constexpr auto host_only = xrt::bo::flags::host_only;
+
+// Number of buffers per iteration of the batched benchmarks
+constexpr size_t batch = 8;
+
+void
+run_callback_slow(const context& ctx)
+{
+  auto size = ctx.opt.sizes.front();
+  for (auto threads : ctx.opt.threads) {
+    std::vector<std::shared_ptr<harness::callback_state>> callbacks;
+    harness::measure("run_callback_slow", threads, ctx.opt.callback_us, ctx.opt.iterations, [&](unsigned int) {
+      auto run = std::make_shared<xrt::run>(ctx.kernel);
+      run->set_arg(0, xrt::bo(ctx.device, size, ctx.kernel.group_id(0)));
+      auto state = std::make_shared<harness::callback_state>();
+      callbacks.push_back(state);
+      run->add_callback(ERT_CMD_STATE_COMPLETED,
+                        [state, delay = std::chrono::microseconds(ctx.opt.callback_us)]
+                        (const void*, ert_cmd_state, void*) {
+        if (state->active++)
+          state->overlapped = true;
+        std::this_thread::sleep_for(delay);
+        --state->active;
+        ++state->delivered;
+      }, nullptr);
+      return [run, state](unsigned int) {
+        ++state->started;
+        run->start();
+        run->wait();
+      };
+    });
+    harness::check_callbacks(callbacks);
+  }
+}
+
+// First 4 or 8 byte scalar argument of the kernel, size is reported
+// as the scalar size
+void
+run_set_arg_scalar(const context& ctx)
+{
+  for (const auto& arg : ctx.hwctx.get_xclbin().get_kernel(ctx.opt.kernel).get_args()) {
+    auto size = arg.get_size();
+    if (!arg.get_mems().empty() || (size != sizeof(uint32_t) && size != sizeof(uint64_t)))
+      continue;
+
+    auto index = static_cast<int>(arg.get_index());
+    for (auto threads : ctx.opt.threads) {
+      harness::measure("run_set_arg_scalar", threads, size, ctx.opt.iterations, [&](unsigned int) {
+        auto run = std::make_shared<xrt::run>(ctx.kernel);
+        return [run, index, size](unsigned int i) {
+          if (size == sizeof(uint32_t))
+            run->set_arg(index, static_cast<uint32_t>(i));
+          else
+            run->set_arg(index, static_cast<uint64_t>(i));
+        };
+      });
+    }
+    return;
+  }
+}
+
+// Per thread setup of a run of kernel with a buffer as argument 0
+xrt::run
+make_run(const context& ctx, const xrt::kernel& kernel, size_t size)
+{
+  xrt::run run{kernel};
+  run.set_arg(0, xrt::bo(ctx.device, size, kernel.group_id(0)));
+  return run;
+}
+
+const std::vector<harness::test_case> benchmarks = {
+  harness::benchmark("bo_alloc", needs::device,
+    "allocate and free a host only buffer", true, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        return [&ctx, size](unsigned int) {
+          xrt::bo bo{ctx.device, size, host_only, 0};
+        };
+      };
+    }),
+
+  harness::benchmark("bo_alloc_8", needs::device,
+    "allocate 8 host only buffers, then free them", true, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto bos = std::make_shared<std::vector<xrt::bo>>();
+        bos->reserve(batch);
+        return [&ctx, size, bos](unsigned int) {
+          for (size_t b = 0; b < batch; ++b)
+            bos->emplace_back(ctx.device, size, host_only, 0);
+          bos->clear();
+        };
+      };
+    }),
+
+  // One arena per measurement shared by all threads
+  harness::benchmark("bo_arena_alloc_8", needs::device,
+    "allocate 8 buffers from an xrt::ext::bo_arena, then free them", true, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      auto arena = std::make_shared<xrt::ext::bo_arena>(ctx.device, host_only, 0);
+      return [arena, size](unsigned int) {
+        auto bos = std::make_shared<std::vector<xrt::bo>>();
+        bos->reserve(batch);
+        return [arena, size, bos](unsigned int) {
+          for (size_t b = 0; b < batch; ++b)
+            bos->push_back(arena->alloc(size));
+          bos->clear();
+        };
+      };
+    }),
+
+  harness::benchmark("bo_userptr", needs::device,
+    "wrap the same user memory in a new buffer", true, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        size_t page = 4096;
+        auto mem = std::shared_ptr<void>(std::aligned_alloc(page, (size + page - 1) / page * page), std::free);
+        return [&ctx, size, mem](unsigned int) {
+          xrt::bo bo{ctx.device, mem.get(), size, host_only, 0};
+        };
+      };
+    }),
+
+  harness::benchmark("bo_map", needs::device,
+    "map a host only buffer", true, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto bo = std::make_shared<xrt::bo>(ctx.device, size, host_only, 0);
+        return [bo](unsigned int) {
+          bo->map<char*>();
+        };
+      };
+    }),
+
+  harness::benchmark("bo_sync", needs::device,
+    "sync a host only buffer, alternating direction", true, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto bo = std::make_shared<xrt::bo>(ctx.device, size, host_only, 0);
+        return [bo](unsigned int i) {
+          bo->sync((i & 1) ? XCL_BO_SYNC_BO_FROM_DEVICE : XCL_BO_SYNC_BO_TO_DEVICE);
+        };
+      };
+    }),
+
+  harness::benchmark("bo_sync_8", needs::device,
+    "sync 8 buffers to device one at a time", true, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto bos = std::make_shared<std::vector<xrt::bo>>();
+        for (size_t b = 0; b < batch; ++b)
+          bos->emplace_back(ctx.device, size, host_only, 0);
+        return [bos](unsigned int) {
+          for (auto& bo : *bos)
+            bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        };
+      };
+    }),
+
+  harness::benchmark("bo_sync_batch_8", needs::device,
+    "sync 8 buffers to device with xrt::bo::sync_batch()", true, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto ranges = std::make_shared<std::vector<xrt::bo::sync_range>>();
+        for (size_t b = 0; b < batch; ++b)
+          ranges->push_back({xrt::bo(ctx.device, size, host_only, 0), XCL_BO_SYNC_BO_TO_DEVICE, size, 0});
+        return [ranges](unsigned int) {
+          xrt::bo::sync_batch(*ranges);
+        };
+      };
+    }),
+
+  harness::benchmark("bo_fill_sync", needs::device,
+    "fill a normal buffer and sync it to device, prints MB/s", true, true,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int t) {
+        auto bo = std::make_shared<xrt::bo>(ctx.device, size, xrt::bo::flags::normal, 0);
+        auto data = bo->map<char*>();
+        return [bo, data, size, t](unsigned int i) {
+          std::memset(data, static_cast<int>(t + i), size);
+          bo->sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        };
+      };
+    }),
+
+  harness::benchmark("bo_host_copy_sync", needs::device,
+    "copy host memory into a normal buffer and sync it, prints MB/s", true, true,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int t) {
+        auto bo = std::make_shared<xrt::bo>(ctx.device, size, xrt::bo::flags::normal, 0);
+        auto src = std::make_shared<std::vector<char>>(size, static_cast<char>(t));
+        auto data = bo->map<char*>();
+        return [bo, src, data, size](unsigned int) {
+          std::memcpy(data, src->data(), size);
+          bo->sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        };
+      };
+    }),
+
+  harness::benchmark("bo_copy", needs::device,
+    "copy between two host only buffers", true, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto src = std::make_shared<xrt::bo>(ctx.device, size, host_only, 0);
+        auto dst = std::make_shared<xrt::bo>(ctx.device, size, host_only, 0);
+        return [src, dst](unsigned int) {
+          dst->copy(*src);
+        };
+      };
+    }),
+
+  harness::benchmark("bo_copy_async", needs::device,
+    "copy between two host only buffers with copy_async()", true, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto src = std::make_shared<xrt::bo>(ctx.device, size, host_only, 0);
+        auto dst = std::make_shared<xrt::bo>(ctx.device, size, host_only, 0);
+        return [src, dst](unsigned int) {
+          dst->copy_async(*src, src->size()).wait();
+        };
+      };
+    }),
+
+  harness::benchmark("run_start_wait", needs::kernel,
+    "start and wait for a run with unchanged arguments", false, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto run = std::make_shared<xrt::run>(make_run(ctx, ctx.kernel, size));
+        return [run](unsigned int) {
+          run->start();
+          run->wait();
+        };
+      };
+    }),
+
+  harness::benchmark("run_set_same_arg_start", needs::kernel,
+    "set argument 0 to its current value, then start and wait", false, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto bo = xrt::bo(ctx.device, size, ctx.kernel.group_id(0));
+        auto run = std::make_shared<xrt::run>(ctx.kernel);
+        run->set_arg(0, bo);
+        return [run, bo](unsigned int) {
+          run->set_arg(0, bo);
+          run->start();
+          run->wait();
+        };
+      };
+    }),
+
+  harness::benchmark("run_set_arg_start", needs::kernel,
+    "change argument 0, then start and wait", false, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto bo0 = xrt::bo(ctx.device, size, ctx.kernel.group_id(0));
+        auto bo1 = xrt::bo(ctx.device, size, ctx.kernel.group_id(0));
+        auto run = std::make_shared<xrt::run>(ctx.kernel);
+        return [run, bo0, bo1](unsigned int i) {
+          run->set_arg(0, (i & 1) ? bo1 : bo0);
+          run->start();
+          run->wait();
+        };
+      };
+    }),
+
+  {"run_callback_slow", needs::kernel,
+   "start and wait for runs with a completion callback of -c us, size is -c",
+   run_callback_slow},
+
+  harness::benchmark("run_set_arg", needs::kernel,
+    "change argument 0 with set_arg()", false, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto bo0 = xrt::bo(ctx.device, size, ctx.kernel.group_id(0));
+        auto bo1 = xrt::bo(ctx.device, size, ctx.kernel.group_id(0));
+        auto run = std::make_shared<xrt::run>(ctx.kernel);
+        return [run, bo0, bo1](unsigned int i) {
+          run->set_arg(0, (i & 1) ? bo1 : bo0);
+        };
+      };
+    }),
+
+  harness::benchmark("run_set_args", needs::kernel,
+    "change argument 0 with set_args()", false, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto bo0 = xrt::bo(ctx.device, size, ctx.kernel.group_id(0));
+        auto bo1 = xrt::bo(ctx.device, size, ctx.kernel.group_id(0));
+        auto run = std::make_shared<xrt::run>(ctx.kernel);
+        return [run, bo0, bo1](unsigned int i) {
+          run->set_args((i & 1) ? bo1 : bo0);
+        };
+      };
+    }),
+
+  {"run_set_arg_scalar", needs::kernel,
+   "change the first 4 or 8 byte scalar argument, size is the scalar size",
+   run_set_arg_scalar},
+
+  harness::benchmark("runlist_execute", needs::kernel,
+    "execute and wait for a runlist of -r runs", false, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto runlist = std::make_shared<xrt::runlist>(ctx.hwctx);
+        for (unsigned int r = 0; r < ctx.opt.runlist_size; ++r)
+          runlist->add(make_run(ctx, ctx.kernel, size));
+        return [runlist](unsigned int) {
+          runlist->execute();
+          runlist->wait();
+        };
+      };
+    }),
+
+  // A diamond of four runs where the dependencies are resolved by
+  // the graph
+  harness::benchmark("command_graph_execute", needs::kernel,
+    "execute and wait for a command graph of 4 runs", false, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto graph = std::make_shared<xrt::command_graph>();
+        std::vector<xrt::command_graph::node> nodes;
+        for (unsigned int r = 0; r < 4; ++r)
+          nodes.push_back(graph->add(make_run(ctx, ctx.kernel, size)));
+        graph->add_dependency(nodes[0], nodes[1]);
+        graph->add_dependency(nodes[0], nodes[2]);
+        graph->add_dependency(nodes[1], nodes[3]);
+        graph->add_dependency(nodes[2], nodes[3]);
+        return [graph](unsigned int) {
+          graph->execute();
+          graph->wait();
+        };
+      };
+    }),
+
+  harness::benchmark("kernel_construct", needs::kernel,
+    "construct the kernel in the hardware context", false, false,
+    [](const context& ctx, size_t) -> harness::setup_type {
+      return [&ctx](unsigned int) {
+        return [&ctx](unsigned int) {
+          xrt::kernel k{ctx.hwctx, ctx.opt.kernel};
+        };
+      };
+    }),
+
+  // Changing a buffer argument patches the instruction buffer and
+  // syncs it to device on next start
+  harness::benchmark("module_patch", needs::module,
+    "change argument 0 of an ELF kernel, then start and wait", true, false,
+    [](const context& ctx, size_t size) -> harness::setup_type {
+      return [&ctx, size](unsigned int) {
+        auto& kernel = ctx.module_kernel;
+        auto bo0 = xrt::bo(ctx.device, size, host_only, kernel.group_id(0));
+        auto bo1 = xrt::bo(ctx.device, size, host_only, kernel.group_id(0));
+        auto run = std::make_shared<xrt::run>(kernel);
+        return [run, bo0, bo1](unsigned int i) {
+          run->set_arg(0, (i & 1) ? bo1 : bo0);
+          run->start();
+          run->wait();
+        };
+      };
+    }),
+};
+
+int
+run(int argc, char* argv[])
+{
+  context ctx;
+  if (!harness::parse_options(argc, argv, ctx.opt)) {
+    harness::usage("xrt_host_bench");
+    return 1;
+  }
+
+  if (ctx.opt.list) {
+    harness::list_cases(benchmarks);
+    return 0;
+  }
+
+  harness::open(ctx);
+  harness::run_cases(ctx, benchmarks);
+
+  auto cache = xrt::ext::userptr_cache::get_stats();
+  if (cache.hits || cache.misses)
+    std::cerr << "userptr cache hits: " << cache.hits << " misses: " << cache.misses
+              << " evictions: " << cache.evictions << " pinned bytes: " << cache.pinned_bytes
+              << std::endl;
+
+  if (ctx.opt.output.empty()) {
+    harness::write_json(std::cout, "xrt_host_bench", ctx.opt);
+  }
+  else {
+    std::ofstream ofs(ctx.opt.output);
+    harness::write_json(ofs, "xrt_host_bench", ctx.opt);
+  }
+
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    return run(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << std::endl;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED" << std::endl;
+  }
+
+  return 1;
+}
@@ -0,0 +1,288 @@
+/**
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (C) 2026 Advanced Micro Devices, Inc. All rights reserved.
+ */
+
+// Functional tests of the host runtime paths measured by
+// xrt_host_bench.  Intended to be run with XCL_EMULATION_MODE=noop,
+// with the same options as the benchmark; cases that need a kernel
+// or module are skipped unless -k or -e is specified.  Use -L to list
+// the tests.
+
+#include "harness.h"
+
+#include "core/common/api/kernel_int.h"
+
+#include <cstring>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using harness::context;
+using harness::needs;
+
+void
+check(bool condition, const std::string& msg)
+{
+  if (!condition)
+    throw std::runtime_error(msg);
+}
+
+void
+start_wait(xrt::run& run, const std::string& what)
+{
+  run.start();
+  check(run.wait() == ERT_CMD_STATE_COMPLETED, what + " did not complete");
+}
+
+// A clone shares the instruction module of the run it was cloned
+// from.  Setting an argument to a value it already has must still
+// patch the module if the other run patched a different value in
+// between, and both runs must keep executing with their own values.
+void
+run_clone_same_arg(const context& ctx, const xrt::kernel& kernel, xrt::bo::flags flags)
+{
+  auto size = ctx.opt.sizes.front();
+  xrt::bo bo0(ctx.device, size, flags, kernel.group_id(0));
+  xrt::bo bo1(ctx.device, size, flags, kernel.group_id(0));
+
+  xrt::run run{kernel};
+  run.set_arg(0, bo0);
+  start_wait(run, "run");
+
+  auto clone = xrt_core::kernel_int::clone(run);
+  start_wait(clone, "clone with inherited argument");
+
+  for (int i = 0; i < 8; ++i) {
+    clone.set_arg(0, bo1);
+    start_wait(clone, "clone");
+    clone.set_arg(0, bo1);
+    start_wait(clone, "clone with same argument");
+
+    run.set_arg(0, bo0);
+    start_wait(run, "run after clone patched");
+    run.set_arg(0, bo0);
+    start_wait(run, "run with same argument");
+  }
+}
+
+// Slabs of an arena hold a reference to the core device.  Allocate
+// and release buffers from several threads, keep one buffer beyond
+// the lifetime of the arena, and check that all slabs are released
+// once the arena and the last buffer are gone.
+void
+bo_arena_release(const context& ctx)
+{
+  auto device = ctx.device.get_handle();
+  auto base = device.use_count();
+
+  xrt::bo survivor;
+  {
+    xrt::ext::bo_arena arena{ctx.device, xrt::bo::flags::host_only, 0};
+    auto alloc_release = [&arena] {
+      for (size_t i = 0; i < 64; ++i) {
+        std::vector<xrt::bo> bos;
+        for (size_t sz = 4096; sz <= 65536; sz *= 2)
+          bos.push_back(arena.alloc(sz));
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t)
+      workers.emplace_back(alloc_release);
+    alloc_release();
+    for (auto& w : workers)
+      w.join();
+
+    survivor = arena.alloc(4096);
+    auto stats = arena.get_stats();
+    check(stats.slabs > 0, "arena reserved no slabs");
+    check(stats.outstanding == 1, "arena buffers not released");
+    check(device.use_count() > base, "arena slabs do not reference the device");
+  }
+
+  check(device.use_count() > base, "slab of live buffer released with arena");
+  auto data = survivor.map<char*>();
+  std::memset(data, 0x5a, survivor.size());
+  survivor.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+
+  survivor = {};
+  check(device.use_count() == base, "arena slabs not released");
+}
+
+// A completion callback that blocks must not delay completion of
+// other runs, nor delivery of their callbacks.  Requires
+// Runtime.callback_threads of 2 or more, see xrt_host_test.ini.
+// Every callback must be delivered exactly once and never
+// concurrently for the same run.
+void
+run_callback_slow(const context& ctx)
+{
+  static constexpr std::chrono::seconds timeout{10};
+  constexpr unsigned int iterations = 64;
+  auto size = ctx.opt.sizes.front();
+  xrt::bo bo(ctx.device, size, xrt::bo::flags::normal, ctx.kernel.group_id(0));
+
+  // The slow run's callback blocks until released
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  auto slow_state = std::make_shared<harness::callback_state>();
+  xrt::run slow{ctx.kernel};
+  slow.set_arg(0, bo);
+  slow.add_callback(ERT_CMD_STATE_COMPLETED, [slow_state, released](const void*, ert_cmd_state, void*) {
+    if (slow_state->active++)
+      slow_state->overlapped = true;
+    (void) released.wait_for(timeout);
+    --slow_state->active;
+    ++slow_state->delivered;
+  }, nullptr);
+
+  auto fast_state = std::make_shared<harness::callback_state>();
+  xrt::run fast{ctx.kernel};
+  fast.set_arg(0, bo);
+  fast.add_callback(ERT_CMD_STATE_COMPLETED, [fast_state](const void*, ert_cmd_state, void*) {
+    if (fast_state->active++)
+      fast_state->overlapped = true;
+    --fast_state->active;
+    ++fast_state->delivered;
+  }, nullptr);
+
+  ++slow_state->started;
+  start_wait(slow, "run with slow callback");
+  auto deadline = harness::clock_type::now() + timeout;
+  while (!slow_state->active && harness::clock_type::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  check(slow_state->active == 1, "slow callback was not called");
+
+  // Runs and callbacks of the other run proceed while the slow
+  // callback is blocked
+  for (unsigned int i = 0; i < iterations; ++i) {
+    ++fast_state->started;
+    fast.start();
+    check(fast.wait(timeout) == ERT_CMD_STATE_COMPLETED, "run blocked by slow callback of another run");
+  }
+  deadline = harness::clock_type::now() + timeout;
+  while (fast_state->delivered < iterations && harness::clock_type::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  check(fast_state->delivered == iterations, "callbacks blocked by slow callback of another run");
+  check(slow_state->delivered == 0, "slow callback returned before release");
+
+  release.set_value();
+  harness::check_callbacks({slow_state, fast_state});
+
+  // No callback is delivered twice
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  check(slow_state->delivered == 1 && fast_state->delivered == iterations, "callbacks delivered more than once");
+}
+
+// A diamond of runs executed repeatedly as a command graph.  Either
+// the device enforces the dependencies with fences (noop_hw_queue)
+// or the graph is notified of completions on the host; in both cases
+// the graph must complete with all runs completed, also when waited
+// for with short timeouts.
+void
+command_graph_diamond(const context& ctx)
+{
+  static constexpr std::chrono::seconds timeout{10};
+  auto size = ctx.opt.sizes.front();
+  xrt::bo bo(ctx.device, size, xrt::bo::flags::normal, ctx.kernel.group_id(0));
+
+  std::vector<xrt::run> runs;
+  xrt::command_graph graph;
+  std::vector<xrt::command_graph::node> nodes;
+  for (int r = 0; r < 4; ++r) {
+    runs.emplace_back(ctx.kernel);
+    runs.back().set_arg(0, bo);
+    nodes.push_back(graph.add(runs.back()));
+  }
+  graph.add_dependency(nodes[0], nodes[1]);
+  graph.add_dependency(nodes[0], nodes[2]);
+  graph.add_dependency(nodes[1], nodes[3]);
+  graph.add_dependency(nodes[2], nodes[3]);
+
+  for (int i = 0; i < 64; ++i) {
+    graph.execute();
+    if (i % 2) {
+      auto deadline = harness::clock_type::now() + timeout;
+      while (graph.wait(std::chrono::milliseconds(1)) == std::cv_status::timeout)
+        check(harness::clock_type::now() < deadline, "command graph did not complete");
+    }
+    else {
+      check(graph.wait(timeout) == std::cv_status::no_timeout, "command graph did not complete");
+    }
+
+    for (const auto& run : runs)
+      check(run.state() == ERT_CMD_STATE_COMPLETED, "command graph completed with a run not completed");
+  }
+
+  // The runs can still be used outside the graph
+  start_wait(runs[3], "run of command graph");
+}
+
+const std::vector<harness::test_case> tests = {
+  {"bo_arena_release", needs::device,
+   "destroy an arena and check its slabs are released",
+   bo_arena_release},
+
+  {"run_clone_same_arg", needs::kernel,
+   "set the same argument repeatedly on a run and its clone",
+   [](const context& ctx) {
+     run_clone_same_arg(ctx, ctx.kernel, xrt::bo::flags::normal);
+   }},
+
+  {"run_callback_slow", needs::kernel,
+   "check that a blocked completion callback delays neither other runs nor their callbacks",
+   run_callback_slow},
+
+  {"command_graph_diamond", needs::kernel,
+   "execute a diamond of runs as a command graph and check that all runs complete",
+   command_graph_diamond},
+
+  {"module_clone_same_arg", needs::module,
+   "set the same argument repeatedly on a run of an ELF kernel and its clone",
+   [](const context& ctx) {
+     run_clone_same_arg(ctx, ctx.module_kernel, xrt::bo::flags::host_only);
+   }},
+};
+
+int
+run(int argc, char* argv[])
+{
+  context ctx;
+  if (!harness::parse_options(argc, argv, ctx.opt)) {
+    harness::usage("xrt_host_test");
+    return 1;
+  }
+
+  if (ctx.opt.list) {
+    harness::list_cases(tests);
+    return 0;
+  }
+
+  harness::open(ctx);
+  auto count = harness::run_cases(ctx, tests);
+  std::cout << count << " of " << tests.size() << " tests run\n";
+  std::cout << "TEST PASSED" << std::endl;
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    return run(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << std::endl;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED" << std::endl;
+  }
+
+  return 1;
+}